@@ -437,9 +437,14 @@ void CGen8OpenCLProgram::GetZEBinary(
     std::vector<std::unique_ptr<llvm::MemoryBuffer>> elfStorage;
 
     ZEBinaryBuilder zebuilder(m_Platform, pointerSizeInBytes == 8,
-        m_Context.m_programInfo, (const uint8_t*)spv, spvSize);
+        m_Context.m_programInfo, (const uint8_t*)spv, spvSize, &programBinary);
     zebuilder.setProductFamily(m_Platform.eProductFamily);
 
+    if (const IGCMetrics::IGCLightMetrics* lightMetrics = m_Context.metrics.GetLightMetrics())
+    {
+        zebuilder.addLightMetrics((const uint8_t*)lightMetrics, sizeof(*lightMetrics));
+    }
+
     std::vector<string> elfVecNames;      // Vector of parameters for the linker, contains in/out ELF file names and params
     std::vector<char*> elfVecPtrs;        // Vector of pointers to the elfVecNames vector elements
     SIMDMode simdMode = SIMDMode::SIMD8;  // Currently processed kernel's SIMD
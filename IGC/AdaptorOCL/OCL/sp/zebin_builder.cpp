@@ -22,9 +22,12 @@ using namespace llvm;
 
 ZEBinaryBuilder::ZEBinaryBuilder(
     const PLATFORM plat, bool is64BitPointer, const IGC::SOpenCLProgramInfo& programInfo,
-    const uint8_t* spvData, uint32_t spvSize)
+    const uint8_t* spvData, uint32_t spvSize, llvm::raw_pwrite_stream* streamOS)
     : mPlatform(plat), mBuilder(is64BitPointer)
 {
+    if (streamOS != nullptr)
+        mBuilder.streamTo(*streamOS);
+
     G6HWC::InitializeCapsGen8(&mHWCaps);
 
     // FIXME: Most fields leaves as 0
@@ -210,6 +213,11 @@ void ZEBinaryBuilder::addSPIRV(const uint8_t* data, uint32_t size)
     mBuilder.addSectionSpirv("", data, size);
 }
 
+void ZEBinaryBuilder::addLightMetrics(const uint8_t* data, uint32_t size)
+{
+    mBuilder.addSectionMisc("igc_metrics", data, size);
+}
+
 ZEELFObjectBuilder::SectionID ZEBinaryBuilder::addKernelBinary(const std::string& kernelName,
     const char* kernelBinary, unsigned int kernelBinarySize)
 {
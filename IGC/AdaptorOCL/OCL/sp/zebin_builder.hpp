@@ -37,8 +37,11 @@ class ZEBinaryBuilder : DisallowCopy
 public:
     // Setup ZEBin platform, and ELF header information. The program scope information
     // is also be parsed from SOpenCLProgramInfo in the constructor
+    // If streamOS is given, section contents are written into it as they are
+    // added, and getBinaryObject must be called with the same stream
     ZEBinaryBuilder(const PLATFORM plat, bool is64BitPointer,
-        const IGC::SOpenCLProgramInfo& programInfo, const uint8_t* spvData, uint32_t spvSize);
+        const IGC::SOpenCLProgramInfo& programInfo, const uint8_t* spvData, uint32_t spvSize,
+        llvm::raw_pwrite_stream* streamOS = nullptr);
 
     // Set the ProductFamily as the specified value.
     void setProductFamily(PRODUCT_FAMILY value);
@@ -94,6 +97,9 @@ private:
     /// add spir-v section
     void addSPIRV(const uint8_t* data, uint32_t size);
 
+    /// add .misc.igc_metrics section holding an IGCLightMetrics record
+    void addLightMetrics(const uint8_t* data, uint32_t size);
+
     /// add program scope symbols (e.g. symbols defined in global/const buffer)
     void addProgramSymbols(const IGC::SOpenCLProgramInfo& annotations);
 
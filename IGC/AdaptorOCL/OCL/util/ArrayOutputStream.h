@@ -0,0 +1,92 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Support/raw_ostream.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Util
+{
+
+// raw_pwrite_stream that writes into a new[]-allocated array which can be
+// handed over to the caller, so that a binary produced through an LLVM stream
+// does not need to be copied into its final buffer.
+class ArrayOutputStream : public llvm::raw_pwrite_stream
+{
+public:
+    explicit ArrayOutputStream(size_t initialCapacity = 0)
+        : llvm::raw_pwrite_stream(/*Unbuffered=*/true)
+    {
+        Reserve(initialCapacity);
+    }
+
+    ~ArrayOutputStream() override
+    {
+        delete[] m_pData;
+    }
+
+    // Returns the written bytes as an array to be released with delete[]. The
+    // stream is left empty.
+    char* Release(size_t& size)
+    {
+        flush();
+        char* pData = m_pData;
+        size = m_Size;
+        m_pData = nullptr;
+        m_Size = 0;
+        m_Capacity = 0;
+        return pData;
+    }
+
+private:
+    void write_impl(const char* ptr, size_t size) override
+    {
+        Reserve(m_Size + size);
+        memcpy(m_pData + m_Size, ptr, size);
+        m_Size += size;
+    }
+
+    void pwrite_impl(const char* ptr, size_t size, uint64_t offset) override
+    {
+        // Like raw_svector_ostream, pwrite may only overwrite written bytes.
+        memcpy(m_pData + offset, ptr, size);
+    }
+
+    uint64_t current_pos() const override
+    {
+        return m_Size;
+    }
+
+    void Reserve(size_t capacity)
+    {
+        if (capacity <= m_Capacity)
+        {
+            return;
+        }
+        size_t newCapacity = std::max(capacity, m_Capacity * 2);
+        char* pNewData = new char[newCapacity];
+        if (m_Size > 0)
+        {
+            memcpy(pNewData, m_pData, m_Size);
+        }
+        delete[] m_pData;
+        m_pData = pNewData;
+        m_Capacity = newCapacity;
+    }
+
+    char* m_pData = nullptr;
+    size_t m_Size = 0;
+    size_t m_Capacity = 0;
+};
+
+}
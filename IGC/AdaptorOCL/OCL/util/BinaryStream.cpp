@@ -97,6 +97,23 @@ const char* BinaryStream::GetLinearPointer()
     return m_LinearPointer.c_str();
 }
 
+// Copies the stream contents into dst, without the intermediate linear copy
+// made by GetLinearPointer.
+bool BinaryStream::CopyTo( char* dst, std::streamsize dstSize )
+{
+    std::streamsize size = Size();
+
+    if( dstSize < size )
+    {
+        return false;
+    }
+
+    std::streambuf* pBuf = m_membuf.rdbuf();
+    pBuf->pubseekpos( 0, std::ios_base::in );
+
+    return pBuf->sgetn( dst, size ) == size;
+}
+
 bool BinaryStream::Align( std::streamsize alignment )
 {
     bool retValue = true;
@@ -36,6 +36,8 @@ public:
 
     const char* GetLinearPointer();
 
+    bool CopyTo( char* dst, std::streamsize dstSize );
+
     std::streamsize Size() const;
     std::streamsize Size();
 
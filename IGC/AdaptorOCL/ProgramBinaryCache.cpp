@@ -0,0 +1,318 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "AdaptorOCL/ProgramBinaryCache.h"
+#include "Compiler/CISACodeGen/Platform.hpp"
+#include "common/igc_regkeys.hpp"
+#include "common/secure_mem.h"
+#include "version.h"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Support/raw_ostream.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "Probe/Assertion.h"
+
+using namespace IGC;
+namespace fs = llvm::sys::fs;
+
+namespace
+{
+    // Bump when the entry layout changes so stale entries are simply missed.
+    const char cEntryMagic[8] = { 'I', 'G', 'C', 'P', 'B', 'C', '0', '1' };
+    const char cEntryExt[] = ".bin";
+
+    struct EntryHeader
+    {
+        char magic[8];
+        uint32_t outputSize;
+        uint32_t errorStringSize;
+        uint32_t debugDataSize;
+        uint32_t reserved;
+    };
+
+    void hashBytes(llvm::MD5& hasher, const void* data, size_t size)
+    {
+        // Length-prefix every field so that adjacent fields can't alias.
+        uint64_t size64 = size;
+        hasher.update(llvm::ArrayRef<uint8_t>(reinterpret_cast<const uint8_t*>(&size64), sizeof(size64)));
+        if (data && size)
+            hasher.update(llvm::ArrayRef<uint8_t>(reinterpret_cast<const uint8_t*>(data), size));
+    }
+
+    // Structs are hashed field by field: their padding bytes (and the unused
+    // bits of bitfield words) are not guaranteed to be initialized.
+    template <typename T>
+    void hashField(llvm::MD5& hasher, const T& value)
+    {
+        static_assert(std::is_scalar<T>::value, "hash struct members individually");
+        hashBytes(hasher, &value, sizeof(T));
+    }
+
+    void hashPlatformInfo(llvm::MD5& hasher, const PLATFORM& info)
+    {
+        hashField(hasher, info.eProductFamily);
+        hashField(hasher, info.ePCHProductFamily);
+        hashField(hasher, info.eDisplayCoreFamily);
+        hashField(hasher, info.eRenderCoreFamily);
+        hashField(hasher, info.ePlatformType);
+        hashField(hasher, info.usDeviceID);
+        hashField(hasher, info.usRevId);
+        hashField(hasher, info.usDeviceID_PCH);
+        hashField(hasher, info.usRevId_PCH);
+        hashField(hasher, info.eGTType);
+    }
+
+    void hashGTSystemInfo(llvm::MD5& hasher, const GT_SYSTEM_INFO& info)
+    {
+        // The VDBox/VEBox, slice and SQIDI details are not used by the compiler.
+        hashField(hasher, info.EUCount);
+        hashField(hasher, info.ThreadCount);
+        hashField(hasher, info.SliceCount);
+        hashField(hasher, info.SubSliceCount);
+        hashField(hasher, info.DualSubSliceCount);
+        hashField(hasher, info.L3CacheSizeInKb);
+        hashField(hasher, info.LLCCacheSizeInKb);
+        hashField(hasher, info.EdramSizeInKb);
+        hashField(hasher, info.L3BankCount);
+        hashField(hasher, info.MaxFillRate);
+        hashField(hasher, info.EuCountPerPoolMax);
+        hashField(hasher, info.EuCountPerPoolMin);
+        hashField(hasher, info.TotalVsThreads);
+        hashField(hasher, info.TotalHsThreads);
+        hashField(hasher, info.TotalDsThreads);
+        hashField(hasher, info.TotalGsThreads);
+        hashField(hasher, info.TotalPsThreadsWindowerRange);
+        hashField(hasher, info.TotalVsThreads_Pocs);
+        hashField(hasher, info.CsrSizeInMb);
+        hashField(hasher, info.MaxEuPerSubSlice);
+        hashField(hasher, info.MaxSlicesSupported);
+        hashField(hasher, info.MaxSubSlicesSupported);
+        hashField(hasher, info.MaxDualSubSlicesSupported);
+        hashField(hasher, info.IsL3HashModeEnabled);
+        hashField(hasher, info.IsDynamicallyPopulated);
+        hashField(hasher, info.ReservedCCSWays);
+        hashField(hasher, info.SLMSizeInKb);
+    }
+
+    char* cloneBuffer(const char* src, uint32_t size)
+    {
+        if (size == 0)
+            return nullptr;
+        char* dst = new char[size];
+        memcpy_s(dst, size, src, size);
+        return dst;
+    }
+} // namespace
+
+bool ProgramBinaryCache::isCacheable(const TC::STB_TranslateInputArgs& inputArgs)
+{
+    return inputArgs.GTPinInput == nullptr &&
+        inputArgs.TracingOptionsCount == 0 &&
+        !inputArgs.CompileTimeStatisticsEnable;
+}
+
+std::string ProgramBinaryCache::computeKey(
+    const TC::STB_TranslateInputArgs& inputArgs,
+    TC::TB_DATA_FORMAT inputDataFormat,
+    const CPlatform& platform,
+    float profilingTimerResolution)
+{
+    llvm::MD5 hasher;
+
+    // The IGC revision identifies the compiler build. Builds without one fall
+    // back to the build time of this file.
+#ifdef IGC_REVISION
+    hashBytes(hasher, IGC_REVISION, strlen(IGC_REVISION));
+#else
+    hashBytes(hasher, __DATE__ " " __TIME__, sizeof(__DATE__ " " __TIME__));
+#endif
+
+    hashField(hasher, inputDataFormat);
+    hashBytes(hasher, inputArgs.pInput, inputArgs.InputSize);
+    hashBytes(hasher, inputArgs.pOptions, inputArgs.pOptions ? strlen(inputArgs.pOptions) : 0);
+    hashBytes(hasher, inputArgs.pInternalOptions,
+        inputArgs.pInternalOptions ? strlen(inputArgs.pInternalOptions) : 0);
+    hashBytes(hasher, inputArgs.pSpecConstantsIds, inputArgs.SpecConstantsSize * sizeof(uint32_t));
+    hashBytes(hasher, inputArgs.pSpecConstantsValues, inputArgs.SpecConstantsSize * sizeof(uint64_t));
+
+    // It is folded into the profiling builtins as a constant.
+    hashField(hasher, profilingTimerResolution);
+
+    hashPlatformInfo(hasher, platform.getPlatformInfo());
+    hashGTSystemInfo(hasher, platform.GetGTSystemInfo());
+    // SetWorkaroundTable derives the WA table from the SKU table starting
+    // from a zeroed table, so its bytes are fully defined and cover the SKU
+    // features the workarounds depend on. The remaining SKU features are
+    // the ones the compiler reads directly.
+    const WA_TABLE& waTable = platform.getWATable();
+    hashBytes(hasher, &waTable, sizeof(waTable));
+    hashField(hasher, (unsigned int)platform.getSkuTable().FtrPooledEuEnabled);
+    hashField(hasher, (unsigned int)platform.getSkuTable().FtrWddm2Svm);
+
+    std::string keyValues;
+    GetKeysSetExplicitly(&keyValues, nullptr);
+    hashBytes(hasher, keyValues.data(), keyValues.size());
+
+    llvm::MD5::MD5Result result;
+    hasher.final(result);
+    return result.digest().str().str();
+}
+
+std::string ProgramBinaryCache::getEntryPath(const std::string& key) const
+{
+    llvm::SmallString<256> path(m_dir);
+    llvm::sys::path::append(path, key + cEntryExt);
+    return path.str().str();
+}
+
+bool ProgramBinaryCache::load(const std::string& key, TC::STB_TranslateOutputArgs& outputArgs) const
+{
+    std::string path = getEntryPath(key);
+
+    auto bufferOrErr = llvm::MemoryBuffer::getFile(path, -1, false);
+    if (!bufferOrErr)
+        return false;
+
+    const llvm::MemoryBuffer& buffer = **bufferOrErr;
+    if (buffer.getBufferSize() < sizeof(EntryHeader))
+        return false;
+
+    EntryHeader header;
+    memcpy_s(&header, sizeof(header), buffer.getBufferStart(), sizeof(header));
+    uint64_t payloadSize = (uint64_t)header.outputSize + header.errorStringSize + header.debugDataSize;
+    if (memcmp(header.magic, cEntryMagic, sizeof(cEntryMagic)) != 0 ||
+        header.outputSize == 0 ||
+        buffer.getBufferSize() != sizeof(EntryHeader) + payloadSize)
+    {
+        return false;
+    }
+
+    const char* data = buffer.getBufferStart() + sizeof(EntryHeader);
+    outputArgs.pOutput = cloneBuffer(data, header.outputSize);
+    outputArgs.OutputSize = header.outputSize;
+    data += header.outputSize;
+    outputArgs.pErrorString = cloneBuffer(data, header.errorStringSize);
+    outputArgs.ErrorStringSize = header.errorStringSize;
+    data += header.errorStringSize;
+    outputArgs.pDebugData = cloneBuffer(data, header.debugDataSize);
+    outputArgs.DebugDataSize = header.debugDataSize;
+
+    // Refresh the timestamp so that eviction treats this entry as recently
+    // used. Failure only affects eviction order.
+    int fd = -1;
+    if (!fs::openFileForReadWrite(path, fd, fs::CD_OpenExisting, fs::OF_None))
+    {
+        fs::setLastAccessAndModificationTime(fd, std::chrono::system_clock::now());
+        llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+    }
+
+    return true;
+}
+
+void ProgramBinaryCache::store(const std::string& key, const TC::STB_TranslateOutputArgs& outputArgs) const
+{
+    if (outputArgs.pOutput == nullptr || outputArgs.OutputSize == 0)
+        return;
+
+    if (fs::create_directories(m_dir))
+        return;
+
+    // Write to a unique file first and rename it into place. The rename is
+    // atomic, so readers in other processes see either no entry or a
+    // complete one; racing writers of the same key produce identical data.
+    llvm::SmallString<256> tmpModel(m_dir);
+    llvm::sys::path::append(tmpModel, key + "-%%%%%%%%.tmp");
+    llvm::SmallString<256> tmpPath;
+    int fd = -1;
+    if (fs::createUniqueFile(tmpModel, fd, tmpPath))
+        return;
+
+    EntryHeader header = {};
+    memcpy_s(header.magic, sizeof(header.magic), cEntryMagic, sizeof(cEntryMagic));
+    header.outputSize = outputArgs.OutputSize;
+    header.errorStringSize = outputArgs.pErrorString ? outputArgs.ErrorStringSize : 0;
+    header.debugDataSize = outputArgs.pDebugData ? outputArgs.DebugDataSize : 0;
+
+    bool written = false;
+    {
+        llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+        os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        os.write(outputArgs.pOutput, header.outputSize);
+        os.write(outputArgs.pErrorString, header.errorStringSize);
+        os.write(outputArgs.pDebugData, header.debugDataSize);
+        os.close();
+        written = !os.has_error();
+        os.clear_error();
+    }
+
+    if (!written || fs::rename(tmpPath, getEntryPath(key)))
+    {
+        fs::remove(tmpPath);
+        return;
+    }
+
+    evict();
+}
+
+void ProgramBinaryCache::evict() const
+{
+    if (m_maxSize == 0)
+        return;
+
+    struct CachedFile
+    {
+        std::string path;
+        uint64_t size;
+        llvm::sys::TimePoint<> lastUsed;
+    };
+    std::vector<CachedFile> entries;
+    uint64_t totalSize = 0;
+
+    std::error_code EC;
+    for (fs::directory_iterator it(m_dir, EC), end; it != end && !EC; it.increment(EC))
+    {
+        if (llvm::sys::path::extension(it->path()) != cEntryExt)
+            continue;
+
+        fs::file_status status;
+        if (fs::status(it->path(), status) || status.type() != fs::file_type::regular_file)
+            continue;
+
+        entries.push_back({ it->path(), status.getSize(), status.getLastModificationTime() });
+        totalSize += status.getSize();
+    }
+
+    if (totalSize <= m_maxSize)
+        return;
+
+    std::sort(entries.begin(), entries.end(),
+        [](const CachedFile& a, const CachedFile& b) { return a.lastUsed < b.lastUsed; });
+
+    // Another process may be evicting at the same time; a failed remove just
+    // means the entry is already gone.
+    for (const CachedFile& entry : entries)
+    {
+        if (totalSize <= m_maxSize)
+            break;
+        fs::remove(entry.path);
+        totalSize -= entry.size;
+    }
+}
@@ -0,0 +1,62 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include "AdaptorOCL/TranslationBlock.h"
+
+#include <cstdint>
+#include <string>
+
+namespace IGC
+{
+    class CPlatform;
+
+    // On-disk, content-addressed cache of OpenCL program binaries.
+    //
+    // An entry is keyed by everything that can change the output of
+    // TC::TranslateBuild: the input module and its format, build and internal
+    // options, specialization constants, the profiling timer resolution, the
+    // platform/WA/SKU tables, the IGC revision and any regkeys that were set
+    // explicitly. It stores the program binary together with the build log
+    // and debug data so that a warm build returns exactly what the cold build
+    // did.
+    //
+    // Entries are written to a unique temporary file and renamed into place,
+    // so concurrent processes sharing the directory never observe a partial
+    // entry. Hits refresh the entry's timestamp and the oldest entries are
+    // evicted once the directory grows beyond the size limit.
+    class ProgramBinaryCache
+    {
+    public:
+        ProgramBinaryCache(const std::string& dir, uint64_t maxSizeInBytes)
+            : m_dir(dir), m_maxSize(maxSizeInBytes) {}
+
+        // Inputs that are not fully described by the translate arguments
+        // (GTPin and tracing requests) are never cached.
+        static bool isCacheable(const TC::STB_TranslateInputArgs& inputArgs);
+
+        static std::string computeKey(
+            const TC::STB_TranslateInputArgs& inputArgs,
+            TC::TB_DATA_FORMAT inputDataFormat,
+            const CPlatform& platform,
+            float profilingTimerResolution);
+
+        // Fills outputArgs with buffers allocated by new[] on a hit, which
+        // matches what CIGCTranslationBlock::FreeAllocations expects.
+        bool load(const std::string& key, TC::STB_TranslateOutputArgs& outputArgs) const;
+        void store(const std::string& key, const TC::STB_TranslateOutputArgs& outputArgs) const;
+
+    private:
+        std::string getEntryPath(const std::string& key) const;
+        void evict() const;
+
+        std::string m_dir;
+        uint64_t m_maxSize;
+    };
+} // namespace IGC
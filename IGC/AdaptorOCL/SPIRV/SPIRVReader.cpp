@@ -1421,6 +1421,9 @@ public:
           Context = NULL;
   }
 
+  void setTranslateAllFunctions(bool Val) { TranslateAllFunctions = Val; }
+  bool isTranslationRoot(SPIRVFunction *BF) const;
+
   Type *transType(SPIRVType *BT);
   GlobalValue::LinkageTypes transLinkageType(const SPIRVValue* V);
   /// Decode SPIR-V encoding of vector type hint execution mode.
@@ -1516,6 +1519,7 @@ private:
   GlobalVariable *m_NamedBarrierVar;
   GlobalVariable *m_named_barrier_id;
   DICompileUnit* compileUnit = nullptr;
+  bool TranslateAllFunctions = true;
 
   // These storages are used to prevent duplication of alias.scope/noalias
   // metadata
@@ -3907,6 +3911,16 @@ SPIRVToLLVM::foreachFuncCtlMask(SourceTy Source, FuncTy Func) {
   return true;
 }
 
+bool
+SPIRVToLLVM::isTranslationRoot(SPIRVFunction *BF) const {
+  if (isOpenCLKernel(BF) || BF->hasDecorate(DecorationReferencedIndirectlyINTEL))
+    return true;
+  // Definitions other modules may link against have to be kept.
+  SPIRVLinkageTypeKind LT = BF->getLinkageType();
+  return BF->getNumBasicBlock() > 0 &&
+    (LT == LinkageTypeExport || LT == LinkageTypeLinkOnceODR);
+}
+
 Function *
 SPIRVToLLVM::transFunction(SPIRVFunction *BF) {
   auto Loc = FuncMap.find(BF);
@@ -3952,6 +3966,12 @@ SPIRVToLLVM::transFunction(SPIRVFunction *BF) {
         SPIRSPIRVFuncParamAttrMap::rmap(Kind));
   });
 
+  // With lazy translation a callee is translated from inside its caller's
+  // OpFunctionCall; keep the caller's pending loop metadata aside so the
+  // callee's transLLVMLoopMetadata does not consume it.
+  SPIRVToLLVMLoopMetadataMap CallerLoopMetadataMap;
+  CallerLoopMetadataMap.swap(FuncLoopMetadataMap);
+
   // Creating all basic blocks before creating instructions.
   for (size_t I = 0, E = BF->getNumBasicBlock(); I != E; ++I) {
     transValue(BF->getBasicBlock(I), F, nullptr, true, BoolAction::Noop);
@@ -3967,6 +3987,7 @@ SPIRVToLLVM::transFunction(SPIRVFunction *BF) {
   }
 
   transLLVMLoopMetadata(F);
+  FuncLoopMetadataMap.swap(CallerLoopMetadataMap);
 
   return F;
 }
@@ -4272,8 +4293,15 @@ SPIRVToLLVM::translate() {
       transValue(BV, nullptr, nullptr, true, BoolAction::Noop);
   }
 
+  // Without entry points there is nothing to compute reachability from.
+  bool TranslateAll = TranslateAllFunctions ||
+    BM->getNumEntryPoints(ExecutionModelKernel) == 0;
   for (unsigned I = 0, E = BM->getNumFunctions(); I != E; ++I) {
-    transFunction(BM->getFunction(I));
+    SPIRVFunction *BF = BM->getFunction(I);
+    // Other functions are translated on demand by the calls and function
+    // pointers that reference them.
+    if (TranslateAll || isTranslationRoot(BF))
+      transFunction(BF);
   }
   for(auto& funcs : FuncMap)
   {
@@ -4458,6 +4486,8 @@ SPIRVToLLVM::transKernelMetadata()
     {
         SPIRVFunction *BF = BM->getFunction(I);
         Function *F = static_cast<Function *>(getTranslatedValue(BF));
+        if (!F && !TranslateAllFunctions)
+            continue; // not reachable from any kernel
         IGC_ASSERT_MESSAGE(F, "Invalid translated function");
 
         // __attribute__((annotate("some_user_annotation"))) are passed via
@@ -4864,7 +4894,8 @@ __attr_unused static void dumpSPIRVBC(const char* fname, const char* data, unsig
 
 bool ReadSPIRV(LLVMContext &C, std::istream &IS, Module *&M,
     std::string &ErrMsg,
-    std::unordered_map<uint32_t, uint64_t> *specConstants) {
+    std::unordered_map<uint32_t, uint64_t> *specConstants,
+    bool TranslateAllFunctions) {
   std::unique_ptr<SPIRVModule> BM( SPIRVModule::createSPIRVModule() );
   BM->setSpecConstantMap(specConstants);
   IS >> *BM;
@@ -4873,6 +4904,7 @@ bool ReadSPIRV(LLVMContext &C, std::istream &IS, Module *&M,
     BM->resolveUnknownStructFields();
     M = new Module("", C);
     SPIRVToLLVM BTL(M, BM.get());
+    BTL.setTranslateAllFunctions(TranslateAllFunctions);
 
     if (!BTL.translate()) {
       BM->getError(ErrMsg);
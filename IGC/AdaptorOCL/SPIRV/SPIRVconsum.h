@@ -20,14 +20,47 @@ See LICENSE.TXT for details.
 
 #include "llvm/IR/Module.h"
 
+#include <streambuf>
 #include <unordered_map>
 
 namespace igc_spv{
+// Read-only stream buffer over a SPIR-V binary owned by the caller. It lets
+// the decoder read the module in place instead of from a copy held by an
+// std::istringstream.
+class SPIRVInputBuffer : public std::streambuf {
+public:
+  SPIRVInputBuffer(const char *Data, size_t Size) {
+    char *Begin = const_cast<char *>(Data);
+    setg(Begin, Begin, Begin + Size);
+  }
+
+protected:
+  pos_type seekoff(off_type Off, std::ios_base::seekdir Dir,
+                   std::ios_base::openmode Which) override {
+    char *Base = Dir == std::ios_base::beg ? eback()
+               : Dir == std::ios_base::cur ? gptr()
+               : egptr();
+    return seekpos(pos_type(Base - eback() + Off), Which);
+  }
+
+  pos_type seekpos(pos_type Pos, std::ios_base::openmode Which) override {
+    if (!(Which & std::ios_base::in) || Pos < 0 || Pos > egptr() - eback())
+      return pos_type(off_type(-1));
+    setg(eback(), eback() + Pos, egptr());
+    return Pos;
+  }
+};
+
 // Loads SPIRV from istream and translate to LLVM module.
 // Returns true if succeeds.
+// Unless TranslateAllFunctions is set, only kernels, functions visible to
+// other modules and indirectly referenced functions are translated up front.
+// Everything else is translated when a call or a function pointer reaches
+// it, so functions no kernel can reach never make it into the LLVM module.
 bool ReadSPIRV(llvm::LLVMContext &C, std::istream &IS, llvm::Module *&M,
     std::string &ErrMsg,
-    std::unordered_map<uint32_t, uint64_t> *specConstants);
+    std::unordered_map<uint32_t, uint64_t> *specConstants,
+    bool TranslateAllFunctions = true);
 
 }
 #endif
@@ -14,6 +14,8 @@ SPDX-License-Identifier: MIT
 #include "common/LLVMWarningsPop.hpp"
 
 #include <cstring>
+#include <map>
+#include <memory>
 #include <string>
 #include <stdexcept>
 #include <fstream>
@@ -26,6 +28,8 @@ SPDX-License-Identifier: MIT
 
 #include "AdaptorOCL/UnifyIROCL.hpp"
 #include "AdaptorOCL/DriverInfoOCL.hpp"
+#include "AdaptorOCL/ProgramBinaryCache.h"
+#include "AdaptorOCL/OCL/util/ArrayOutputStream.h"
 
 #include "Compiler/MetaDataApi/IGCMetaDataHelper.h"
 #include "common/debug/Dump.hpp"
@@ -167,6 +171,9 @@ bool TranslateBuild(
     const IGC::CPlatform& IGCPlatform,
     float profilingTimerResolution);
 
+using BuiltinResourceHandles = std::vector<std::shared_ptr<llvm::MemoryBuffer>>;
+BuiltinResourceHandles AcquireBuiltinResources();
+
 bool CIGCTranslationBlock::ProcessElfInput(
   STB_TranslateInputArgs &InputArgs,
   STB_TranslateOutputArgs &OutputArgs,
@@ -260,9 +267,14 @@ bool CIGCTranslationBlock::Translate(
         // Handle TB_DATA_FORMAT_ELF input as a result of a call to
         // clLinkLibrary(). There are two possible scenarios, link input
         // to form a new library (BC module) or link input to form an
-        // executable.
+        // executable. An executable is built from the linked module directly,
+        // without serializing it to bitcode first.
+        if (m_DataFormatOutput != TB_DATA_FORMAT_LLVM_BINARY)
+        {
+            return TC::TranslateBuild(&InputArgsCopy, pOutputArgs, m_DataFormatInput, IGCPlatform, m_ProfilingTimerResolution);
+        }
 
-        // First, link input modules together
+        // Otherwise link input modules together into a new library
         USC::SShaderStageBTLayout zeroLayout = USC::g_cZeroShaderStageBTLayout;
         IGC::COCLBTILayout oclLayout(&zeroLayout);
         CDriverInfoOCLNEO driverInfo;
@@ -403,7 +415,9 @@ bool TranslateSPIRVToLLVM(
     std::string& stringErrMsg)
 {
     bool success = true;
-    std::istringstream IS(SPIRVBinary.str());
+    // Decode the module in place rather than from a copy.
+    igc_spv::SPIRVInputBuffer SPIRVBuffer(SPIRVBinary.data(), SPIRVBinary.size());
+    std::istream IS(&SPIRVBuffer);
     std::unordered_map<uint32_t, uint64_t> specIDToSpecValueMap = UnpackSpecConstants(
         InputArgs.pSpecConstantsIds,
         InputArgs.pSpecConstantsValues,
@@ -428,7 +442,12 @@ bool TranslateSPIRVToLLVM(
     // Actual translation from SPIR-V to LLLVM
     success = llvm::readSpirv(Context, Opts, IS, LLVMModule, stringErrMsg);
 #else // IGC Legacy SPIRV Translator
-    success = igc_spv::ReadSPIRV(Context, IS, LLVMModule, stringErrMsg, &specIDToSpecValueMap);
+    // Libraries keep every function; their callers live in other modules.
+    bool translateAllFunctions = IGC_IS_FLAG_DISABLED(EnableLazySPIRVTranslation) ||
+        (InputArgs.pOptions &&
+         strstr(InputArgs.pOptions, "-library-compilation"));
+    success = igc_spv::ReadSPIRV(Context, IS, LLVMModule, stringErrMsg,
+        &specIDToSpecValueMap, translateAllFunctions);
 #endif
 
     // Handle OpenCL Compiler Options
@@ -443,6 +462,120 @@ bool TranslateSPIRVToLLVM(
 }
 #endif // defined(IGC_SPIRV_ENABLED)
 
+// Parses every LLVM and SPIR-V module of an ELF container produced by
+// clCompileProgram/clLinkProgram and links them into a single module owned by
+// Context. Specialization constant sections apply to the SPIR-V module that
+// follows them.
+static bool LinkElfSections(
+  CLElfLib::CElfReader* pElfReader,
+  STB_TranslateInputArgs InputArgs,
+  llvm::LLVMContext &Context,
+  std::unique_ptr<llvm::Module> &OutputModule,
+  bool &hasSPIRV)
+{
+  bool success = true;
+  const CLElfLib::SElf64Header* pHeader = pElfReader->GetElfHeader();
+
+  // Iterate over all the input modules.
+  for (unsigned i = 1; i < pHeader->NumSectionHeaderEntries; i++)
+  {
+    const CLElfLib::SElf64SectionHeader* pSectionHeader = pElfReader->GetSectionHeader(i);
+    IGC_ASSERT(pSectionHeader != NULL);
+
+    char* pData = NULL;
+    size_t dataSize = 0;
+
+    if (pSectionHeader->Type == CLElfLib::SH_TYPE_SPIRV_SC_IDS)
+    {
+        pElfReader->GetSectionData(i, pData, dataSize);
+        InputArgs.pSpecConstantsIds = reinterpret_cast<const uint32_t*>(pData);
+        InputArgs.SpecConstantsSize = static_cast<uint32_t>(dataSize / sizeof(uint32_t));
+    }
+
+    if (pSectionHeader->Type == CLElfLib::SH_TYPE_SPIRV_SC_VALUES)
+    {
+        pElfReader->GetSectionData(i, pData, dataSize);
+        InputArgs.pSpecConstantsValues = reinterpret_cast<const uint64_t*>(pData);
+    }
+
+    if ((pSectionHeader->Type == CLElfLib::SH_TYPE_OPENCL_LLVM_BINARY)  ||
+        (pSectionHeader->Type == CLElfLib::SH_TYPE_OPENCL_LLVM_ARCHIVE) ||
+        (pSectionHeader->Type == CLElfLib::SH_TYPE_SPIRV))
+    {
+      pElfReader->GetSectionData(i, pData, dataSize);
+
+      // Create input module from the buffer
+      llvm::StringRef buf(pData, dataSize);
+
+      std::unique_ptr<llvm::Module> InputModule = nullptr;
+
+      if (pSectionHeader->Type == CLElfLib::SH_TYPE_SPIRV)
+      {
+          llvm::Module* pKernelModule = nullptr;
+#if defined(IGC_SPIRV_ENABLED)
+          hasSPIRV = true;
+          std::string stringErrMsg;
+          bool success = TranslateSPIRVToLLVM(InputArgs, Context, buf, pKernelModule, stringErrMsg);
+#else
+          std::string stringErrMsg{ "SPIRV consumption not enabled for the TARGET." };
+          bool success = false;
+#endif
+          // unset specialization constants, to avoid using them by subsequent SPIR-V modules
+          InputArgs.pSpecConstantsIds = nullptr;
+          InputArgs.pSpecConstantsValues = nullptr;
+          InputArgs.SpecConstantsSize = 0;
+
+          if (success)
+          {
+              InputModule.reset(pKernelModule);
+          }
+      }
+      else
+      {
+          std::unique_ptr<llvm::MemoryBuffer> pInputBuffer =
+              llvm::MemoryBuffer::getMemBuffer(buf, "", false);
+
+          llvm::Expected<std::unique_ptr<llvm::Module>> errorOrModule =
+                llvm::parseBitcodeFile(pInputBuffer->getMemBufferRef(), Context);
+          if (llvm::Error EC = errorOrModule.takeError())
+          {
+              std::string errMsg;
+              llvm::handleAllErrors(std::move(EC), [&](llvm::ErrorInfoBase &EIB) {
+                  llvm::SMDiagnostic(pInputBuffer->getBufferIdentifier(), llvm::SourceMgr::DK_Error,
+                      EIB.message());
+              });
+              IGC_ASSERT_MESSAGE(errMsg.empty(), "parsing bitcode failed");
+          }
+
+          InputModule = std::move(errorOrModule.get());
+      }
+
+      if (InputModule.get() == NULL)
+      {
+          success = false;
+          break;
+      }
+
+      // Link modules
+      if (OutputModule.get() == NULL)
+      {
+          InputModule.swap(OutputModule);
+      }
+      else
+      {
+          success = !llvm::Linker::linkModules(*OutputModule, std::move(InputModule));
+      }
+
+      if (!success)
+      {
+          break;
+      }
+    }
+  }
+
+  return success;
+}
+
 bool ProcessElfInput(
   STB_TranslateInputArgs &InputArgs,
   STB_TranslateOutputArgs &OutputArgs,
@@ -505,101 +638,11 @@ bool ProcessElfInput(
       }
 #endif // defined(IGC_SPIRV_ENABLED)
 
-      // Iterate over all the input modules.
-      for (unsigned i = 1; i < pHeader->NumSectionHeaderEntries; i++)
+      bool hasSPIRV = false;
+      success = LinkElfSections(pElfReader, InputArgs, *Context.getLLVMContext(), OutputModule, hasSPIRV);
+      if (hasSPIRV)
       {
-        const CLElfLib::SElf64SectionHeader* pSectionHeader = pElfReader->GetSectionHeader(i);
-        IGC_ASSERT(pSectionHeader != NULL);
-
-        char* pData = NULL;
-        size_t dataSize = 0;
-
-        if (pSectionHeader->Type == CLElfLib::SH_TYPE_SPIRV_SC_IDS)
-        {
-            pElfReader->GetSectionData(i, pData, dataSize);
-            InputArgs.pSpecConstantsIds = reinterpret_cast<const uint32_t*>(pData);
-            InputArgs.SpecConstantsSize = static_cast<uint32_t>(dataSize / sizeof(uint32_t));
-        }
-
-        if (pSectionHeader->Type == CLElfLib::SH_TYPE_SPIRV_SC_VALUES)
-        {
-            pElfReader->GetSectionData(i, pData, dataSize);
-            InputArgs.pSpecConstantsValues = reinterpret_cast<const uint64_t*>(pData);
-        }
-
-        if ((pSectionHeader->Type == CLElfLib::SH_TYPE_OPENCL_LLVM_BINARY)  ||
-            (pSectionHeader->Type == CLElfLib::SH_TYPE_OPENCL_LLVM_ARCHIVE) ||
-            (pSectionHeader->Type == CLElfLib::SH_TYPE_SPIRV))
-        {
-          pElfReader->GetSectionData(i, pData, dataSize);
-
-          // Create input module from the buffer
-          llvm::StringRef buf(pData, dataSize);
-
-          std::unique_ptr<llvm::Module> InputModule = nullptr;
-
-          if (pSectionHeader->Type == CLElfLib::SH_TYPE_SPIRV)
-          {
-              llvm::Module* pKernelModule = nullptr;
-#if defined(IGC_SPIRV_ENABLED)
-              Context.setAsSPIRV();
-              std::string stringErrMsg;
-              bool success = TranslateSPIRVToLLVM(InputArgs, *Context.getLLVMContext(), buf, pKernelModule, stringErrMsg);
-#else
-              std::string stringErrMsg{ "SPIRV consumption not enabled for the TARGET." };
-              bool success = false;
-#endif
-              // unset specialization constants, to avoid using them by subsequent SPIR-V modules
-              InputArgs.pSpecConstantsIds = nullptr;
-              InputArgs.pSpecConstantsValues = nullptr;
-              InputArgs.SpecConstantsSize = 0;
-
-              if (success)
-              {
-                  InputModule.reset(pKernelModule);
-              }
-          }
-          else
-          {
-              std::unique_ptr<llvm::MemoryBuffer> pInputBuffer =
-                  llvm::MemoryBuffer::getMemBuffer(buf, "", false);
-
-              llvm::Expected<std::unique_ptr<llvm::Module>> errorOrModule =
-                    llvm::parseBitcodeFile(pInputBuffer->getMemBufferRef(), *Context.getLLVMContext());
-              if (llvm::Error EC = errorOrModule.takeError())
-              {
-                  std::string errMsg;
-                  llvm::handleAllErrors(std::move(EC), [&](llvm::ErrorInfoBase &EIB) {
-                      llvm::SMDiagnostic(pInputBuffer->getBufferIdentifier(), llvm::SourceMgr::DK_Error,
-                          EIB.message());
-                  });
-                  IGC_ASSERT_MESSAGE(errMsg.empty(), "parsing bitcode failed");
-              }
-
-              InputModule = std::move(errorOrModule.get());
-          }
-
-          if (InputModule.get() == NULL)
-          {
-              success = false;
-              break;
-          }
-
-          // Link modules
-          if (OutputModule.get() == NULL)
-          {
-              InputModule.swap(OutputModule);
-          }
-          else
-          {
-              success = !llvm::Linker::linkModules(*OutputModule, std::move(InputModule));
-          }
-
-          if (!success)
-          {
-              break;
-          }
-        }
+        Context.setAsSPIRV();
       }
 
       if (success == true)
@@ -613,7 +656,7 @@ bool ProcessElfInput(
 
         // Create a copy of the string to return to the caller. The output type
         // determines how the buffer gets managed
-        char *pBufResult = static_cast<char*>(operator new(OutputString.size(), std::nothrow));
+        char *pBufResult = new(std::nothrow) char[OutputString.size()];
         if (pBufResult != NULL)
         {
           memcpy_s(pBufResult, OutputString.size(), OutputString.c_str(), OutputString.size());
@@ -737,7 +780,8 @@ bool ParseInput(
 
     // IGC does not handle legacy ocl binary for now (legacy ocl binary
     // is the binary that contains text LLVM IR (2.7 or 3.0).
-    if (strInput.size() > 1 && !(strInput[0] == 'B' && strInput[1] == 'C'))
+    if (inputDataFormatTemp != TB_DATA_FORMAT_ELF &&
+        strInput.size() > 1 && !(strInput[0] == 'B' && strInput[1] == 'C'))
     {
         bool isLLVM27IR = false, isLLVM30IR = false;
 
@@ -776,6 +820,25 @@ bool ParseInput(
             pKernelModule = MOE->release();
         }
     }
+    else if (inputDataFormatTemp == TB_DATA_FORMAT_ELF) {
+        // Link the modules of a clLinkProgram input straight into this
+        // context instead of going through an intermediate bitcode buffer.
+        CLElfLib::CElfReader *pElfReader = CLElfLib::CElfReader::Create(pInputArgs->pInput, pInputArgs->InputSize);
+        CLElfLib::RAIIElf X(pElfReader);
+
+        std::unique_ptr<llvm::Module> linkedModule;
+        bool hasSPIRV = false;
+        if (pElfReader != nullptr && pElfReader->GetElfHeader() != nullptr &&
+            LinkElfSections(pElfReader, *pInputArgs, oclContext, linkedModule, hasSPIRV))
+        {
+            pKernelModule = linkedModule.release();
+        }
+        else
+        {
+            SetErrorMessage("Linking llvm modules failed!", *pOutputArgs);
+            return false;
+        }
+    }
     else if (inputDataFormatTemp == TB_DATA_FORMAT_SPIR_V) {
 #if defined(IGC_SPIRV_ENABLED)
         //convert SPIR-V binary to LLVM module
@@ -902,10 +965,28 @@ void dumpOCLProgramBinary(OpenCLProgramContext &Ctx, const char *binaryOutput, s
 #endif
 }
 
-static std::unique_ptr<llvm::MemoryBuffer> GetGenericModuleBuffer() {
-    char Resource[5] = {'-'};
-    _snprintf(Resource, sizeof(Resource), "#%d", OCL_BC);
-    return std::unique_ptr<llvm::MemoryBuffer>{llvm::LoadBufferFromResource(Resource, "BC")};
+// Loading a builtin module resource copies it out of the library image. The
+// copy is shared by every build (or translation batch) that holds it at the
+// same time and released once the last one is done.
+static std::shared_ptr<llvm::MemoryBuffer> GetBuiltinResource(int resourceId) {
+    static std::mutex resourceMutex;
+    static std::map<int, std::weak_ptr<llvm::MemoryBuffer>> resources;
+
+    const std::lock_guard<std::mutex> lock(resourceMutex);
+    std::weak_ptr<llvm::MemoryBuffer>& entry = resources[resourceId];
+    std::shared_ptr<llvm::MemoryBuffer> buffer = entry.lock();
+    if (!buffer)
+    {
+        char Resource[5] = {'-'};
+        _snprintf(Resource, sizeof(Resource), "#%d", resourceId);
+        buffer.reset(llvm::LoadBufferFromResource(Resource, "BC"));
+        entry = buffer;
+    }
+    return buffer;
+}
+
+BuiltinResourceHandles AcquireBuiltinResources() {
+    return { GetBuiltinResource(OCL_BC), GetBuiltinResource(OCL_BC_32), GetBuiltinResource(OCL_BC_64) };
 }
 
 static void WriteSpecConstantsDump(const STB_TranslateInputArgs *pInputArgs,
@@ -919,7 +1000,7 @@ static void WriteSpecConstantsDump(const STB_TranslateInputArgs *pInputArgs,
                    hash, "_specconst.txt");
 }
 
-bool TranslateBuild(
+static bool TranslateBuildUncached(
     const STB_TranslateInputArgs* pInputArgs,
     STB_TranslateOutputArgs* pOutputArgs,
     TB_DATA_FORMAT inputDataFormatTemp,
@@ -1131,8 +1212,8 @@ bool TranslateBuild(
     {
         std::unique_ptr<llvm::Module> BuiltinGenericModule = nullptr;
         std::unique_ptr<llvm::Module> BuiltinSizeModule = nullptr;
-        std::unique_ptr<llvm::MemoryBuffer> pGenericBuffer = nullptr;
-        std::unique_ptr<llvm::MemoryBuffer> pSizeTBuffer = nullptr;
+        std::shared_ptr<llvm::MemoryBuffer> pGenericBuffer = nullptr;
+        std::shared_ptr<llvm::MemoryBuffer> pSizeTBuffer = nullptr;
         {
             // IGC has two BIF Modules:
             //            1. kernel Module (pKernelModule)
@@ -1159,7 +1240,7 @@ bool TranslateBuild(
             {
                 COMPILER_TIME_START(&oclContext, TIME_OCL_LazyBiFLoading);
 
-                pGenericBuffer = GetGenericModuleBuffer();
+                pGenericBuffer = GetBuiltinResource(OCL_BC);
 
                 if (pGenericBuffer == NULL)
                 {
@@ -1192,21 +1273,18 @@ bool TranslateBuild(
 
             // Load the builtin module -  pointer depended
             {
-                char ResNumber[5] = { '-' };
                 switch (PtrSzInBits)
                 {
                 case 32:
-                    _snprintf(ResNumber, sizeof(ResNumber), "#%d", OCL_BC_32);
+                    pSizeTBuffer = GetBuiltinResource(OCL_BC_32);
                     break;
                 case 64:
-                    _snprintf(ResNumber, sizeof(ResNumber), "#%d", OCL_BC_64);
+                    pSizeTBuffer = GetBuiltinResource(OCL_BC_64);
                     break;
                 default:
                     IGC_ASSERT_MESSAGE(0, "Unknown bitness of compiled module");
                 }
 
-                // the MemoryBuffer becomes owned by the module and does not need to be managed
-                pSizeTBuffer.reset(llvm::LoadBufferFromResource(ResNumber, "BC"));
                 IGC_ASSERT_MESSAGE(pSizeTBuffer, "Error loading builtin resource");
 
                 llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
@@ -1270,6 +1348,7 @@ bool TranslateBuild(
 
         if (retry)
         {
+            oclContext.metrics.StatRetry();
             oclContext.clear();
 
             // Create a new LLVMContext
@@ -1303,6 +1382,9 @@ bool TranslateBuild(
         SetOutputMessage(oclContext.GetWarning(), *pOutputArgs);
     }
 
+    // The lightweight metrics are part of the binary.
+    oclContext.metrics.FinalizeLightMetrics();
+
     // Prepare and set program binary
     unsigned int pointerSizeInBytes = (PtrSzInBits == 64) ? 8 : 4;
 
@@ -1319,11 +1401,12 @@ bool TranslateBuild(
         oclContext.m_programOutput.GetProgramBinary(programBinary, pointerSizeInBytes);
         binarySize = static_cast<int>(programBinary.Size());
         binaryOutput = new char[binarySize];
-        memcpy_s(binaryOutput, binarySize, programBinary.GetLinearPointer(), binarySize);
+        programBinary.CopyTo(binaryOutput, binarySize);
     } else {
         // ze binary foramt
-        llvm::SmallVector<char, 64> buf;
-        llvm::raw_svector_ostream llvm_os(buf);
+        // The binary is written straight into the buffer returned to the
+        // runtime.
+        Util::ArrayOutputStream llvm_os;
         const char* spv_data = nullptr;
         uint32_t spv_size = 0;
         if (inputDataFormatTemp == TB_DATA_FORMAT_SPIR_V) {
@@ -1333,10 +1416,9 @@ bool TranslateBuild(
         oclContext.m_programOutput.GetZEBinary(llvm_os, pointerSizeInBytes,
             spv_data, spv_size);
 
-        // FIXME: try to avoid memory copy here
-        binarySize = buf.size();
-        binaryOutput = new char[binarySize];
-        memcpy_s(binaryOutput, binarySize, buf.data(), buf.size());
+        size_t zeBinarySize = 0;
+        binaryOutput = llvm_os.Release(zeBinarySize);
+        binarySize = static_cast<int>(zeBinarySize);
     }
 
     if (IGC_IS_FLAG_ENABLED(ShaderDumpEnable))
@@ -1372,6 +1454,114 @@ bool TranslateBuild(
     return true;
 }
 
+// ELF input is normally linked straight into the build's LLVM context. Flows
+// that consume the raw input buffer (VC, VLD) or that dump the linked bitcode
+// still need it materialized.
+static bool CanLinkElfInMemory(const STB_TranslateInputArgs* pInputArgs)
+{
+    if (IGC_IS_FLAG_ENABLED(ShaderDumpEnable))
+    {
+        return false;
+    }
+    const char* pOptions = pInputArgs->pOptions;
+    return pOptions == nullptr ||
+        (strstr(pOptions, "-vc-codegen") == nullptr &&
+         strstr(pOptions, "-cmc") == nullptr &&
+         strstr(pOptions, VLD::VLD_compilation_enable_option) == nullptr &&
+         strstr(pOptions, "-dump-opt-llvm") == nullptr);
+}
+
+// Links ELF input into an intermediate bitcode module with ProcessElfInput
+// and builds that module.
+static bool TranslateBuildFromLinkedBitcode(
+    const STB_TranslateInputArgs* pInputArgs,
+    STB_TranslateOutputArgs* pOutputArgs,
+    const IGC::CPlatform& IGCPlatform,
+    float profilingTimerResolution)
+{
+    STB_TranslateInputArgs linkInputArgs = *pInputArgs;
+    STB_TranslateOutputArgs linkOutputArgs;
+    PLATFORM platform = IGCPlatform.getPlatformInfo();
+    {
+        USC::SShaderStageBTLayout zeroLayout = USC::g_cZeroShaderStageBTLayout;
+        IGC::COCLBTILayout oclLayout(&zeroLayout);
+        CDriverInfoOCLNEO driverInfo;
+        IGC::OpenCLProgramContext oclContextTemp(oclLayout, IGCPlatform, &linkInputArgs, driverInfo, nullptr, false);
+        RegisterComputeErrHandlers(*oclContextTemp.getLLVMContext());
+        if (!ProcessElfInput(linkInputArgs, linkOutputArgs, oclContextTemp, platform, true))
+        {
+            pOutputArgs->pErrorString = linkOutputArgs.pErrorString;
+            pOutputArgs->ErrorStringSize = linkOutputArgs.ErrorStringSize;
+            return false;
+        }
+    }
+
+    STB_TranslateInputArgs buildInputArgs = *pInputArgs;
+    buildInputArgs.pInput = linkOutputArgs.pOutput;
+    buildInputArgs.InputSize = linkOutputArgs.OutputSize;
+    bool success = TranslateBuild(&buildInputArgs, pOutputArgs, TB_DATA_FORMAT_LLVM_BINARY,
+        IGCPlatform, profilingTimerResolution);
+
+    // Keep the link warning (if any) when the build itself reported nothing.
+    if (pOutputArgs->pErrorString == nullptr)
+    {
+        pOutputArgs->pErrorString = linkOutputArgs.pErrorString;
+        pOutputArgs->ErrorStringSize = linkOutputArgs.ErrorStringSize;
+    }
+    else
+    {
+        delete[] linkOutputArgs.pErrorString;
+    }
+    delete[] linkOutputArgs.pOutput;
+
+    return success;
+}
+
+bool TranslateBuild(
+    const STB_TranslateInputArgs* pInputArgs,
+    STB_TranslateOutputArgs* pOutputArgs,
+    TB_DATA_FORMAT inputDataFormatTemp,
+    const IGC::CPlatform& IGCPlatform,
+    float profilingTimerResolution)
+{
+    if (inputDataFormatTemp == TB_DATA_FORMAT_ELF && !CanLinkElfInMemory(pInputArgs))
+    {
+        return TranslateBuildFromLinkedBitcode(pInputArgs, pOutputArgs,
+            IGCPlatform, profilingTimerResolution);
+    }
+
+    // Dumps and shader overrides are side effects of an actual compilation,
+    // so the program binary cache stays out of the way when they are enabled.
+    const char* cacheDir = IGC_GET_REGKEYSTRING(ProgramBinaryCacheDir);
+    bool useCache = cacheDir[0] != '\0' &&
+        IGC_IS_FLAG_DISABLED(ShaderDumpEnable) &&
+        IGC_IS_FLAG_DISABLED(ShaderOverride) &&
+        ProgramBinaryCache::isCacheable(*pInputArgs);
+
+    if (!useCache)
+    {
+        return TranslateBuildUncached(pInputArgs, pOutputArgs, inputDataFormatTemp,
+            IGCPlatform, profilingTimerResolution);
+    }
+
+    uint64_t maxCacheSize = (uint64_t)IGC_GET_FLAG_VALUE(ProgramBinaryCacheMaxSizeMB) * 1024 * 1024;
+    ProgramBinaryCache cache(cacheDir, maxCacheSize);
+    std::string key = ProgramBinaryCache::computeKey(*pInputArgs, inputDataFormatTemp,
+        IGCPlatform, profilingTimerResolution);
+    if (cache.load(key, *pOutputArgs))
+    {
+        return true;
+    }
+
+    bool success = TranslateBuildUncached(pInputArgs, pOutputArgs, inputDataFormatTemp,
+        IGCPlatform, profilingTimerResolution);
+    if (success)
+    {
+        cache.store(key, *pOutputArgs);
+    }
+    return success;
+}
+
 bool CIGCTranslationBlock::FreeAllocations(
     STB_TranslateOutputArgs* pOutputArgs)
 {
@@ -1406,7 +1596,8 @@ bool CIGCTranslationBlock::Initialize(
 
     validTBChain |=
         (m_DataFormatInput == TB_DATA_FORMAT_ELF) &&
-        (m_DataFormatOutput == TB_DATA_FORMAT_LLVM_BINARY);
+        ((m_DataFormatOutput == TB_DATA_FORMAT_LLVM_BINARY) ||
+         isDeviceBinaryFormat(m_DataFormatOutput));
 
     validTBChain |=
         (m_DataFormatInput == TB_DATA_FORMAT_LLVM_TEXT) &&
@@ -1428,6 +1619,7 @@ bool CIGCTranslationBlock::Initialize(
 static const STB_TranslationCode g_cICBETranslationCodes[] =
 {
     { { TB_DATA_FORMAT_ELF,           TB_DATA_FORMAT_LLVM_BINARY   } },
+    { { TB_DATA_FORMAT_ELF,           TB_DATA_FORMAT_DEVICE_BINARY } },
     { { TB_DATA_FORMAT_LLVM_TEXT,     TB_DATA_FORMAT_DEVICE_BINARY } },
     { { TB_DATA_FORMAT_LLVM_BINARY,   TB_DATA_FORMAT_DEVICE_BINARY } },
     { { TB_DATA_FORMAT_SPIR_V,        TB_DATA_FORMAT_DEVICE_BINARY } },
@@ -9,6 +9,7 @@ SPDX-License-Identifier: MIT
 #pragma once
 
 #include <cinttypes>
+#include <vector>
 
 #include "cif/builtins/memory/buffer/buffer.h"
 #include "cif/common/id.h"
@@ -110,6 +111,40 @@ protected:
                                                   void *gtPinInput);
 };
 
+CIF_DEFINE_INTERFACE_VER_WITH_COMPATIBILITY(IgcOclTranslationCtx, 4, 3) {
+  using IgcOclTranslationCtx<3>::TranslateImpl;
+  using IgcOclTranslationCtx<3>::Translate;
+
+  CIF_INHERIT_CONSTRUCTOR();
+
+  // Translates numInputs sources in one call, sharing registry, platform and
+  // builtin module setup between them and spreading them across worker
+  // threads. options and internalOptions may be nullptr or hold one (possibly
+  // nullptr) entry per source. Returns true only if every source translated
+  // successfully; outputs[i] carries the result and build log of srcs[i].
+  template <typename OclTranslationOutputInterface = OclTranslationOutputTagOCL>
+  bool TranslateBatch(uint32_t numInputs,
+                      CIF::Builtins::BufferSimple **srcs,
+                      CIF::Builtins::BufferSimple **options,
+                      CIF::Builtins::BufferSimple **internalOptions,
+                      CIF::RAII::UPtr_t<OclTranslationOutputInterface> *outputs) {
+      std::vector<OclTranslationOutputBase *> rawOutputs(numInputs, nullptr);
+      bool success = TranslateBatchImpl(OclTranslationOutputInterface::GetVersion(), numInputs, srcs, options, internalOptions, rawOutputs.data());
+      for (uint32_t i = 0; i < numInputs; ++i) {
+          outputs[i] = CIF::RAII::Pack<OclTranslationOutputInterface>(rawOutputs[i]);
+      }
+      return success;
+  }
+
+protected:
+  virtual bool TranslateBatchImpl(CIF::Version_t outVersion,
+                                  uint32_t numInputs,
+                                  CIF::Builtins::BufferSimple **srcs,
+                                  CIF::Builtins::BufferSimple **options,
+                                  CIF::Builtins::BufferSimple **internalOptions,
+                                  OclTranslationOutputBase **outputs);
+};
+
 CIF_GENERATE_VERSIONS_LIST_AND_DECLARE_INTERFACE_DEPENDENCIES(IgcOclTranslationCtx, IGC::OclTranslationOutput, CIF::Builtins::Buffer);
 CIF_MARK_LATEST_VERSION(IgcOclTranslationCtxLatest, IgcOclTranslationCtx);
 using IgcOclTranslationCtxTagOCL = IgcOclTranslationCtxLatest; // Note : can tag with different version for
@@ -54,6 +54,16 @@ OclTranslationOutputBase *CIF_GET_INTERFACE_CLASS(IgcOclTranslationCtx, 3)::Tran
     return CIF_GET_PIMPL()->Translate(outVersion, src, specConstantsIds, specConstantsValues, options, internalOptions, tracingOptions, tracingOptionsCount, gtPinInput);
 }
 
+bool CIF_GET_INTERFACE_CLASS(IgcOclTranslationCtx, 4)::TranslateBatchImpl(
+                            CIF::Version_t outVersion,
+                            uint32_t numInputs,
+                            CIF::Builtins::BufferSimple **srcs,
+                            CIF::Builtins::BufferSimple **options,
+                            CIF::Builtins::BufferSimple **internalOptions,
+                            OclTranslationOutputBase **outputs) {
+    return CIF_GET_PIMPL()->TranslateBatch(outVersion, numInputs, srcs, options, internalOptions, outputs);
+}
+
 }
 
 #include "cif/macros/disable.h"
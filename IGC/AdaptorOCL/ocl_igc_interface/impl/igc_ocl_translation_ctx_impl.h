@@ -11,7 +11,11 @@ SPDX-License-Identifier: MIT
 #include "ocl_igc_interface/igc_ocl_translation_ctx.h"
 #include "ocl_igc_interface/impl/igc_ocl_device_ctx_impl.h"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include "cif/builtins/memory/buffer/impl/buffer_impl.h"
 #include "cif/helpers/error.h"
@@ -24,6 +28,10 @@ SPDX-License-Identifier: MIT
 
 #include "cif/macros/enable.h"
 
+namespace llvm{
+class MemoryBuffer;
+}
+
 namespace TC{
 
 // Taken from dllInterfaceCompute
@@ -47,6 +55,9 @@ bool TranslateBuild(
   const IGC::CPlatform &platform,
   float profilingTimerResolution);
 
+using BuiltinResourceHandles = std::vector<std::shared_ptr<llvm::MemoryBuffer>>;
+BuiltinResourceHandles AcquireBuiltinResources();
+
 bool ReadSpecConstantsFromSPIRV(
     std::istream &IS,
     std::vector<std::pair<uint32_t, uint32_t>> &OutSCInfo);
@@ -99,6 +110,7 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
             {
                   // from                 // to
                 { CodeType::elf,      CodeType::llvmBc },
+                { CodeType::elf,      CodeType::oclGenBin },
                 { CodeType::llvmLl,   CodeType::oclGenBin },
                 { CodeType::llvmBc,   CodeType::oclGenBin },
                 { CodeType::spirV,    CodeType::oclGenBin },
@@ -178,17 +190,8 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
                     src->PushBackRawBytes(arg, strlen(arg));
                 }
             }
-            inputArgs.pInput = src->GetMemoryWriteable<char>();
-            inputArgs.InputSize = static_cast<uint32_t>(src->GetSizeRaw());
-        }
-        if(options != nullptr){
-            inputArgs.pOptions = options->GetMemory<char>();
-            inputArgs.OptionsSize = static_cast<uint32_t>(options->GetSizeRaw());
-        }
-        if(internalOptions != nullptr){
-            inputArgs.pInternalOptions =  internalOptions->GetMemory<char>();
-            inputArgs.InternalOptionsSize = static_cast<uint32_t>(internalOptions->GetSizeRaw());
         }
+        GetInputArgs(inputArgs, src, options, internalOptions);
         if(tracingOptions != nullptr){
             inputArgs.pTracingOptions = tracingOptions->GetMemoryRawWriteable();
         }
@@ -200,36 +203,139 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
         }
         inputArgs.GTPinInput = gtPinInput;
 
-        CIF::Sanity::NotNullOrAbort(this->globalState.GetPlatformImpl());
-        auto platform = this->globalState.GetPlatformImpl()->p;
+        std::string RegKeysFlagsFromOptions = GetRegKeysFlagsFromOptions(inputArgs.pOptions);
+        bool RegFlagNameError = 0;
+        LoadRegistryKeys(RegKeysFlagsFromOptions, &RegFlagNameError);
+        if(RegFlagNameError) outputInterface->GetImpl()->SetError(TranslationErrorType::Unused, "Invalid registry flag name in -igc_opts, at least one flag has been ignored");
 
-        USC::SShaderStageBTLayout zeroLayout = USC::g_cZeroShaderStageBTLayout;
-        IGC::COCLBTILayout oclLayout(&zeroLayout);
+        IGC::CPlatform igcPlatform = this->globalState.GetIgcCPlatform();
 
-        TC::STB_TranslateOutputArgs output;
-        CIF::SafeZeroOut(output);
+        return TranslateInput(std::move(outputInterface), inputArgs, igcPlatform);
+    }
+
+    bool TranslateBatch(CIF::Version_t outVersion,
+                        uint32_t numInputs,
+                        CIF::Builtins::BufferSimple **srcs,
+                        CIF::Builtins::BufferSimple **options,
+                        CIF::Builtins::BufferSimple **internalOptions,
+                        OclTranslationOutputBase **outputs) const{
+        if((srcs == nullptr) || (outputs == nullptr)){
+            return false;
+        }
+        for(uint32_t i = 0; i < numInputs; ++i){
+            outputs[i] = nullptr;
+        }
+        if (IGC_State::isDestructed()) {
+            return false;
+        }
+
+        // Per-batch setup. Registry keys are loaded once per process, so
+        // -igc_opts is only honored on the first input, as with Translate.
+        std::string RegKeysFlagsFromOptions;
+        if ((numInputs > 0) && (options != nullptr) && (options[0] != nullptr))
+        {
+            RegKeysFlagsFromOptions = GetRegKeysFlagsFromOptions(options[0]->GetMemory<char>());
+        }
+        LoadRegistryKeys(RegKeysFlagsFromOptions);
+
+        const IGC::CPlatform igcPlatform = this->globalState.GetIgcCPlatform();
+
+        // Keep the builtin modules loaded for the whole batch so that every
+        // input shares one copy of them.
+        TC::BuiltinResourceHandles builtins = TC::AcquireBuiltinResources();
+
+        std::atomic<bool> success{true};
+        std::atomic<uint32_t> nextInput{0};
+        auto translateInputs = [&]() {
+            for(uint32_t i = nextInput++; i < numInputs; i = nextInput++){
+                auto outputInterface = CIF::RAII::UPtr(CIF::InterfaceCreator<OclTranslationOutput>::CreateInterfaceVer(outVersion, this->outType));
+                if(outputInterface == nullptr){
+                    success = false; // OOM
+                    continue;
+                }
+                TC::STB_TranslateInputArgs inputArgs;
+                GetInputArgs(inputArgs, srcs[i],
+                             (options != nullptr) ? options[i] : nullptr,
+                             (internalOptions != nullptr) ? internalOptions[i] : nullptr);
+                bool inputSuccess = false;
+                outputs[i] = TranslateInput(std::move(outputInterface), inputArgs, igcPlatform, &inputSuccess);
+                if(inputSuccess == false){
+                    success = false;
+                }
+            }
+        };
+
+        uint32_t numThreads = IGC_GET_FLAG_VALUE(TranslateBatchThreads);
+        if(numThreads == 0){
+            numThreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        numThreads = std::min(numThreads, numInputs);
+
+        std::vector<std::thread> workers;
+        for(uint32_t t = 1; t < numThreads; ++t){
+            workers.emplace_back(translateInputs);
+        }
+        translateInputs();
+        for(auto &worker : workers){
+            worker.join();
+        }
+
+        return success;
+    }
 
+protected:
+    static std::string GetRegKeysFlagsFromOptions(const char *pOptions){
         std::string RegKeysFlagsFromOptions;
-        if (inputArgs.pOptions != nullptr)
+        if (pOptions != nullptr)
         {
-            const std::string optionsWithFlags = inputArgs.pOptions;
-            std::size_t found = optionsWithFlags.find("-igc_opts");
-            if (found != std::string::npos)
+            // Search the options in place rather than copying them
+            const char* found = strstr(pOptions, "-igc_opts");
+            if (found != nullptr)
             {
-                std::size_t foundFirstSingleQuote = optionsWithFlags.find('\'', found);
-                std::size_t foundSecondSingleQuote = optionsWithFlags.find('\'', foundFirstSingleQuote + 1);
-                if (foundFirstSingleQuote != std::string::npos && foundSecondSingleQuote)
+                const char* firstSingleQuote = strchr(found, '\'');
+                const char* secondSingleQuote = firstSingleQuote ? strchr(firstSingleQuote + 1, '\'') : nullptr;
+                if (firstSingleQuote != nullptr && secondSingleQuote != nullptr)
                 {
-                    RegKeysFlagsFromOptions = optionsWithFlags.substr(foundFirstSingleQuote + 1, (foundSecondSingleQuote - foundFirstSingleQuote - 1));
-                    RegKeysFlagsFromOptions = RegKeysFlagsFromOptions + ',';
+                    RegKeysFlagsFromOptions.assign(firstSingleQuote + 1, secondSingleQuote);
+                    RegKeysFlagsFromOptions += ',';
                 }
             }
         }
-        bool RegFlagNameError = 0;
-        LoadRegistryKeys(RegKeysFlagsFromOptions, &RegFlagNameError);
-        if(RegFlagNameError) outputInterface->GetImpl()->SetError(TranslationErrorType::Unused, "Invalid registry flag name in -igc_opts, at least one flag has been ignored");
+        return RegKeysFlagsFromOptions;
+    }
 
-        IGC::CPlatform igcPlatform = this->globalState.GetIgcCPlatform();
+    static void GetInputArgs(TC::STB_TranslateInputArgs &inputArgs,
+                             CIF::Builtins::BufferSimple *src,
+                             CIF::Builtins::BufferSimple *options,
+                             CIF::Builtins::BufferSimple *internalOptions){
+        if(src != nullptr){
+            inputArgs.pInput = src->GetMemoryWriteable<char>();
+            inputArgs.InputSize = static_cast<uint32_t>(src->GetSizeRaw());
+        }
+        if(options != nullptr){
+            inputArgs.pOptions = options->GetMemory<char>();
+            inputArgs.OptionsSize = static_cast<uint32_t>(options->GetSizeRaw());
+        }
+        if(internalOptions != nullptr){
+            inputArgs.pInternalOptions =  internalOptions->GetMemory<char>();
+            inputArgs.InternalOptionsSize = static_cast<uint32_t>(internalOptions->GetSizeRaw());
+        }
+    }
+
+    // Translates a single input once registry keys and the platform are set up
+    template <typename OutputInterfaceT>
+    OclTranslationOutputBase *TranslateInput(OutputInterfaceT outputInterface,
+                                             TC::STB_TranslateInputArgs &inputArgs,
+                                             const IGC::CPlatform &igcPlatform,
+                                             bool *pSuccess = nullptr) const{
+        CIF::Sanity::NotNullOrAbort(this->globalState.GetPlatformImpl());
+        auto platform = this->globalState.GetPlatformImpl()->p;
+
+        USC::SShaderStageBTLayout zeroLayout = USC::g_cZeroShaderStageBTLayout;
+        IGC::COCLBTILayout oclLayout(&zeroLayout);
+
+        TC::STB_TranslateOutputArgs output;
+        CIF::SafeZeroOut(output);
 
         // extra ocl options set from regkey
         const char *extraOptions = IGC_GET_REGKEYSTRING(ExtraOCLOptions);
@@ -260,7 +366,18 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
         }
 
         bool success = false;
-        if (this->inType == CodeType::elf)
+        if ((this->inType == CodeType::elf) && (this->outType == CodeType::oclGenBin))
+        {
+            // Link input modules into an executable. The linked module is
+            // handed to codegen directly, without a bitcode round trip.
+            success = TC::TranslateBuild(
+                &inputArgs,
+                &output,
+                TC::TB_DATA_FORMAT_ELF,
+                igcPlatform,
+                this->globalState.MiscOptions.ProfilingTimerResolution);
+        }
+        else if (this->inType == CodeType::elf)
         {
             // Handle TB_DATA_FORMAT_ELF input as a result of a call to
             // clLinkLibrary(). There are two possible scenarios, link input
@@ -300,8 +417,10 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
         bool dataCopiedSuccessfuly = true;
         if(success){
             dataCopiedSuccessfuly &= outputInterface->GetImpl()->AddWarning(output.pErrorString, output.ErrorStringSize);
-            dataCopiedSuccessfuly &= outputInterface->GetImpl()->CloneDebugData(output.pDebugData, output.DebugDataSize);
-            dataCopiedSuccessfuly &= outputInterface->GetImpl()->SetSuccessfulAndCloneOutput(output.pOutput, output.OutputSize);
+            // Binaries and debug data can be several MB, so the output
+            // buffers take over the compiler's allocations instead of copying
+            outputInterface->GetImpl()->AdoptDebugData(debugData.release(), output.DebugDataSize);
+            outputInterface->GetImpl()->SetSuccessfulAndAdoptOutput(outputData.release(), output.OutputSize);
         }else{
             dataCopiedSuccessfuly &= outputInterface->GetImpl()->SetError(TranslationErrorType::FailedCompilation, output.pErrorString);
         }
@@ -310,6 +429,10 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
             return nullptr; // OOM
         }
 
+        if(pSuccess != nullptr){
+            *pSuccess = success;
+        }
+
         return outputInterface.release();
     }
 
@@ -128,7 +128,33 @@ CIF_DECLARE_INTERFACE_PIMPL(OclTranslationOutput) : CIF::PimplBase
         return DebugData->PushBackRawBytes(data, size);
     }
 
+    /// Takes ownership of a new[]-allocated output buffer instead of copying it
+    void SetSuccessfulAndAdoptOutput(char * data, size_t size)
+    {
+        this->Error = TranslationErrorType::Success;
+        AdoptBuffer(Output, data, size);
+    }
+
+    /// Takes ownership of a new[]-allocated debug data buffer instead of copying it
+    void AdoptDebugData(char * data, size_t size)
+    {
+        AdoptBuffer(DebugData, data, size);
+    }
+
 protected:
+    static void CIF_CALLING_CONV DeleteArray(void * memory)
+    {
+        delete [] reinterpret_cast<char*>(memory);
+    }
+
+    static void AdoptBuffer(CIF::Multiversion<CIF::Builtins::Buffer> & buffer, char * data, size_t size)
+    {
+        if(data == nullptr){
+            return;
+        }
+        buffer->SetUnderlyingStorage(data, size, DeleteArray);
+    }
+
     CIF::Multiversion<CIF::Builtins::Buffer> BuildLog;
     CIF::Multiversion<CIF::Builtins::Buffer> Output;
     CIF::Multiversion<CIF::Builtins::Buffer> DebugData;
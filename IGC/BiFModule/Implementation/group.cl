@@ -2167,107 +2167,92 @@ DEFN_ARITH_OPERATIONS(double)
 DEFN_ARITH_OPERATIONS(half)
 #endif // defined(cl_khr_fp16)
 
-#define DEFN_WORK_GROUP_REDUCE(func, type_abbr, type, op)                                                  \
-type __builtin_IB_WorkGroupReduce_##func##_##type_abbr(type X)                                             \
-{                                                                                                          \
-    type sg_x = SPIRV_BUILTIN(Group##func, _i32_i32_##type_abbr, )(Subgroup, GroupOperationReduce, X);     \
-    GET_MEMPOOL_PTR(scratch, type, true, 0)                                                                \
-    uint sg_id = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupId, , )();                                             \
-    uint num_sg = SPIRV_BUILTIN_NO_OP(BuiltInNumSubgroups, , )();                                          \
-    uint sg_lid = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupLocalInvocationId, , )();                             \
-    uint sg_size = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupSize, , )();                                         \
-                                                                                                           \
-    if (sg_lid == sg_size - 1) {                                                                           \
-        scratch[sg_id] = sg_x;                                                                             \
-    }                                                                                                      \
-    SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Workgroup, 0, AcquireRelease | WorkgroupMemory);         \
-                                                                                                           \
-    type sg_aggregate = scratch[0];                                                                        \
-    for (int s = 1; s < num_sg; ++s) {                                                                     \
-        sg_aggregate = op(sg_aggregate, scratch[s]);                                                       \
-    }                                                                                                      \
-                                                                                                           \
-    SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Workgroup, 0, AcquireRelease | WorkgroupMemory);         \
-    return sg_aggregate;                                                                                   \
-}
-
-
-#define DEFN_WORK_GROUP_SCAN_INCL(func, type_abbr, type, op)                                                    \
-type __builtin_IB_WorkGroupScanInclusive_##func##_##type_abbr(type X)                                           \
-{                                                                                                               \
-    type sg_x = SPIRV_BUILTIN(Group##func, _i32_i32_##type_abbr, )(Subgroup, GroupOperationInclusiveScan, X);   \
-                                                                                                                \
-    GET_MEMPOOL_PTR(scratch, type, true, 0)                                                                     \
-    uint sg_id = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupId, , )();                                                  \
-    uint num_sg = SPIRV_BUILTIN_NO_OP(BuiltInNumSubgroups, , )();                                               \
-    uint sg_lid = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupLocalInvocationId, , )();                                  \
-    uint sg_size = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupSize, , )();                                              \
-                                                                                                                \
-    if (sg_lid == sg_size - 1) {                                                                                \
-        scratch[sg_id] = sg_x;                                                                                  \
-    }                                                                                                           \
-    SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Workgroup, 0, AcquireRelease | WorkgroupMemory);              \
-                                                                                                                \
-    type sg_prefix;                                                                                             \
-    type sg_aggregate = scratch[0];                                                                             \
-    for (int s = 1; s < num_sg; ++s) {                                                                          \
-        if (sg_id == s) {                                                                                       \
-            sg_prefix = sg_aggregate;                                                                           \
-            break;                                                                                              \
-        }                                                                                                       \
-        sg_aggregate = op(sg_aggregate, scratch[s]);                                                            \
-    }                                                                                                           \
-                                                                                                                \
-    type result;                                                                                                \
-    if (sg_id == 0) {                                                                                           \
-        result = sg_x;                                                                                          \
-    } else {                                                                                                    \
-        result = op(sg_x, sg_prefix);                                                                           \
-    }                                                                                                           \
-    SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Workgroup, 0, AcquireRelease | WorkgroupMemory);              \
-    return result;                                                                                              \
-}
-
-
-#define DEFN_WORK_GROUP_SCAN_EXCL(func, type_abbr, type, op, identity)                                          \
-type __builtin_IB_WorkGroupScanExclusive_##func##_##type_abbr(type X)                                           \
-{                                                                                                               \
-    type carry = SPIRV_BUILTIN(Group##func, _i32_i32_##type_abbr, )(Subgroup, GroupOperationInclusiveScan, X);  \
-                                                                                                                \
-    GET_MEMPOOL_PTR(scratch, type, true, 0)                                                                     \
-    uint sg_id = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupId, , )();                                                  \
-    uint num_sg = SPIRV_BUILTIN_NO_OP(BuiltInNumSubgroups, , )();                                               \
-    uint sg_lid = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupLocalInvocationId, , )();                                  \
-    uint sg_size = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupSize, , )();                                              \
-                                                                                                                \
-    type sg_x = intel_sub_group_shuffle_up((type)identity, carry, 1);                                           \
-    if (sg_lid == 0) {                                                                                          \
-        sg_x = identity;                                                                                        \
-    }                                                                                                           \
-                                                                                                                \
-    if (sg_lid == sg_size - 1) {                                                                                \
-        scratch[sg_id] = carry;                                                                                 \
-    }                                                                                                           \
-    SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Workgroup, 0, AcquireRelease | WorkgroupMemory);              \
-                                                                                                                \
-    type sg_prefix;                                                                                             \
-    type sg_aggregate = scratch[0];                                                                             \
-    for (int s = 1; s < num_sg; ++s) {                                                                          \
-        if (sg_id == s) {                                                                                       \
-          sg_prefix = sg_aggregate;                                                                             \
-          break;                                                                                                \
-        }                                                                                                       \
-        sg_aggregate = op(sg_aggregate, scratch[s]);                                                            \
-    }                                                                                                           \
-                                                                                                                \
-    type result;                                                                                                \
-    if (sg_id == 0) {                                                                                           \
-        result = sg_x;                                                                                          \
-    } else {                                                                                                    \
-        result = op(sg_x, sg_prefix);                                                                           \
-    }                                                                                                           \
-    SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Workgroup, 0, AcquireRelease | WorkgroupMemory);              \
-    return result;                                                                                              \
+#define DEFN_WORK_GROUP_REDUCE(func, type_abbr, type, op, identity)                                                    \
+type __builtin_IB_WorkGroupReduce_##func##_##type_abbr(type X)                                                         \
+{                                                                                                                      \
+    type sg_x = SPIRV_BUILTIN(Group##func, _i32_i32_##type_abbr, )(Subgroup, GroupOperationReduce, X);                 \
+    GET_MEMPOOL_PTR(scratch, type, true, 0)                                                                            \
+    uint sg_id = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupId, , )();                                                         \
+    uint num_sg = SPIRV_BUILTIN_NO_OP(BuiltInNumSubgroups, , )();                                                      \
+    uint sg_lid = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupLocalInvocationId, , )();                                         \
+    uint sg_size = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupSize, , )();                                                     \
+                                                                                                                       \
+    if (sg_lid == sg_size - 1) {                                                                                       \
+        scratch[sg_id] = sg_x;                                                                                         \
+    }                                                                                                                  \
+    SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Workgroup, 0, AcquireRelease | WorkgroupMemory);                     \
+                                                                                                                       \
+    /* Each lane loads the partial results of its subgroups, which are then */                                         \
+    /* combined in registers instead of one SLM load per subgroup.          */                                         \
+    type sg_partial = (type)identity;                                                                                  \
+    for (uint s = sg_lid; s < num_sg; s += sg_size) {                                                                  \
+        sg_partial = op(sg_partial, scratch[s]);                                                                       \
+    }                                                                                                                  \
+    type sg_aggregate = SPIRV_BUILTIN(Group##func, _i32_i32_##type_abbr, )(Subgroup, GroupOperationReduce, sg_partial);\
+                                                                                                                       \
+    SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Workgroup, 0, AcquireRelease | WorkgroupMemory);                     \
+    return sg_aggregate;                                                                                               \
+}
+
+
+#define DEFN_WORK_GROUP_SCAN_INCL(func, type_abbr, type, op, identity)                                                 \
+type __builtin_IB_WorkGroupScanInclusive_##func##_##type_abbr(type X)                                                  \
+{                                                                                                                      \
+    type sg_x = SPIRV_BUILTIN(Group##func, _i32_i32_##type_abbr, )(Subgroup, GroupOperationInclusiveScan, X);          \
+                                                                                                                       \
+    GET_MEMPOOL_PTR(scratch, type, true, 0)                                                                            \
+    uint sg_id = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupId, , )();                                                         \
+    uint sg_lid = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupLocalInvocationId, , )();                                         \
+    uint sg_size = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupSize, , )();                                                     \
+                                                                                                                       \
+    if (sg_lid == sg_size - 1) {                                                                                       \
+        scratch[sg_id] = sg_x;                                                                                         \
+    }                                                                                                                  \
+    SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Workgroup, 0, AcquireRelease | WorkgroupMemory);                     \
+                                                                                                                       \
+    /* The prefix is the reduction of the partial results of the subgroups */                                          \
+    /* before this one, loaded one per lane.                               */                                          \
+    type sg_partial = (type)identity;                                                                                  \
+    for (uint s = sg_lid; s < sg_id; s += sg_size) {                                                                   \
+        sg_partial = op(sg_partial, scratch[s]);                                                                       \
+    }                                                                                                                  \
+    type sg_prefix = SPIRV_BUILTIN(Group##func, _i32_i32_##type_abbr, )(Subgroup, GroupOperationReduce, sg_partial);   \
+                                                                                                                       \
+    type result = sg_id == 0 ? sg_x : op(sg_x, sg_prefix);                                                             \
+    SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Workgroup, 0, AcquireRelease | WorkgroupMemory);                     \
+    return result;                                                                                                     \
+}
+
+
+#define DEFN_WORK_GROUP_SCAN_EXCL(func, type_abbr, type, op, identity)                                                 \
+type __builtin_IB_WorkGroupScanExclusive_##func##_##type_abbr(type X)                                                  \
+{                                                                                                                      \
+    type carry = SPIRV_BUILTIN(Group##func, _i32_i32_##type_abbr, )(Subgroup, GroupOperationInclusiveScan, X);         \
+                                                                                                                       \
+    GET_MEMPOOL_PTR(scratch, type, true, 0)                                                                            \
+    uint sg_id = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupId, , )();                                                         \
+    uint sg_lid = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupLocalInvocationId, , )();                                         \
+    uint sg_size = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupSize, , )();                                                     \
+                                                                                                                       \
+    type sg_x = intel_sub_group_shuffle_up((type)identity, carry, 1);                                                  \
+    if (sg_lid == 0) {                                                                                                 \
+        sg_x = identity;                                                                                               \
+    }                                                                                                                  \
+                                                                                                                       \
+    if (sg_lid == sg_size - 1) {                                                                                       \
+        scratch[sg_id] = carry;                                                                                        \
+    }                                                                                                                  \
+    SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Workgroup, 0, AcquireRelease | WorkgroupMemory);                     \
+                                                                                                                       \
+    type sg_partial = (type)identity;                                                                                  \
+    for (uint s = sg_lid; s < sg_id; s += sg_size) {                                                                   \
+        sg_partial = op(sg_partial, scratch[s]);                                                                       \
+    }                                                                                                                  \
+    type sg_prefix = SPIRV_BUILTIN(Group##func, _i32_i32_##type_abbr, )(Subgroup, GroupOperationReduce, sg_partial);   \
+                                                                                                                       \
+    type result = sg_id == 0 ? sg_x : op(sg_x, sg_prefix);                                                             \
+    SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Workgroup, 0, AcquireRelease | WorkgroupMemory);                     \
+    return result;                                                                                                     \
 }
 
 #define DEFN_SUB_GROUP_REDUCE(func, type_abbr, type, op, identity, signed_cast)                         \
@@ -2391,8 +2376,8 @@ DEFN_SUB_GROUP_REDUCE(func, type_abbr, type, op, identity, signed_cast)
 DEFN_SUB_GROUP_SCAN_INCL(func, type_abbr, type, op, identity)                                     \
 DEFN_SUB_GROUP_SCAN_EXCL(func, type_abbr, type, op, identity)                                     \
                                                                                                   \
-DEFN_WORK_GROUP_REDUCE(func, type_abbr, type, op)                                                 \
-DEFN_WORK_GROUP_SCAN_INCL(func, type_abbr, type, op)                                              \
+DEFN_WORK_GROUP_REDUCE(func, type_abbr, type, op, identity)                                       \
+DEFN_WORK_GROUP_SCAN_INCL(func, type_abbr, type, op, identity)                                    \
 DEFN_WORK_GROUP_SCAN_EXCL(func, type_abbr, type, op, identity)                                    \
                                                                                                   \
 type  SPIRV_OVERLOADABLE SPIRV_BUILTIN(Group##func, _i32_i32_##type_abbr, )(int Execution, int Operation, type X) \
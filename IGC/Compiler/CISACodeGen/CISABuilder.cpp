@@ -470,6 +470,7 @@ namespace IGC
     {
         VISA_LabelOpnd* visaLabel = GetLabel(label);
         V(vKernel->AppendVISACFLabelInst(visaLabel));
+        ++m_numLabelsPlaced;
     }
 
     uint CEncoder::GetNewLabelID(const CName &name)
@@ -4451,6 +4452,13 @@ namespace IGC
         // Set to stitch all functions to all kernels in a VISABuidler
         SaveOption(vISA_noStitchExternFunc, false);
 
+        // The budget applies to each kernel compilation in vISA, including
+        // every SIMD variant that is tried.
+        if (IGC_GET_FLAG_VALUE(CompileTimeBudget) != 0)
+        {
+            SaveOption(vISA_CompileTimeBudget, IGC_GET_FLAG_VALUE(CompileTimeBudget));
+        }
+
         // Turning off optimizations as much as possible to have the fastest compilation
         if ((IsStage1FastestCompile(context->m_CgFlag, context->m_StagingCtx) ||
              IGC_GET_FLAG_VALUE(ForceFastestSIMD)) &&
@@ -4617,6 +4625,7 @@ namespace IGC
         m_enableVISAdump = false;
         m_nestLevelForcedNoMaskRegion = 0;
         m_hasInlineAsm = hasInlineAsmCall;
+        m_inlineAsmParseError = false;
 
         InitLabelMap(m_program->entry);
 
@@ -4628,21 +4637,18 @@ namespace IGC
 
         llvm::SmallVector<const char*, 10> params;
         llvm::SmallVector<std::unique_ptr< char, std::function<void(char*)>>, 10> params2;
-        if (!m_hasInlineAsm)
+        InitBuildParams(params2);
+        for (size_t i = 0; i < params2.size(); i++)
         {
-            // Asm text writer mode doesnt need dump params
-            InitBuildParams(params2);
-            for (size_t i = 0; i < params2.size(); i++)
-            {
-                params.push_back((params2[i].get()));
-            }
+            params.push_back((params2[i].get()));
         }
 
         COMPILER_TIME_START(m_program->GetContext(), TIME_CG_vISACompile);
         bool enableVISADump = IGC_IS_FLAG_ENABLED(EnableVISASlowpath) || IGC_IS_FLAG_ENABLED(ShaderDumpEnable);
-        auto builderMode = m_hasInlineAsm ? vISA_ASM_WRITER : vISA_DEFAULT;
+        // Kernels with inline asm keep the vISA instruction lists as well, so
+        // the verifier can check the fragments parsed into them.
         auto builderOpt = (enableVISADump || m_hasInlineAsm) ? VISA_BUILDER_BOTH : VISA_BUILDER_GEN;
-        V(CreateVISABuilder(vbuilder, builderMode, builderOpt, VISAPlatform, params.size(), params.data(),
+        V(CreateVISABuilder(vbuilder, vISA_DEFAULT, builderOpt, VISAPlatform, params.size(), params.data(),
             &m_vISAWaTable));
 
         if (IsCodePatchCandidate())
@@ -4650,6 +4656,14 @@ namespace IGC
             SetHasPrevKernel(prevKernel != nullptr);
         }
         InitVISABuilderOptions(VISAPlatform, canAbortOnSpill, hasStackCall, builderOpt == VISA_BUILDER_BOTH);
+        if (m_hasInlineAsm)
+        {
+            // Inline asm fragments are parsed straight into the kernel and
+            // refer to its variables by name. Always run the vISA verifier
+            // on them to catch errors in the user-written assembly.
+            SaveOption(vISA_NameVarsForInlineAsm, true);
+            SaveOption(vISA_NoVerifyvISA, false);
+        }
 
         // Pass all build options to builder
         SetBuilderOptions(vbuilder);
@@ -5332,8 +5346,15 @@ namespace IGC
             }
         }
 
-        // Compile generated VISA text string for inlineAsm
-        if (m_hasInlineAsm || visaAsmOverride)
+        if (m_inlineAsmParseError)
+        {
+            // The error was reported when the fragment was parsed.
+            COMPILER_TIME_END(m_program->GetContext(), TIME_CG_vISACompile);
+            return;
+        }
+
+        // Compile the overriding .visaasm files instead of the built kernel
+        if (visaAsmOverride)
         {
             llvm::SmallVector<const char*, 10> params;
             llvm::SmallVector<std::unique_ptr< char, std::function<void(char*)>>, 10> params2;
@@ -5348,78 +5369,61 @@ namespace IGC
             V(CreateVISABuilder(vAsmTextBuilder, vISA_ASM_READER, VISA_BUILDER_BOTH, VISAPlatform,
                 params.size(), params.data(), &m_vISAWaTable));
             // Use the same build options as before, except that we enable vISA verifier to catch
-            // potential errors in user inline assembly
+            // potential errors in the overriding assembly
             SetBuilderOptions(vAsmTextBuilder);
             vAsmTextBuilder->SetOption(vISA_NoVerifyvISA, false);
 
             bool vISAAsmParseError = false;
-            // Parse the generated VISA text
-            if (visaAsmOverride)
+            // Parse the overriding VISA text
+            for (const std::string& tmpVisaFile : visaOverrideFiles)
             {
-                for (const std::string& tmpVisaFile : visaOverrideFiles)
-                {
-                    llvm::SmallVector<char, 1024> visaAsmNameVector;
-                    std::string visaAsmName = GetDumpFileName("");
-
-                    StringRef visaAsmNameRef(visaAsmName.c_str());
-                    StringRef tmpVisaFileRef(tmpVisaFile.c_str());
-                    StringRef directory = llvm::sys::path::parent_path(visaAsmNameRef);
-                    StringRef filename = llvm::sys::path::filename(tmpVisaFileRef);
-
-                    llvm::sys::path::append(visaAsmNameVector, directory, filename);
-                    visaAsmName = std::string(visaAsmNameVector.begin(), visaAsmNameVector.end());
-
-                    auto result = vAsmTextBuilder->ParseVISAText(tmpVisaFile.c_str());
-                    appendToShaderOverrideLogFile(visaAsmName, "OVERRIDEN: ");
-                    vISAAsmParseError = (result != 0);
-                    if (vISAAsmParseError) {
-                        IGC_ASSERT_MESSAGE(0, "visaasm file parse error!");
-                        break;
-                    }
+                llvm::SmallVector<char, 1024> visaAsmNameVector;
+                std::string visaAsmName = GetDumpFileName("");
+
+                StringRef visaAsmNameRef(visaAsmName.c_str());
+                StringRef tmpVisaFileRef(tmpVisaFile.c_str());
+                StringRef directory = llvm::sys::path::parent_path(visaAsmNameRef);
+                StringRef filename = llvm::sys::path::filename(tmpVisaFileRef);
+
+                llvm::sys::path::append(visaAsmNameVector, directory, filename);
+                visaAsmName = std::string(visaAsmNameVector.begin(), visaAsmNameVector.end());
+
+                auto result = vAsmTextBuilder->ParseVISAText(tmpVisaFile.c_str());
+                appendToShaderOverrideLogFile(visaAsmName, "OVERRIDEN: ");
+                vISAAsmParseError = (result != 0);
+                if (vISAAsmParseError) {
+                    IGC_ASSERT_MESSAGE(0, "visaasm file parse error!");
+                    break;
                 }
-                // After call to ParseVISAText, we have new VISAKernel, which don't have asm path set.
-                // So we need to set the OutputAsmPath attribute of overridden kernel,
-                // otherwise, we will not get .visaasm dump and .asm file dump
-                auto kernelName = IGC::Debug::GetDumpNameObj(m_program, "").GetKernelName();
-                std::string asmName = GetDumpFileName("asm");
-                auto overriddenKernel = vAsmTextBuilder->GetVISAKernel(kernelName);
-                overriddenKernel->AddKernelAttribute("OutputAsmPath", asmName.length(), asmName.c_str());
-
-                // We need to update stackFuncMap for the symbol table for the overridden object,
-                // because stackFuncMap contains information about functions for original object.
-                // Only the IndirectlyCalled functions should be updated,
-                // because these functions can be used in CreateSymbolTable.
-                // Other normal stack call functions aren't used in CreateSymbolTable.
-                if (hasSymbolTable && stackFuncMap.size() > 0)
+            }
+            // After call to ParseVISAText, we have new VISAKernel, which don't have asm path set.
+            // So we need to set the OutputAsmPath attribute of overridden kernel,
+            // otherwise, we will not get .visaasm dump and .asm file dump
+            auto kernelName = IGC::Debug::GetDumpNameObj(m_program, "").GetKernelName();
+            std::string asmName = GetDumpFileName("asm");
+            auto overriddenKernel = vAsmTextBuilder->GetVISAKernel(kernelName);
+            overriddenKernel->AddKernelAttribute("OutputAsmPath", asmName.length(), asmName.c_str());
+
+            // We need to update stackFuncMap for the symbol table for the overridden object,
+            // because stackFuncMap contains information about functions for original object.
+            // Only the IndirectlyCalled functions should be updated,
+            // because these functions can be used in CreateSymbolTable.
+            // Other normal stack call functions aren't used in CreateSymbolTable.
+            if (hasSymbolTable && stackFuncMap.size() > 0)
+            {
+                Module* pModule = m_program->GetContext()->getModule();
+                for (auto& F : pModule->getFunctionList())
                 {
-                    Module* pModule = m_program->GetContext()->getModule();
-                    for (auto& F : pModule->getFunctionList())
+                    if (F.hasFnAttribute("referenced-indirectly") && (!F.isDeclaration() || !F.use_empty()))
                     {
-                        if (F.hasFnAttribute("referenced-indirectly") && (!F.isDeclaration() || !F.use_empty()))
-                        {
-                            auto Iter = stackFuncMap.find(&F);
-                            IGC_ASSERT_MESSAGE(Iter != stackFuncMap.end(), "vISA function not found");
+                        auto Iter = stackFuncMap.find(&F);
+                        IGC_ASSERT_MESSAGE(Iter != stackFuncMap.end(), "vISA function not found");
 
-                            VISAFunction* original = Iter->second;
-                            stackFuncMap[&F] = static_cast<VISAFunction*>(vAsmTextBuilder->GetVISAKernel(original->getFunctionName()));
-                        }
+                        VISAFunction* original = Iter->second;
+                        stackFuncMap[&F] = static_cast<VISAFunction*>(vAsmTextBuilder->GetVISAKernel(original->getFunctionName()));
                     }
                 }
             }
-            else
-            {
-                std::string parseTextFile = GetDumpFileName("inline.visaasm");
-                auto result = vAsmTextBuilder->ParseVISAText(vbuilder->GetAsmTextStream().str(), parseTextFile);
-                if (result != 0)
-                {
-                    std::string output;
-                    raw_string_ostream S(output);
-                    S << "parsing vISA inline assembly failed:\n" << vAsmTextBuilder->GetCriticalMsg();
-                    S.flush();
-                    context->EmitError(output.c_str(), nullptr);
-                    vISAAsmParseError = true;
-                }
-            }
 
             if (vISAAsmParseError)
             {
@@ -5428,11 +5432,6 @@ namespace IGC
             }
             else
             {
-                if (!visaAsmOverride)
-                {
-                    // vISA verifier is already invoked in ParseVISAText earlier
-                    vAsmTextBuilder->SetOption(vISA_NoVerifyvISA, true);
-                }
                 pMainKernel = vAsmTextBuilder->GetVISAKernel(kernelName);
                 vIsaCompile = vAsmTextBuilder->Compile(m_enableVISAdump ? GetDumpFileName("isa").c_str() : "");
             }
@@ -5442,6 +5441,17 @@ namespace IGC
         {
             pMainKernel = vMainKernel;
             vIsaCompile = vbuilder->Compile(m_enableVISAdump ? GetDumpFileName("isa").c_str() : "");
+            if (m_hasInlineAsm && vIsaCompile == -1)
+            {
+                // The verifier rejected the kernel; report it like a parse error.
+                std::string output;
+                raw_string_ostream S(output);
+                S << "verifying vISA inline assembly failed:\n" << vbuilder->GetCriticalMsg();
+                S.flush();
+                context->EmitError(output.c_str(), nullptr);
+                COMPILER_TIME_END(m_program->GetContext(), TIME_CG_vISACompile);
+                return;
+            }
         }
 
         COMPILER_TIME_END(m_program->GetContext(), TIME_CG_vISACompile);
@@ -5468,6 +5478,9 @@ namespace IGC
             m_program->SetHasBarrier();
         }
 
+        context->EmitCompileTimeFallbacks(
+            std::string(m_program->entry->getName()).c_str(), jitInfo->compileTimeFallbacks);
+
         if (jitInfo->isSpill)
         {
             context->m_retryManager.SetSpillSize(jitInfo->numGRFSpillFill);
@@ -5547,7 +5560,11 @@ namespace IGC
             context->m_retryManager.Disable();
         }
 
-#if (GET_SHADER_STATS && !PRINT_DETAIL_SHADER_STATS)
+        context->metrics.CollectISAStats(
+            m_program->entry, numLanes(m_program->m_dispatchSize), &jitInfo->stats);
+
+#if GET_SHADER_STATS
+        COMPILER_SHADER_STATS_RECORD_ISA(m_program->m_shaderStats, jitInfo->stats);
         if (m_program->m_dispatchSize == SIMDMode::SIMD8)
         {
             COMPILER_SHADER_STATS_SET(m_program->m_shaderStats, STATS_ISA_INST_COUNT, jitInfo->numAsmCount);
@@ -6834,6 +6851,21 @@ namespace IGC
             srcOpnd0));
     }
 
+    bool CEncoder::ParseInlineAsm(const std::string& asmText)
+    {
+        if (vbuilder->ParseVISAInlineAsm(vKernel, asmText) != 0)
+        {
+            std::string output;
+            raw_string_ostream S(output);
+            S << "parsing vISA inline assembly failed:\n" << vbuilder->GetCriticalMsg();
+            S.flush();
+            m_program->GetContext()->EmitError(output.c_str(), nullptr);
+            m_inlineAsmParseError = true;
+            return false;
+        }
+        return true;
+    }
+
     std::string CEncoder::GetVariableName(CVariable* var)
     {
         IGC_ASSERT(nullptr != var);
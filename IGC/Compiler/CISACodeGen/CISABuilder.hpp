@@ -142,6 +142,7 @@ namespace IGC
         void SetProgram(CShader* program);
         void Jump(CVariable* flag, uint label);
         void Label(uint label);
+        uint GetNumLabelsPlaced() const { return m_numLabelsPlaced; }
         uint GetNewLabelID(const CName &name);
         void DwordAtomicRaw(AtomicOp atomic_op,
             const ResourceDescriptor& bindingTableIndex,
@@ -380,6 +381,7 @@ namespace IGC
         inline bool IsSubSpanDestination();
         inline void SetSecondHalf(bool secondHalf);
         inline bool IsSecondHalf();
+        inline bool IsNoMask();
         inline void SetSecondNibble(bool secondNibble);
         inline bool IsSecondNibble();
 
@@ -438,6 +440,9 @@ namespace IGC
         void SetPayloadSectionAsSecondary() {vKernel = vKernelTmp;}
 
         std::string GetUniqueInlineAsmLabel();
+        // Appends an inline asm fragment to the current kernel or function.
+        // Errors are reported to the context and fail the compile.
+        bool ParseInlineAsm(const std::string& asmText);
 
     private:
         // helper functions
@@ -654,9 +659,13 @@ namespace IGC
 
         bool m_enableVISAdump;
         bool m_hasInlineAsm;
+        bool m_inlineAsmParseError = false;
 
         std::vector<VISA_LabelOpnd*> labelMap;
         std::vector<CName> labelNameMap; // parallel to labelMap
+        // Number of labels placed so far, i.e. of points where control flow
+        // may join.
+        uint m_numLabelsPlaced = 0;
 
         /// Per kernel label counter
         unsigned labelCounter = 0;
@@ -1073,6 +1082,11 @@ namespace IGC
         m_encoderState.m_secondHalf = secondHalf;
     }
 
+    inline bool CEncoder::IsNoMask()
+    {
+        return m_encoderState.m_noMask;
+    }
+
     inline bool CEncoder::IsSecondHalf()
     {
         return m_encoderState.m_secondHalf;
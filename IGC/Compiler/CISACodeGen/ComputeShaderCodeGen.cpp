@@ -11,6 +11,8 @@ SPDX-License-Identifier: MIT
 #include "common/LLVMWarningsPop.hpp"
 #include "Compiler/CISACodeGen/ComputeShaderCodeGen.hpp"
 #include "Compiler/CISACodeGen/messageEncoding.hpp"
+#include "Compiler/CISACodeGen/EmitVISAPass.hpp"
+#include "Compiler/CISACodeGen/SIMDSpillPrediction.hpp"
 #include "common/allocator.h"
 #include "common/secure_mem.h"
 #include <iStdLib/utility.h>
@@ -473,6 +475,15 @@ namespace IGC
             return false;
         }
 
+        // skip a width predicted to spill if another one can be used instead
+        SIMDSpillPrediction* SP = EP.getAnalysisIfAvailable<SIMDSpillPrediction>();
+        if (SP && EP.m_canAbortOnSpill && SP->shouldSkip(simdMode))
+        {
+            ctx->SetSIMDInfo(SIMD_SKIP_SPILL, simdMode, ShaderDispatchMode::NOT_APPLICABLE);
+            SP->logOutcome(this, "skipped");
+            return false;
+        }
+
         if (ctx->platform.switchSIMDBasedOnMemInstr())
         {
             //Check if we should switch to SIMD16 based on number of load instr
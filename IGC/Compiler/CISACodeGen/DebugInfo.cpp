@@ -14,6 +14,9 @@ SPDX-License-Identifier: MIT
 #include "DebugInfo/DwarfDebug.hpp"
 #include "Compiler/CISACodeGen/DebugInfo.hpp"
 
+#include <atomic>
+#include <thread>
+
 using namespace llvm;
 using namespace IGC;
 using namespace IGC::IGCMD;
@@ -74,168 +77,198 @@ bool DebugInfoPass::runOnModule(llvm::Module& M)
     }
 
     DwarfDISubprogramCache DISPCache;
+    std::vector<UnitResult> results(units.size());
+
+    // Every shader has its own debug emitter, and with it its own DIE
+    // allocator, DwarfDebug and StreamEmitter, so the shaders are emitted
+    // independently. Only the DISubprogram cache is shared.
+    std::atomic<size_t> nextUnit{0};
+    auto processUnits = [&]() {
+        for (size_t i = nextUnit++; i < units.size(); i = nextUnit++)
+        {
+            processUnit(units[i], DISPCache, results[i]);
+        }
+    };
 
-    for (auto& currShader : units)
+    unsigned numThreads = IGC_GET_FLAG_VALUE(DebugInfoThreads);
+    if (numThreads == 0)
     {
-        // Look for the right CShaderProgram instance
-        m_currShader = currShader;
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    numThreads = (unsigned)std::min<size_t>(numThreads, units.size());
 
-        MetaDataUtils* pMdUtils = m_currShader->GetMetaDataUtils();
-        if (!isEntryFunc(pMdUtils, m_currShader->entry))
-            continue;
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < numThreads; ++t)
+    {
+        workers.emplace_back(processUnits);
+    }
+    processUnits();
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
 
-        bool finalize = false;
-        unsigned int size = m_currShader->GetDebugInfoData().m_VISAModules.size();
-        m_pDebugEmitter = m_currShader->GetDebugInfoData().m_pDebugEmitter;
-        std::vector<std::pair<unsigned int, std::pair<llvm::Function*, IGC::VISAModule*>>> sortedVISAModules;
+    // Commit in unit order so the outputs and dumps don't depend on the
+    // number of threads.
+    for (size_t i = 0; i < units.size(); ++i)
+    {
+        commitUnit(units[i], results[i]);
+    }
 
-        // Sort modules in order of their placement in binary
-        DbgDecoder decodedDbg(m_currShader->ProgramOutput()->m_debugDataGenISA);
-        auto getGenOff = [&decodedDbg](std::vector<std::pair<unsigned int, unsigned int>>& data, unsigned int VISAIndex)
-        {
-            unsigned retval = 0;
-            for (auto& item : data)
-            {
-                if (item.first == VISAIndex)
-                {
-                    retval = item.second;
-                }
-            }
-            return retval;
-        };
+    return false;
+}
 
-        auto getLastGenOff = [this, &decodedDbg, &getGenOff](IGC::VISAModule* v)
-        {
-            unsigned int genOff = 0;
-            // Detect last instructions of kernel. This information is absent in
-            // dbg info. So detect is as first instruction of first subroutine - 1.
-            // reloc_index, first sub inst's VISA id
-            std::unordered_map<uint32_t, unsigned int> firstSubVISAIndex;
+void DebugInfoPass::processUnit(CShader* currShader, DwarfDISubprogramCache& DISPCache, UnitResult& result)
+{
+    MetaDataUtils* pMdUtils = currShader->GetMetaDataUtils();
+    if (!isEntryFunc(pMdUtils, currShader->entry))
+        return;
+    result.processed = true;
 
-            for (auto& item : decodedDbg.compiledObjs)
+    bool finalize = false;
+    unsigned int size = currShader->GetDebugInfoData().m_VISAModules.size();
+    IDebugEmitter* pDebugEmitter = currShader->GetDebugInfoData().m_pDebugEmitter;
+    std::vector<std::pair<unsigned int, std::pair<llvm::Function*, IGC::VISAModule*>>> sortedVISAModules;
+
+    // Sort modules in order of their placement in binary
+    DbgDecoder decodedDbg(currShader->ProgramOutput()->m_debugDataGenISA);
+    auto getGenOff = [&decodedDbg](std::vector<std::pair<unsigned int, unsigned int>>& data, unsigned int VISAIndex)
+    {
+        unsigned retval = 0;
+        for (auto& item : data)
+        {
+            if (item.first == VISAIndex)
             {
-                firstSubVISAIndex[item.relocOffset] = item.CISAIndexMap.back().first;
-                for (auto& sub : item.subs)
-                {
-                    auto subStartVISAIndex = sub.startVISAIndex;
-                    if (firstSubVISAIndex[item.relocOffset] > subStartVISAIndex)
-                        firstSubVISAIndex[item.relocOffset] = subStartVISAIndex - 1;
-                }
+                retval = item.second;
             }
+        }
+        return retval;
+    };
 
-            for (auto& item : decodedDbg.compiledObjs)
-            {
-                auto& name = item.kernelName;
-                auto firstInst = (v->GetInstInfoMap()->begin())->first;
-                auto funcName = firstInst->getParent()->getParent()->getName();
-                if (item.subs.size() == 0 && funcName.compare(name) == 0)
-                {
-                    genOff = item.CISAIndexMap.back().second;
-                }
-                else
-                {
-                    if (funcName.compare(name) == 0)
-                    {
-                        genOff = getGenOff(item.CISAIndexMap, firstSubVISAIndex[item.relocOffset]);
-                        break;
-                    }
-                    for (auto& sub : item.subs)
-                    {
-                        auto& subName = sub.name;
-                        if (funcName.compare(subName) == 0)
-                        {
-                            genOff = getGenOff(item.CISAIndexMap, sub.endVISAIndex);
-                            break;
-                        }
-                    }
-                }
+    auto getLastGenOff = [&decodedDbg, &getGenOff](IGC::VISAModule* v)
+    {
+        unsigned int genOff = 0;
+        // Detect last instructions of kernel. This information is absent in
+        // dbg info. So detect is as first instruction of first subroutine - 1.
+        // reloc_index, first sub inst's VISA id
+        std::unordered_map<uint32_t, unsigned int> firstSubVISAIndex;
 
-                if (genOff)
-                    break;
+        for (auto& item : decodedDbg.compiledObjs)
+        {
+            firstSubVISAIndex[item.relocOffset] = item.CISAIndexMap.back().first;
+            for (auto& sub : item.subs)
+            {
+                auto subStartVISAIndex = sub.startVISAIndex;
+                if (firstSubVISAIndex[item.relocOffset] > subStartVISAIndex)
+                    firstSubVISAIndex[item.relocOffset] = subStartVISAIndex - 1;
             }
+        }
 
-            return genOff;
-        };
-
-        auto setType = [&decodedDbg](VISAModule* v)
+        for (auto& item : decodedDbg.compiledObjs)
         {
+            auto& name = item.kernelName;
             auto firstInst = (v->GetInstInfoMap()->begin())->first;
             auto funcName = firstInst->getParent()->getParent()->getName();
-
-            for (auto& item : decodedDbg.compiledObjs)
+            if (item.subs.size() == 0 && funcName.compare(name) == 0)
+            {
+                genOff = item.CISAIndexMap.back().second;
+            }
+            else
             {
-                auto& name = item.kernelName;
                 if (funcName.compare(name) == 0)
                 {
-                    if (item.relocOffset == 0)
-                        v->SetType(VISAModule::ObjectType::KERNEL);
-                    else
-                        v->SetType(VISAModule::ObjectType::STACKCALL_FUNC);
-                    return;
+                    genOff = getGenOff(item.CISAIndexMap, firstSubVISAIndex[item.relocOffset]);
+                    break;
                 }
                 for (auto& sub : item.subs)
                 {
                     auto& subName = sub.name;
                     if (funcName.compare(subName) == 0)
                     {
-                        v->SetType(VISAModule::ObjectType::SUBROUTINE);
-                        return;
+                        genOff = getGenOff(item.CISAIndexMap, sub.endVISAIndex);
+                        break;
                     }
                 }
             }
-        };
 
-        for (auto& m : m_currShader->GetDebugInfoData().m_VISAModules)
-        {
-            setType(m.second);
-            auto lastVISAId = getLastGenOff(m.second);
-            // getLastGenOffset returns zero iff debug info for given function
-            // was not found, skip the function in such case. This can happen,
-            // when the function was optimized away but the definition is still
-            // present inside the module.
-            if (lastVISAId == 0)
-              continue;
-            sortedVISAModules.push_back(std::make_pair(lastVISAId, std::make_pair(m.first, m.second)));
+            if (genOff)
+                break;
         }
 
-        std::sort(sortedVISAModules.begin(), sortedVISAModules.end(),
-            [](std::pair<unsigned int, std::pair<llvm::Function*, IGC::VISAModule*>>& p1,
-                std::pair<unsigned int, std::pair<llvm::Function*, IGC::VISAModule*>>& p2)
-        {
-            return p1.first < p2.first;
-        });
+        return genOff;
+    };
 
-        m_pDebugEmitter->SetDISPCache(&DISPCache);
-        for (auto& m : sortedVISAModules)
+    auto setType = [&decodedDbg](VISAModule* v)
+    {
+        auto firstInst = (v->GetInstInfoMap()->begin())->first;
+        auto funcName = firstInst->getParent()->getParent()->getName();
+
+        for (auto& item : decodedDbg.compiledObjs)
         {
-            m_pDebugEmitter->registerVISA(m.second.second);
+            auto& name = item.kernelName;
+            if (funcName.compare(name) == 0)
+            {
+                if (item.relocOffset == 0)
+                    v->SetType(VISAModule::ObjectType::KERNEL);
+                else
+                    v->SetType(VISAModule::ObjectType::STACKCALL_FUNC);
+                return;
+            }
+            for (auto& sub : item.subs)
+            {
+                auto& subName = sub.name;
+                if (funcName.compare(subName) == 0)
+                {
+                    v->SetType(VISAModule::ObjectType::SUBROUTINE);
+                    return;
+                }
+            }
         }
+    };
 
-        std::vector<llvm::Function*> functions;
-        std::for_each(sortedVISAModules.begin(), sortedVISAModules.end(),
-            [&functions](auto& item) { functions.push_back(item.second.first); });
+    for (auto& m : currShader->GetDebugInfoData().m_VISAModules)
+    {
+        setType(m.second);
+        auto lastVISAId = getLastGenOff(m.second);
+        // getLastGenOffset returns zero iff debug info for given function
+        // was not found, skip the function in such case. This can happen,
+        // when the function was optimized away but the definition is still
+        // present inside the module.
+        if (lastVISAId == 0)
+          continue;
+        sortedVISAModules.push_back(std::make_pair(lastVISAId, std::make_pair(m.first, m.second)));
+    }
 
-        for (auto& m : sortedVISAModules)
-        {
-            m_pDebugEmitter->setCurrentVISA(m.second.second);
+    std::sort(sortedVISAModules.begin(), sortedVISAModules.end(),
+        [](std::pair<unsigned int, std::pair<llvm::Function*, IGC::VISAModule*>>& p1,
+            std::pair<unsigned int, std::pair<llvm::Function*, IGC::VISAModule*>>& p2)
+    {
+        return p1.first < p2.first;
+    });
 
-            if (--size == 0)
-                finalize = true;
+    pDebugEmitter->SetDISPCache(&DISPCache);
+    for (auto& m : sortedVISAModules)
+    {
+        pDebugEmitter->registerVISA(m.second.second);
+    }
 
-            EmitDebugInfo(finalize, &decodedDbg);
-        }
+    for (auto& m : sortedVISAModules)
+    {
+        pDebugEmitter->setCurrentVISA(m.second.second);
 
-        // set VISA dbg info to nullptr to indicate 1-step debug is enabled
-        currShader->ProgramOutput()->m_debugDataGenISASize = 0;
-        currShader->ProgramOutput()->m_debugDataGenISA = nullptr;
+        if (--size == 0)
+            finalize = true;
 
-        if (finalize)
-        {
-            IDebugEmitter::Release(m_pDebugEmitter);
-        }
+        // Only the last emitted ELF ends up in the shader's output
+        result.elf = pDebugEmitter->Finalize(finalize, &decodedDbg);
+        result.errors = pDebugEmitter->getErrors();
+        result.emitted = true;
     }
 
-    return false;
+    if (finalize)
+    {
+        IDebugEmitter::Release(pDebugEmitter);
+    }
 }
 
 static void debugDump(const CShader* Shader, llvm::StringRef Ext,
@@ -254,26 +287,33 @@ static void debugDump(const CShader* Shader, llvm::StringRef Ext,
     fclose(DumpFile);
 }
 
-void DebugInfoPass::EmitDebugInfo(bool finalize, DbgDecoder* decodedDbg)
+void DebugInfoPass::commitUnit(CShader* currShader, UnitResult& result)
 {
-    IGC_ASSERT(m_pDebugEmitter);
+    if (!result.processed)
+        return;
 
-    std::vector<char> buffer = m_pDebugEmitter->Finalize(finalize, decodedDbg);
+    SProgramOutput* pOutput = currShader->ProgramOutput();
+    if (result.emitted)
+    {
+        const std::vector<char>& buffer = result.elf;
 
-    if (IGC_IS_FLAG_ENABLED(ShaderDumpEnable) || IGC_IS_FLAG_ENABLED(ElfDumpEnable))
-        debugDump(m_currShader, "elf", { buffer.data(), buffer.size() });
+        if (IGC_IS_FLAG_ENABLED(ShaderDumpEnable) || IGC_IS_FLAG_ENABLED(ElfDumpEnable))
+            debugDump(currShader, "elf", { buffer.data(), buffer.size() });
 
-    const std::string& DbgErrors = m_pDebugEmitter->getErrors();
-    if (IGC_IS_FLAG_ENABLED(ShaderDumpEnable))
-        debugDump(m_currShader, "dbgerr", { DbgErrors.data(), DbgErrors.size() });
+        if (IGC_IS_FLAG_ENABLED(ShaderDumpEnable))
+            debugDump(currShader, "dbgerr", { result.errors.data(), result.errors.size() });
 
-    void* dbgInfo = IGC::aligned_malloc(buffer.size(), sizeof(void*));
-    if (dbgInfo)
-        memcpy_s(dbgInfo, buffer.size(), buffer.data(), buffer.size());
+        void* dbgInfo = IGC::aligned_malloc(buffer.size(), sizeof(void*));
+        if (dbgInfo)
+            memcpy_s(dbgInfo, buffer.size(), buffer.data(), buffer.size());
+
+        pOutput->m_debugData = dbgInfo;
+        pOutput->m_debugDataSize = dbgInfo ? buffer.size() : 0;
+    }
 
-    SProgramOutput* pOutput = m_currShader->ProgramOutput();
-    pOutput->m_debugData = dbgInfo;
-    pOutput->m_debugDataSize = dbgInfo ? buffer.size() : 0;
+    // set VISA dbg info to nullptr to indicate 1-step debug is enabled
+    pOutput->m_debugDataGenISASize = 0;
+    pOutput->m_debugDataGenISA = nullptr;
 }
 
 // Mark privateBase aka ImplicitArg::PRIVATE_BASE as Output for debugging
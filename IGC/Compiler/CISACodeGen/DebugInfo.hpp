@@ -28,6 +28,7 @@ namespace IGC
 {
     class DbgDecoder;
     class CVariable;
+    class DwarfDISubprogramCache;
 
     class DebugInfoPass : public llvm::ModulePass
     {
@@ -37,10 +38,19 @@ namespace IGC
         virtual ~DebugInfoPass();
 
     private:
+        // Debug info emitted for one shader. Shaders are emitted
+        // independently, possibly on worker threads, and the results are
+        // committed to the shaders' outputs in a fixed order afterwards.
+        struct UnitResult
+        {
+            bool processed = false;
+            bool emitted = false;
+            std::vector<char> elf;
+            std::string errors;
+        };
+
         static char ID;
         CShaderProgram::KernelShaderMap& kernels;
-        CShader* m_currShader = nullptr;
-        IDebugEmitter* m_pDebugEmitter = nullptr;
 
         virtual bool runOnModule(llvm::Module& M) override;
         virtual bool doInitialization(llvm::Module& M) override;
@@ -52,7 +62,8 @@ namespace IGC
             AU.setPreservesAll();
         }
 
-        void EmitDebugInfo(bool, DbgDecoder*);
+        void processUnit(CShader* pShader, DwarfDISubprogramCache& DISPCache, UnitResult& result);
+        void commitUnit(CShader* pShader, UnitResult& result);
     };
 
     class CatchAllLineNumber : public llvm::FunctionPass
@@ -339,6 +339,26 @@ uint EmitPass::DecideInstanceAndSlice(const llvm::BasicBlock& blk, SDAG& sdag, b
             slicing = false;
         }
     }
+
+    // Broadcasts of what this instruction writes are stale afterwards.
+    // Struct results and calls to other functions may write variables
+    // other than m_destination.
+    if (m_destination)
+    {
+        invalidateBroadcastVars(m_destination);
+    }
+    else if (!sdag.m_root->getType()->isVoidTy())
+    {
+        BroadcastVars.clear();
+    }
+    else if (CallInst* CI = dyn_cast<CallInst>(sdag.m_root))
+    {
+        Function* Callee = CI->getCalledFunction();
+        if (!Callee || !Callee->isDeclaration())
+        {
+            BroadcastVars.clear();
+        }
+    }
     return numInstance;
 }
 
@@ -886,6 +906,7 @@ bool EmitPass::runOnFunction(llvm::Function& F)
 
         // remove cached per lane offset variables if any.
         PerLaneOffsetVars.clear();
+        BroadcastVars.clear();
 
         // Variable reuse per-block states.
         VariableReuseAnalysis::EnterBlockRAII EnterBlock(m_VRA, block.bb);
@@ -945,7 +966,8 @@ bool EmitPass::runOnFunction(llvm::Function& F)
                     InitConstant(block.bb);
                     // Insert lifetime start if there are any
                     emitLifetimeStartAtEndOfBB(block.bb);
-                    // insert the de-ssa movs.
+                    // insert the de-ssa movs, which write phi variables.
+                    BroadcastVars.clear();
                     MovPhiSources(block.bb);
                 }
 
@@ -983,6 +1005,7 @@ bool EmitPass::runOnFunction(llvm::Function& F)
             }
         }
     }
+    BroadcastVars.clear();
 
     if (llvmtoVISADump)
     {
@@ -1090,6 +1113,14 @@ bool EmitPass::runOnFunction(llvm::Function& F)
         }
         m_encoder->Compile(compileWithSymbolTable);
         m_pCtx->m_prevShader = m_currShader;
+
+        if (SIMDSpillPrediction* SP = getAnalysisIfAvailable<SIMDSpillPrediction>())
+        {
+            const SProgramOutput* output = m_currShader->ProgramOutput();
+            SP->logOutcome(m_currShader,
+                !output->m_programBin ? "abort-on-spill" :
+                output->m_scratchSpaceUsedBySpills > 0 ? "spill" : "no-spill");
+        }
         // if we are doing stack-call, do the following:
         // - Hard-code a large scratch-space for visa
         if (hasStackCall)
@@ -9272,7 +9303,6 @@ bool EmitPass::validateInlineAsmConstraints(llvm::CallInst* inst, SmallVector<St
 // Example: "mul (M1, 16) $0(0, 0)<1> $1(0, 0)<1;1,0> $2(0, 0)<1;1,0>", "=r,r,r"(float %6, float %7)
 void EmitPass::EmitInlineAsm(llvm::CallInst* inst)
 {
-    std::stringstream& str = m_encoder->GetVISABuilder()->GetAsmTextStream();
     InlineAsm* IA = cast<InlineAsm>(IGCLLVM::getCalledValue(inst));
     string asmStr = IA->getAsmString();
     smallvector<CVariable*, 8> opnds;
@@ -9352,7 +9382,7 @@ void EmitPass::EmitInlineAsm(llvm::CallInst* inst)
         // All uniform variables must be broadcasted if 'rw' constraint was specified
         if (opVar && opVar->IsUniform() && constraint.equals("rw"))
         {
-            opnds[i] = BroadcastIfUniform(opVar);
+            opnds[i] = BroadcastIfUniform(opVar, false, false);
         }
         // Special handling if LLVM replaces a variable with an immediate, we need to insert an extra move
         else if (opVar && opVar->IsImmediate() && !constraint.equals("i"))
@@ -9383,7 +9413,6 @@ void EmitPass::EmitInlineAsm(llvm::CallInst* inst)
         }
     }
 
-    str << endl << "/// Inlined ASM" << endl;
     // Look for variables to replace with the VISA variable
     size_t startPos = 0;
     while (startPos < asmStr.size())
@@ -9415,9 +9444,9 @@ void EmitPass::EmitInlineAsm(llvm::CallInst* inst)
         startPos = varPos + varName.size();
     }
 
-    str << asmStr;
-    if (asmStr.back() != '\n') str << endl;
-    str << "/// End Inlined ASM" << endl << endl;
+    // Only the fragment is parsed; its operands bind to the variables above
+    // through the kernel's symbol table.
+    m_encoder->ParseInlineAsm(asmStr);
 }
 
 CVariable* EmitPass::Mul(CVariable* Src0, CVariable* Src1, const CVariable* DstPrototype)
@@ -11831,7 +11860,36 @@ void EmitPass::JoinSIMD(CVariable* (&tempdst)[N], uint responseLength, SIMDMode
     }
 }
 
-CVariable* EmitPass::BroadcastIfUniform(CVariable* pVar, bool nomask)
+static CVariable* getStorageRoot(CVariable* Var)
+{
+    while (Var->GetAlias())
+    {
+        Var = Var->GetAlias();
+    }
+    return Var;
+}
+
+void EmitPass::invalidateBroadcastVars(CVariable* Var)
+{
+    if (BroadcastVars.empty())
+    {
+        return;
+    }
+    CVariable* Root = getStorageRoot(Var);
+    for (auto I = BroadcastVars.begin(), E = BroadcastVars.end(); I != E; )
+    {
+        auto Cur = I++;
+        if (getStorageRoot(Cur->first.first) == Root)
+        {
+            BroadcastVars.erase(Cur);
+        }
+    }
+}
+
+// Broadcast a uniform variable into a full SIMD-width variable. Unless
+// canReuse is false (the caller writes to the result), a broadcast of the
+// same variable emitted earlier in the block is returned instead.
+CVariable* EmitPass::BroadcastIfUniform(CVariable* pVar, bool nomask, bool canReuse)
 {
     IGC_ASSERT_MESSAGE(nullptr != pVar, "pVar is null");
     VISA_Type VarT = pVar->GetType();
@@ -11842,6 +11900,29 @@ CVariable* EmitPass::BroadcastIfUniform(CVariable* pVar, bool nomask)
     {
         uint32_t width = numLanes(m_currShader->m_SIMDSize);
         uint elts = IsImm ? 1 : pVar->GetNumberElement();
+
+        // Don't reuse if the caller changed the execution size, or if the
+        // current instruction is about to overwrite the variable.
+        bool reuse = canReuse &&
+            IGC_IS_FLAG_ENABLED(EnableUniformBroadcastReuse) &&
+            m_encoder->GetSimdSize() == m_currShader->m_SIMDSize &&
+            !(m_destination && getStorageRoot(m_destination) == getStorageRoot(pVar));
+        auto key = std::make_pair(pVar,
+            (m_encoder->IsSecondHalf() ? 1u : 0u) | ((nomask || m_encoder->IsNoMask()) ? 2u : 0u));
+        if (reuse)
+        {
+            auto I = BroadcastVars.find(key);
+            if (I != BroadcastVars.end() &&
+                I->second.second == m_encoder->GetNumLabelsPlaced())
+            {
+                COMPILER_SHADER_STATS_SET(m_currShader->m_shaderStats,
+                    STATS_UNIFORM_BROADCAST_MOVS_SAVED, elts * (Need64BitEmu ? 2 : 1));
+                COMPILER_SHADER_STATS_SET(m_currShader->m_shaderStats,
+                    STATS_UNIFORM_BROADCAST_BYTES_SAVED, I->second.first->GetSize());
+                return I->second.first;
+            }
+        }
+
         CVariable* pBroadcast =
             m_currShader->GetNewVariable(elts * width, pVar->GetType(),
                 EALIGN_GRF, CName(pVar->getName(), "Broadcast"));
@@ -11882,6 +11963,10 @@ CVariable* EmitPass::BroadcastIfUniform(CVariable* pVar, bool nomask)
             }
         }
 
+        if (reuse)
+        {
+            BroadcastVars[key] = std::make_pair(pBroadcast, m_encoder->GetNumLabelsPlaced());
+        }
         pVar = pBroadcast;
     }
 
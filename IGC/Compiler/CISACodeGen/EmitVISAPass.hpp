@@ -13,6 +13,7 @@ SPDX-License-Identifier: MIT
 #include "ShaderCodeGen.hpp"
 #include "CoalescingEngine.hpp"
 #include "Simd32Profitability.hpp"
+#include "SIMDSpillPrediction.hpp"
 #include "GenCodeGenModule.h"
 #include "VariableReuseAnalysis.hpp"
 #include "Compiler/MetaDataUtilsWrapper.h"
@@ -60,6 +61,9 @@ public:
         AU.addRequired<Simd32ProfitabilityAnalysis>();
         AU.addRequired<CodeGenContextWrapper>();
         AU.addRequired<VariableReuseAnalysis>();
+        // Scheduled only when the SIMDSpillPrediction regkey is set; keep it
+        // alive until the CompileSIMDSize hooks and the outcome log read it.
+        AU.addUsedIfAvailable<SIMDSpillPrediction>();
         AU.setPreservesAll();
     }
 
@@ -459,7 +463,7 @@ public:
     void SplitSIMD(llvm::Instruction* inst, uint numSources, uint headerSize, CVariable* payload, SIMDMode mode, uint half);
     template<size_t N>
     void JoinSIMD(CVariable* (&tempdst)[N], uint responseLength, SIMDMode mode);
-    CVariable* BroadcastIfUniform(CVariable* pVar, bool nomask = false);
+    CVariable* BroadcastIfUniform(CVariable* pVar, bool nomask = false, bool canReuse = true);
     uint DecideInstanceAndSlice(const llvm::BasicBlock& blk, SDAG& sdag, bool& slicing);
     bool IsUndefOrZeroImmediate(const llvm::Value* value);
     inline bool isUndefOrConstInt0(const llvm::Value* val)
@@ -699,6 +703,19 @@ private:
         return Var;
     }
 
+    // Broadcasts of uniform variables emitted so far in the current basic
+    // block. The key is the uniform variable together with the SIMD32 half
+    // (bit 0) and NoMask (bit 1) the broadcast was emitted with; the value
+    // is the broadcast and the number of labels placed when it was emitted.
+    // Later uses in the block reuse the broadcast until the variable is
+    // written again. A label placed in between (control flow emitted within
+    // an instruction) may have skipped the broadcast, so it is not reused.
+    llvm::DenseMap<std::pair<CVariable*, unsigned>, std::pair<CVariable*, uint>> BroadcastVars;
+
+    // Drop the cached broadcasts of Var and of any variable sharing its
+    // storage.
+    void invalidateBroadcastVars(CVariable* Var);
+
     // Emit code in slice starting from (reverse) iterator I. Return the
     // iterator to the next pattern to emit.
     SBasicBlock::reverse_iterator emitInSlice(SBasicBlock& block,
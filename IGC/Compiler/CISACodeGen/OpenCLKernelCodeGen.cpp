@@ -20,6 +20,7 @@ SPDX-License-Identifier: MIT
 #include "Compiler/Optimizer/OpenCLPasses/LocalBuffers/InlineLocalsResolution.hpp"
 #include "Compiler/Optimizer/OpenCLPasses/KernelArgs.hpp"
 #include "Compiler/CISACodeGen/EmitVISAPass.hpp"
+#include "Compiler/CISACodeGen/SIMDSpillPrediction.hpp"
 #include "Compiler/Optimizer/OCLBIUtils.h"
 #include "AdaptorOCL/OCL/KernelAnnotations.hpp"
 #include "common/allocator.h"
@@ -2518,6 +2519,16 @@ namespace IGC
                     return SIMDStatus::SIMD_PERF_FAIL;
                 }
             }
+
+            // bail out if the register pressure predicts a spill and a
+            // narrower SIMD is compiled anyway.
+            SIMDSpillPrediction* SP = EP.getAnalysisIfAvailable<SIMDSpillPrediction>();
+            if (SP && EP.m_canAbortOnSpill && SP->shouldSkip(simdMode))
+            {
+                pCtx->SetSIMDInfo(SIMD_SKIP_SPILL, simdMode, ShaderDispatchMode::NOT_APPLICABLE);
+                SP->logOutcome(this, "skipped");
+                return SIMDStatus::SIMD_PERF_FAIL;
+            }
         }
 
         return SIMDStatus::SIMD_PASS;
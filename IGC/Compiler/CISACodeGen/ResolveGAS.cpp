@@ -14,6 +14,7 @@ SPDX-License-Identifier: MIT
 #include "Compiler/IGCPassSupport.h"
 #include "WrapperLLVM/Utils.h"
 #include "llvm/ADT/PostOrderIterator.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/CallGraph.h"
 #include "llvm/Support/Debug.h"
 #include "llvmWrapper/IR/Constant.h"
@@ -28,16 +29,22 @@ SPDX-License-Identifier: MIT
 #include <llvm/IR/DIBuilder.h>
 #include <llvm/IR/NoFolder.h>
 #include <llvm/Pass.h>
+#include <llvm/Transforms/Utils/Cloning.h>
 #include "common/LLVMWarningsPop.hpp"
 #include "GenISAIntrinsics/GenIntrinsics.h"
 #include "Probe/Assertion.h"
 #include <llvm/IR/PatternMatch.h>
+#include <map>
 
 using namespace llvm;
 using namespace IGC;
 using namespace IGC::IGCMD;
 using namespace llvm::PatternMatch;
 
+STATISTIC(NumGASFuncsSpecialized, "Number of functions cloned per address space of their generic pointer arguments");
+STATISTIC(NumGASArgsLowered, "Number of generic pointer arguments lowered to a specific address space");
+STATISTIC(NumGASAccessesResolved, "Number of generic memory accesses resolved statically across calls");
+
 namespace {
 
     typedef IRBuilder<llvm::NoFolder> BuilderType;
@@ -952,6 +959,8 @@ namespace IGC
         std::vector<Instruction*> m_partiallyLoweredInsts;
 
         bool hasSameOriginAddressSpace(Function* func, unsigned argNo, unsigned& addrSpaceCallSite);
+        void specializeForCallSites(FuncToUpdate& f, std::vector<FuncToUpdate>& clones);
+        void lowerFunctionArgs(Module& M, FuncToUpdate& f);
         void updateFunctionArgs(Function* oldFunc, Function* newFunc, GenericPointerArgs& newArgs);
         void updateAllUsesWithNewFunction(FuncToUpdate& f);
         void FixAddressSpaceInAllUses(Value* ptr, uint newAS, uint oldAS, AddrSpaceCastInst* recoverASC);
@@ -1035,12 +1044,45 @@ void LowerGPCallArg::checkCastToGAS(llvm::Module& M)
 }
 
 
+// Returns the address space a pointer passed as a call argument comes from.
+static unsigned getOriginAddressSpace(Value* V)
+{
+    if (AddrSpaceCastInst* addrSpaceCastInst = dyn_cast<AddrSpaceCastInst>(V))
+        return addrSpaceCastInst->getSrcAddressSpace();
+    return V->getType()->getPointerAddressSpace();
+}
+
+// Returns the number of loads and stores through generic pointers. Each of
+// them needs a dynamic address space check unless it is resolved statically.
+static unsigned countGenericAccesses(Module& M)
+{
+    unsigned count = 0;
+    for (Function& F : M)
+    {
+        for (auto II = inst_begin(&F), IE = inst_end(&F); II != IE; ++II)
+        {
+            Value* Ptr = nullptr;
+            if (LoadInst* LI = dyn_cast<LoadInst>(&*II))
+                Ptr = LI->getPointerOperand();
+            else if (StoreInst* SI = dyn_cast<StoreInst>(&*II))
+                Ptr = SI->getPointerOperand();
+            if (Ptr && Ptr->getType()->getPointerAddressSpace() == ADDRESS_SPACE_GENERIC)
+                count++;
+        }
+    }
+    return count;
+}
+
 bool LowerGPCallArg::runOnModule(llvm::Module& M)
 {
     m_ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
     m_mdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
 
     bool changed = false;
+    // Counting walks the whole module, so only do it when the statistics
+    // are reported.
+    bool countAccesses = llvm::AreStatisticsEnabled();
+    unsigned numGenericAccesses = countAccesses ? countGenericAccesses(M) : 0;
 
     // (1) main work
     if (processCallArg(M))
@@ -1049,6 +1091,13 @@ bool LowerGPCallArg::runOnModule(llvm::Module& M)
     // (2) further static resolution
     if (processGASInst(M))
         changed = true;
+
+    if (countAccesses)
+    {
+        unsigned numGenericAccessesLeft = countGenericAccesses(M);
+        if (numGenericAccessesLeft < numGenericAccesses)
+            NumGASAccessesResolved += numGenericAccesses - numGenericAccessesLeft;
+    }
     return changed;
 }
 
@@ -1114,47 +1163,23 @@ bool LowerGPCallArg::processCallArg(Module& M)
     }
 
     // Step 2: update functions and lower their generic pointer arguments
-    // to their non-generic address space.
+    // to their non-generic address space. Functions called with pointers
+    // from different address spaces are first cloned per address space, so
+    // that each clone can be lowered on its own.
+    std::vector<FuncToUpdate> clonedFuncs;
     for (auto I = funcsToUpdate.rbegin(); I != funcsToUpdate.rend(); I++)
     {
-        Function* F = (*I).oldFunc;
-        GenericPointerArgs& GPArgs = (*I).newArgs;
-        // Determine the unique origin address space of generic pointer args
-        // If it can't be determined, remove it from the function to update
-        GPArgs.erase(std::remove_if(GPArgs.begin(), GPArgs.end(),
-            [this, F](std::pair<unsigned, unsigned>& func) {
-                return hasSameOriginAddressSpace(F, func.first, func.second) == false;
-            }),
-            GPArgs.end());
-
-        if (GPArgs.empty())
-            continue;
+        std::vector<FuncToUpdate> clones;
+        specializeForCallSites(*I, clones);
 
-        // Create the new function body and insert it into the module
-        FunctionType* pFuncType = F->getFunctionType();
-        std::vector<Type*> newParamTypes(pFuncType->param_begin(), pFuncType->param_end());
-        for (auto newArg : GPArgs)
+        lowerFunctionArgs(M, *I);
+        for (auto& C : clones)
         {
-            PointerType* ptrType = PointerType::get(newParamTypes[newArg.first]->getPointerElementType(),
-                newArg.second);
-            newParamTypes[newArg.first] = ptrType;
+            lowerFunctionArgs(M, C);
+            clonedFuncs.push_back(C);
         }
-
-        // Create new function type with explicit and implicit parameter types
-        FunctionType* newFTy = FunctionType::get(F->getReturnType(), newParamTypes, F->isVarArg());
-
-        Function* newFunc = Function::Create(newFTy, F->getLinkage());
-        newFunc->copyAttributesFrom(F);
-        newFunc->setSubprogram(F->getSubprogram());
-        M.getFunctionList().insert(F->getIterator(), newFunc);
-        newFunc->takeName(F);
-        newFunc->getBasicBlockList().splice(newFunc->begin(), F->getBasicBlockList());
-
-        // Update argument list and transfer their uses from old function
-        updateFunctionArgs(F, newFunc, GPArgs);
-
-        (*I).newFunc = newFunc;
     }
+    funcsToUpdate.insert(funcsToUpdate.end(), clonedFuncs.begin(), clonedFuncs.end());
 
     // At this point, there may be functions without generic pointers to be lowered
     funcsToUpdate.erase(std::remove_if(funcsToUpdate.begin(), funcsToUpdate.end(),
@@ -1318,6 +1343,103 @@ bool LowerGPCallArg::processGASInst(Module& M)
     return changed;
 }
 
+// Clones f.oldFunc when its call sites pass generic pointer arguments that
+// originate from different address spaces, e.g. a helper called once with a
+// global and once with a local buffer. Call sites are grouped by the origin
+// address spaces of all generic pointer arguments; the first group keeps the
+// original function and every other group is redirected to its own clone.
+void LowerGPCallArg::specializeForCallSites(FuncToUpdate& f, std::vector<FuncToUpdate>& clones)
+{
+    Function* F = f.oldFunc;
+    if (IGC_IS_FLAG_DISABLED(EnableGASSpecialization) ||
+        F->getInstructionCount() > IGC_GET_FLAG_VALUE(GASSpecializationMaxInsts))
+        return;
+
+    auto oldFuncIter = m_mdUtils->findFunctionsInfoItem(F);
+    if (oldFuncIter == m_mdUtils->end_FunctionsInfo())
+        return;
+
+    // Only direct calls from other functions are redirected.
+    std::map<std::vector<unsigned>, SmallVector<CallInst*, 4>> groups;
+    for (auto U : F->users())
+    {
+        CallInst* CI = dyn_cast<CallInst>(U);
+        if (!CI || CI->getCalledFunction() != F || CI->getFunction() == F)
+            return;
+
+        std::vector<unsigned> addrSpaces;
+        for (auto& arg : f.newArgs)
+            addrSpaces.push_back(getOriginAddressSpace(CI->getArgOperand(arg.first)));
+        groups[addrSpaces].push_back(CI);
+    }
+
+    if (groups.size() < 2 || groups.size() - 1 > IGC_GET_FLAG_VALUE(GASSpecializationMaxClones))
+        return;
+
+    auto& FuncMD = m_ctx->getModuleMetaData()->FuncMD;
+    for (auto GI = std::next(groups.begin()), GE = groups.end(); GI != GE; ++GI)
+    {
+        ValueToValueMapTy VMap;
+        Function* clone = CloneFunction(F, VMap);
+        for (CallInst* CI : GI->second)
+            CI->setCalledFunction(clone);
+
+        m_mdUtils->setFunctionsInfoItem(clone, oldFuncIter->second);
+        auto loc = FuncMD.find(F);
+        if (loc != FuncMD.end())
+        {
+            auto funcInfo = loc->second;
+            FuncMD[clone] = funcInfo;
+        }
+
+        clones.push_back(FuncToUpdate(clone, f.newArgs));
+        NumGASFuncsSpecialized++;
+    }
+}
+
+void LowerGPCallArg::lowerFunctionArgs(Module& M, FuncToUpdate& f)
+{
+    Function* F = f.oldFunc;
+    GenericPointerArgs& GPArgs = f.newArgs;
+    // Determine the unique origin address space of generic pointer args
+    // If it can't be determined, remove it from the function to update
+    GPArgs.erase(std::remove_if(GPArgs.begin(), GPArgs.end(),
+        [this, F](std::pair<unsigned, unsigned>& func) {
+            return hasSameOriginAddressSpace(F, func.first, func.second) == false;
+        }),
+        GPArgs.end());
+
+    if (GPArgs.empty())
+        return;
+
+    // Create the new function body and insert it into the module
+    FunctionType* pFuncType = F->getFunctionType();
+    std::vector<Type*> newParamTypes(pFuncType->param_begin(), pFuncType->param_end());
+    for (auto newArg : GPArgs)
+    {
+        PointerType* ptrType = PointerType::get(newParamTypes[newArg.first]->getPointerElementType(),
+            newArg.second);
+        newParamTypes[newArg.first] = ptrType;
+        if (newArg.second != ADDRESS_SPACE_GENERIC)
+            NumGASArgsLowered++;
+    }
+
+    // Create new function type with explicit and implicit parameter types
+    FunctionType* newFTy = FunctionType::get(F->getReturnType(), newParamTypes, F->isVarArg());
+
+    Function* newFunc = Function::Create(newFTy, F->getLinkage());
+    newFunc->copyAttributesFrom(F);
+    newFunc->setSubprogram(F->getSubprogram());
+    M.getFunctionList().insert(F->getIterator(), newFunc);
+    newFunc->takeName(F);
+    newFunc->getBasicBlockList().splice(newFunc->begin(), F->getBasicBlockList());
+
+    // Update argument list and transfer their uses from old function
+    updateFunctionArgs(F, newFunc, GPArgs);
+
+    f.newFunc = newFunc;
+}
+
 bool LowerGPCallArg::hasSameOriginAddressSpace(Function* func, unsigned argNo, unsigned &addrSpaceCallSite)
 {
     unsigned verifiedCallSites = 0;
@@ -1331,12 +1453,7 @@ bool LowerGPCallArg::hasSameOriginAddressSpace(Function* func, unsigned argNo, u
         if (!V->getType()->isPointerTy())
             continue;
 
-        unsigned addrSpaceCurrentCallSite = 0;
-
-        if (AddrSpaceCastInst* addrSpaceCastInst = dyn_cast<AddrSpaceCastInst>(V))
-            addrSpaceCurrentCallSite = addrSpaceCastInst->getSrcAddressSpace();
-        else
-            addrSpaceCurrentCallSite = (dyn_cast<PointerType>(V->getType()))->getAddressSpace();
+        unsigned addrSpaceCurrentCallSite = getOriginAddressSpace(V);
 
         if (verifiedCallSites == 0)
         {
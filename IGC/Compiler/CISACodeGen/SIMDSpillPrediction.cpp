@@ -0,0 +1,178 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "Compiler/CISACodeGen/SIMDSpillPrediction.hpp"
+#include "Compiler/CISACodeGen/GenCodeGenModule.h"
+#include "Compiler/CISACodeGen/RegisterEstimator.hpp"
+#include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
+#include "Compiler/CISACodeGen/WIAnalysis.hpp"
+#include "Compiler/IGCPassSupport.h"
+#include "common/debug/Debug.hpp"
+#include "common/igc_regkeys.hpp"
+#include "common/Stats.hpp"
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+#include "Probe/Assertion.h"
+
+using namespace llvm;
+using namespace IGC;
+
+// Register pass to igc-opt
+#define PASS_FLAG "simd-spill-prediction"
+#define PASS_DESCRIPTION "Predict register pressure per SIMD width"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS true
+IGC_INITIALIZE_PASS_BEGIN(SIMDSpillPrediction, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(WIAnalysis)
+IGC_INITIALIZE_PASS_DEPENDENCY(RegisterEstimator)
+IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_END(SIMDSpillPrediction, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+char SIMDSpillPrediction::ID = 0;
+
+static unsigned getSIMDIndex(SIMDMode simdMode)
+{
+    switch (simdMode)
+    {
+    case SIMDMode::SIMD8:  return 0;
+    case SIMDMode::SIMD16: return 1;
+    case SIMDMode::SIMD32: return 2;
+    default:
+        IGC_ASSERT_MESSAGE(0, "unexpected SIMD mode");
+        return 0;
+    }
+}
+
+SIMDSpillPrediction::SIMDSpillPrediction() : FunctionPass(ID)
+{
+    initializeSIMDSpillPredictionPass(*PassRegistry::getPassRegistry());
+}
+
+void SIMDSpillPrediction::getAnalysisUsage(AnalysisUsage& AU) const
+{
+    AU.setPreservesAll();
+    // WIAnalysis goes first so that RegisterEstimator can count uniform
+    // values once instead of once per lane.
+    AU.addRequired<WIAnalysis>();
+    AU.addRequired<RegisterEstimator>();
+    AU.addRequired<CodeGenContextWrapper>();
+}
+
+bool SIMDSpillPrediction::runOnFunction(Function& F)
+{
+    m_F = &F;
+    m_hasPrediction = false;
+
+    // The estimate is per function; a group compiled together with its
+    // callees shares the registers in ways it can't see.
+    auto FGA = getAnalysisIfAvailable<GenXFunctionGroupAnalysis>();
+    if (FGA && FGA->getGroup(&F) &&
+        (!FGA->getGroup(&F)->isSingle() || !FGA->isGroupHead(&F)))
+    {
+        return false;
+    }
+
+    CodeGenContext* ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+    RegisterEstimator& RPE = getAnalysis<RegisterEstimator>();
+
+    // The pass runs after the TIME_CG_Analysis counter pass so that it stays
+    // in EmitPass's function pass manager; account for it here instead.
+    COMPILER_TIME_START(ctx, TIME_CG_Analysis);
+
+    uint32_t maxLive[3] = {};
+    if (!RPE.hasNoGRFPressure())
+    {
+        RPE.calculate();
+        for (BasicBlock& BB : F)
+        {
+            maxLive[0] = std::max(maxLive[0], RPE.getMaxLiveGRFAtBB(&BB, 8));
+            maxLive[1] = std::max(maxLive[1], RPE.getMaxLiveGRFAtBB(&BB, 16));
+            maxLive[2] = std::max(maxLive[2], RPE.getMaxLiveGRFAtBB(&BB, 32));
+        }
+    }
+
+    // RegisterEstimator counts 32-byte registers.
+    const uint32_t grfSize = ctx->platform.getGRFSize();
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        m_estimatedGRF[i] = (maxLive[i] * GRF_SIZE_IN_BYTE + grfSize - 1) / grfSize;
+    }
+    m_numGRF = ctx->getNumGRFPerThread();
+    m_hasPrediction = true;
+
+    COMPILER_TIME_END(ctx, TIME_CG_Analysis);
+    return false;
+}
+
+uint32_t SIMDSpillPrediction::getEstimatedGRF(SIMDMode simdMode) const
+{
+    return m_estimatedGRF[getSIMDIndex(simdMode)];
+}
+
+bool SIMDSpillPrediction::isLikelyToSpill(SIMDMode simdMode) const
+{
+    if (!m_hasPrediction)
+    {
+        return false;
+    }
+    uint64_t threshold = (uint64_t)m_numGRF * IGC_GET_FLAG_VALUE(SIMDSpillPredictionThreshold);
+    return (uint64_t)getEstimatedGRF(simdMode) * 100 > threshold;
+}
+
+bool SIMDSpillPrediction::shouldSkip(SIMDMode simdMode) const
+{
+    return IGC_GET_FLAG_VALUE(SIMDSpillPrediction) >= 2 && isLikelyToSpill(simdMode);
+}
+
+void SIMDSpillPrediction::print(raw_ostream& OS, const Module*) const
+{
+    if (!m_hasPrediction)
+    {
+        return;
+    }
+    OS << "SIMD spill prediction for " << m_F->getName()
+        << " (" << m_numGRF << " GRFs per thread):\n";
+    for (SIMDMode simdMode : { SIMDMode::SIMD8, SIMDMode::SIMD16, SIMDMode::SIMD32 })
+    {
+        OS << "  SIMD" << numLanes(simdMode) << ": "
+            << getEstimatedGRF(simdMode) << " GRFs, "
+            << (isLikelyToSpill(simdMode) ? "spill" : "no-spill")
+            << (shouldSkip(simdMode) ? ", skipped" : "") << "\n";
+    }
+}
+
+void SIMDSpillPrediction::logOutcome(const CShader* shader, const char* outcome) const
+{
+    if (!m_hasPrediction || shader->entry != m_F)
+    {
+        return;
+    }
+
+    SIMDMode simdMode = shader->m_dispatchSize;
+    std::stringstream logFile;
+    logFile << IGC::Debug::GetShaderOutputFolder() << "SIMDSpillPrediction.csv";
+
+    // Kernels may be compiled on several threads.
+    static std::mutex logMutex;
+    std::lock_guard<std::mutex> lock(logMutex);
+
+    std::ofstream logStream(logFile.str(), std::ios::app);
+    if (logStream.tellp() == 0)
+    {
+        logStream << "kernel,simd,estimatedGRF,numGRF,predicted,outcome\n";
+    }
+    logStream << m_F->getName().str() << ","
+        << numLanes(simdMode) << ","
+        << getEstimatedGRF(simdMode) << ","
+        << m_numGRF << ","
+        << (isLikelyToSpill(simdMode) ? "spill" : "no-spill") << ","
+        << outcome << "\n";
+}
@@ -0,0 +1,73 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include "common/LLVMWarningsPush.hpp"
+#include "llvm/Pass.h"
+#include "common/LLVMWarningsPop.hpp"
+
+#include "Compiler/CodeGenPublic.h"
+
+namespace IGC
+{
+    class CShader;
+
+    /// @brief  Predicts, before codegen, the register pressure of each SIMD
+    /// width and whether compiling the function at that width is likely to
+    /// spill. The prediction takes the maximum live GRFs found by
+    /// RegisterEstimator and compares it with the GRFs available per thread.
+    ///
+    /// The pass is scheduled right before EmitPass when SIMDSpillPrediction
+    /// is set; EmitPass keeps it alive with addUsedIfAvailable, and EmitPass
+    /// and the CompileSIMDSize hooks query it through getAnalysisIfAvailable.
+    /// The predictions are appended together with
+    /// the actual compile outcome to SIMDSpillPrediction.csv in the shader
+    /// output folder so that the model can be tuned on real workloads.
+    class SIMDSpillPrediction : public llvm::FunctionPass
+    {
+    public:
+        static char ID;
+
+        SIMDSpillPrediction();
+
+        virtual llvm::StringRef getPassName() const override
+        {
+            return "SIMDSpillPrediction";
+        }
+
+        virtual bool runOnFunction(llvm::Function& F) override;
+
+        virtual void getAnalysisUsage(llvm::AnalysisUsage& AU) const override;
+
+        virtual void print(llvm::raw_ostream& OS, const llvm::Module* = nullptr) const override;
+
+        // False if no prediction was made for the function, e.g. because it
+        // is compiled together with its callees.
+        bool hasPrediction() const { return m_hasPrediction; }
+
+        uint32_t getEstimatedGRF(SIMDMode simdMode) const;
+        bool isLikelyToSpill(SIMDMode simdMode) const;
+
+        // True if the width should not be compiled at all. Callers must only
+        // ask for widths that another width can fall back from.
+        bool shouldSkip(SIMDMode simdMode) const;
+
+        // Appends the prediction for the shader's SIMD size together with the
+        // outcome of its compilation to the prediction log.
+        void logOutcome(const CShader* shader, const char* outcome) const;
+
+    private:
+        llvm::Function* m_F = nullptr;
+        bool m_hasPrediction = false;
+        uint32_t m_numGRF = 0;
+        // Estimated GRFs for SIMD8, SIMD16 and SIMD32.
+        uint32_t m_estimatedGRF[3] = {};
+    };
+
+} // namespace IGC
@@ -57,6 +57,7 @@ SPDX-License-Identifier: MIT
 #include "Compiler/CISACodeGen/LowerGEPForPrivMem.hpp"
 #include "Compiler/CISACodeGen/POSH_RemoveNonPositionOutput.h"
 #include "Compiler/CISACodeGen/RegisterEstimator.hpp"
+#include "Compiler/CISACodeGen/SIMDSpillPrediction.hpp"
 #include "Compiler/CISACodeGen/ComputeShaderLowering.hpp"
 #include "Compiler/CISACodeGen/CrossPhaseConstProp.hpp"
 
@@ -342,6 +343,13 @@ static void AddAnalysisPasses(CodeGenContext& ctx, IGCPassManager& mpm)
 
     mpm.add(createTimeStatsCounterPass(&ctx, TIME_CG_Analysis, STATS_COUNTER_END));
 
+    // Predict which SIMD widths are likely to spill. It goes right before
+    // EmitPass so that the prediction is still available there.
+    if (IGC_GET_FLAG_VALUE(SIMDSpillPrediction) != 0)
+    {
+        mpm.add(new SIMDSpillPrediction());
+    }
+
     COMPILER_TIME_END(&ctx, TIME_CG_Add_Analysis_Passes);
 } // AddAnalysisPasses
 
@@ -503,6 +511,13 @@ static void AddLegalizationPasses(CodeGenContext& ctx, IGCPassManager& mpm, PSSi
         mpm.add(llvm::createAggressiveDCEPass());
         // TODO: we probably should be running other passes on the result
 
+        // Adjacent emulated operations on the same operands unpack them the
+        // same way once inlined; share that work.
+        if ((theEmuKind & EmuKind::EMU_DP) && IGC_IS_FLAG_ENABLED(EnableEmulationCSE))
+        {
+            mpm.add(llvm::createEarlyCSEPass());
+        }
+
         if (IGC_GET_FLAG_VALUE(FunctionControl) != FLAG_FCALL_FORCE_INLINE)
         {
             mpm.add(new PurgeMetaDataUtils());
@@ -900,6 +915,10 @@ static void AddCodeGenPasses(
     PSSignature* pSignature = nullptr)
 {
     // Generate CISA
+    // The analyses EmitPass requires are scheduled once per function ahead of
+    // the first EmitPass and are shared by all the SIMD variants since
+    // EmitPass preserves everything. Don't add module passes or passes that
+    // change the IR between the variants, which would make them recomputed.
     COMPILER_TIME_START(&ctx, TIME_CG_Add_CodeGen_Passes);
     Passes.add(new EmitPass(shaders, simdMode, canAbortOnSpill, shaderMode, pSignature));
     COMPILER_TIME_END(&ctx, TIME_CG_Add_CodeGen_Passes);
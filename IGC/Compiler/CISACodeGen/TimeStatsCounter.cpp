@@ -47,11 +47,55 @@ namespace {
             type = STATS_COUNTER_LLVM_PASS;
         }
 
+        void getAnalysisUsage(AnalysisUsage& AU) const override
+        {
+            AU.setPreservesAll();
+        }
+
         bool runOnModule(Module&) override;
 
     private:
 
     };
+
+    // Function-level flavor of the per-pass counter, used around function
+    // passes so that the counters don't split the function pass manager. A
+    // module pass between two function passes makes every function analysis
+    // be recomputed for the second one, e.g. for each SIMD variant of EmitPass.
+    class TimeStatsFunctionCounter : public FunctionPass {
+        CodeGenContext* ctx;
+        std::string igcPass;
+        TimeStatsCounterStartEndMode mode;
+
+    public:
+        static char ID;
+
+        TimeStatsFunctionCounter(CodeGenContext* _ctx, std::string _igcPass, TimeStatsCounterStartEndMode _mode)
+            : FunctionPass(ID), ctx(_ctx), igcPass(std::move(_igcPass)), mode(_mode) {}
+
+        void getAnalysisUsage(AnalysisUsage& AU) const override
+        {
+            AU.setPreservesAll();
+        }
+
+        StringRef getPassName() const override
+        {
+            return "TimeStatsFunctionCounter";
+        }
+
+        bool runOnFunction(Function&) override
+        {
+            if (mode == STATS_COUNTER_START)
+            {
+                COMPILER_TIME_PASS_START(ctx, igcPass);
+            }
+            else
+            {
+                COMPILER_TIME_PASS_END(ctx, igcPass);
+            }
+            return false;
+        }
+    };
 } // End anonymous namespace
 
 ModulePass* IGC::createTimeStatsCounterPass(CodeGenContext* _ctx, COMPILE_TIME_INTERVALS _interval, TimeStatsCounterStartEndMode _mode) {
@@ -63,7 +107,13 @@ ModulePass* IGC::createTimeStatsIGCPass(CodeGenContext* _ctx, std::string _igcPa
     return new TimeStatsCounter(_ctx, _igcPass, _mode);
 }
 
+FunctionPass* IGC::createTimeStatsIGCFunctionPass(CodeGenContext* _ctx, std::string _igcPass, TimeStatsCounterStartEndMode _mode)
+{
+    return new TimeStatsFunctionCounter(_ctx, _igcPass, _mode);
+}
+
 char TimeStatsCounter::ID = 0;
+char TimeStatsFunctionCounter::ID = 0;
 
 #define PASS_FLAG     "time-stats-counter"
 #define PASS_DESC     "TimeStatsCounter Start/Stop"
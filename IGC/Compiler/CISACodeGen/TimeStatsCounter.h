@@ -30,5 +30,6 @@ namespace IGC {
 
     llvm::ModulePass* createTimeStatsCounterPass(CodeGenContext* _ctx, COMPILE_TIME_INTERVALS _interval, TimeStatsCounterStartEndMode _mode);
     llvm::ModulePass* createTimeStatsIGCPass(CodeGenContext* _ctx, std::string _igcPass, TimeStatsCounterStartEndMode _mode);
+    llvm::FunctionPass* createTimeStatsIGCFunctionPass(CodeGenContext* _ctx, std::string _igcPass, TimeStatsCounterStartEndMode _mode);
     void initializeTimeStatsCounterPass(llvm::PassRegistry&);
 } // End namespace IGC
@@ -1164,6 +1164,21 @@ namespace IGC
         this->oclWarningMessage << "\n";
     }
 
+    void CodeGenContext::EmitCompileTimeFallbacks(const char* kernelName, uint32_t fallbacks)
+    {
+        if (fallbacks == 0)
+            return;
+
+        std::stringstream msg;
+        msg << "compile-time budget exceeded for " << kernelName << ", fallbacks used:";
+        for (uint32_t i = 0; i < (uint32_t)vISA::CompileTimeBudget::Phase::NUM_PHASES; i++)
+        {
+            if (fallbacks & (1u << i))
+                msg << " " << vISA::CompileTimeBudget::getPhaseName((vISA::CompileTimeBudget::Phase)i);
+        }
+        EmitWarning(msg.str().c_str());
+    }
+
     CompOptions& CodeGenContext::getCompilerOption()
     {
         return getModuleMetaData()->compOpt;
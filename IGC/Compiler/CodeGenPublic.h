@@ -30,6 +30,7 @@ SPDX-License-Identifier: MIT
 #include "Compiler/MetaDataApi/IGCMetaDataHelper.h"
 #include "Compiler/CodeGenContextWrapper.hpp"
 #include "visa/include/RelocationInfo.h"
+#include "visa/include/CompileTimeBudget.h"
 #include "ZEBinWriter/zebin/source/autogen/ZEInfo.hpp"
 
 #include "../AdaptorOCL/OCL/sp/spp_g8.h"
@@ -1031,6 +1032,9 @@ namespace IGC
         void EmitError(std::ostream &OS, const char* errorstr, const llvm::Value *context) const;
         void EmitError(const char* errorstr, const llvm::Value *context);
         void EmitWarning(const char* warningstr);
+        // Emit a warning listing vISA phases that fell back to a cheaper
+        // algorithm because the compile-time budget ran out.
+        void EmitCompileTimeFallbacks(const char* kernelName, uint32_t fallbacks);
         inline bool HasError() const { return !this->oclErrorMessage.str().empty(); }
         inline bool HasWarning() const { return !this->oclWarningMessage.str().empty(); }
         inline const std::string GetWarning() { return this->oclWarningMessage.str(); }
@@ -0,0 +1,42 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "Compiler/ConvertIGCMetadata.h"
+#include "Compiler/IGCPassSupport.h"
+#include "common/MDFrameWork.h"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/IR/Module.h>
+#include "common/LLVMWarningsPop.hpp"
+
+using namespace llvm;
+using namespace IGC;
+
+// Register pass to igc-opt
+#define PASS_FLAG "igc-convert-metadata"
+#define PASS_DESCRIPTION "Convert IGC metadata between binary and readable form"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+IGC_INITIALIZE_PASS_BEGIN(ConvertIGCMetadata, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_END(ConvertIGCMetadata, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+char ConvertIGCMetadata::ID = 0;
+
+ConvertIGCMetadata::ConvertIGCMetadata() : ModulePass(ID)
+{
+    initializeConvertIGCMetadataPass(*PassRegistry::getPassRegistry());
+}
+
+bool ConvertIGCMetadata::runOnModule(Module& M)
+{
+    bool isBinary = M.getNamedMetadata("IGCMetadataBlob") != nullptr;
+    ModuleMetaData moduleMD;
+    deserialize(moduleMD, &M);
+    serialize(moduleMD, &M, isBinary ? MDSerializationFormat::Readable : MDSerializationFormat::Binary);
+    return true;
+}
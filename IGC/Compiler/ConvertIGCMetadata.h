@@ -0,0 +1,38 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Pass.h>
+#include "common/LLVMWarningsPop.hpp"
+
+namespace IGC
+{
+    // This pass rewrites the ModuleMetaData stored in the module in the other
+    // serialization format: the readable !IGCMetadata becomes the binary blob
+    // and the blob becomes !IGCMetadata. Useful in igc opt to check that
+    // metadata survives a round trip through the blob.
+    class ConvertIGCMetadata : public llvm::ModulePass
+    {
+    public:
+        static char ID;
+
+        ConvertIGCMetadata();
+
+        ~ConvertIGCMetadata() {}
+
+        bool runOnModule(llvm::Module& M) override;
+
+        virtual llvm::StringRef getPassName() const override
+        {
+            return "ConvertIGCMetadata";
+        }
+    };
+
+} // namespace IGC
@@ -32,6 +32,7 @@ void initializeCodeGenContextWrapperPass(llvm::PassRegistry&);
 void initializeCodeGenPatternMatchPass(llvm::PassRegistry&);
 void initializeCollectGeometryShaderPropertiesPass(llvm::PassRegistry&);
 void initializeConstantCoalescingPass(llvm::PassRegistry&);
+void initializeConvertIGCMetadataPass(llvm::PassRegistry&);
 void initializeCorrectlyRoundedDivSqrtPass(llvm::PassRegistry&);
 void initializeCustomSafeOptPassPass(llvm::PassRegistry&);
 void initializeCustomUnsafeOptPassPass(llvm::PassRegistry&);
@@ -106,6 +107,7 @@ void initializeRewriteLocalSizePass(llvm::PassRegistry&);
 void initializeSampleCmpToDiscardPass(llvm::PassRegistry&);
 void initializeScalarizeFunctionPass(llvm::PassRegistry&);
 void initializeSimd32ProfitabilityAnalysisPass(llvm::PassRegistry&);
+void initializeSIMDSpillPredictionPass(llvm::PassRegistry&);
 void initializeSetFastMathFlagsPass(llvm::PassRegistry&);
 void initializeSPIRMetaDataTranslationPass(llvm::PassRegistry&);
 void initializeSubGroupFuncsResolutionPass(llvm::PassRegistry&);
@@ -14,6 +14,8 @@ SPDX-License-Identifier: MIT
 #include "Compiler/IGCPassSupport.h"
 #include "Compiler/CISACodeGen/GenCodeGenModule.h"
 #include "Compiler/CISACodeGen/LowerGEPForPrivMem.hpp"
+#include "Compiler/CISACodeGen/helper.h"
+#include "common/debug/Debug.hpp"
 #include "llvmWrapper/IR/DerivedTypes.h"
 #include "common/LLVMWarningsPush.hpp"
 #include "llvmWrapper/IR/DerivedTypes.h"
@@ -25,6 +27,8 @@ SPDX-License-Identifier: MIT
 #include "llvm/IR/Dominators.h"
 #include "common/LLVMWarningsPop.hpp"
 #include "Probe/Assertion.h"
+#include <fstream>
+#include <sstream>
 
 using namespace llvm;
 using namespace IGC;
@@ -77,6 +81,9 @@ namespace IGC {
 
         static bool testTransposedMemory(const Type* pTmpType, const Type* const pTypeOfAccessedObject, uint64_t tmpAllocaSize, const uint64_t bufferSizeLimit);
 
+        /// @brief  Appends the memory and layout chosen for the alloca to the opt report.
+        void reportLayout(llvm::AllocaInst* pAI, const char* memory, bool interleaved, unsigned int numBlockReads);
+
         /// @brief  The module level alloca information
         ModuleAllocaAnalysis* m_ModAllocaInfo;
 
@@ -338,6 +345,110 @@ static void sinkAllocaSingleUse(SmallVectorImpl<AllocaInst*>& Allocas) {
     }
 }
 
+// Returns true if V is known to have the same value on all SIMD lanes: a
+// constant, an explicit kernel argument or arithmetic on such values.
+static bool isUniformValue(const Value* V, unsigned numUniformArgs, unsigned depth = 0)
+{
+    if (isa<Constant>(V))
+    {
+        return true;
+    }
+    if (const Argument* arg = dyn_cast<Argument>(V))
+    {
+        return arg->getArgNo() < numUniformArgs;
+    }
+    const Instruction* inst = dyn_cast<Instruction>(V);
+    if (!inst || depth > 8 || !(isa<BinaryOperator>(inst) || isa<CastInst>(inst)))
+    {
+        return false;
+    }
+    for (const Value* op : inst->operands())
+    {
+        if (!isUniformValue(op, numUniformArgs, depth + 1))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Decides whether a stateless alloca should be interleaved across SIMD lanes.
+// Each access is weighted by the messages it needs. Both layouts scatter an
+// access over the lanes, and the interleaved layout may split a vector access
+// into one message per element. Only a scalar load at a uniform index gets
+// cheaper, and only when it can be lowered to a block read. A tie keeps the
+// per-lane layout.
+static bool isInterleavedLayoutProfitable(AllocaInst* pAI, Type* pTypeOfAccessedObject, unsigned numUniformArgs)
+{
+    const unsigned scatteredCost = 2;
+    const unsigned contiguousCost = 1;
+    const bool vectorIO = pTypeOfAccessedObject->isVectorTy();
+    const unsigned elementSize = (unsigned)pAI->getModule()->getDataLayout().getTypeAllocSize(pTypeOfAccessedObject);
+    const bool blockReads = IGC_IS_FLAG_ENABLED(EnablePrivateMemoryBlockRead) &&
+        pAI->getMetadata("uniform") == nullptr && (elementSize == 4 || elementSize == 8);
+    unsigned interleavedCost = 0;
+    unsigned perLaneCost = 0;
+
+    SmallVector<std::pair<Value*, bool>, 16> worklist;
+    worklist.push_back(std::make_pair(pAI, true));
+    while (!worklist.empty())
+    {
+        Value* V = worklist.back().first;
+        bool uniformIdx = worklist.back().second;
+        worklist.pop_back();
+        for (User* U : V->users())
+        {
+            if (GetElementPtrInst* pGEP = dyn_cast<GetElementPtrInst>(U))
+            {
+                bool uniformGEP = uniformIdx;
+                for (Value* idx : pGEP->indices())
+                {
+                    uniformGEP &= isUniformValue(idx, numUniformArgs);
+                }
+                worklist.push_back(std::make_pair(pGEP, uniformGEP));
+            }
+            else if (isa<BitCastInst>(U))
+            {
+                worklist.push_back(std::make_pair(U, uniformIdx));
+            }
+            else if (isa<LoadInst>(U) || isa<StoreInst>(U))
+            {
+                Type* accessType = isa<LoadInst>(U) ? U->getType() : cast<StoreInst>(U)->getValueOperand()->getType();
+                if (blockReads && uniformIdx && isa<LoadInst>(U) && !accessType->isVectorTy())
+                {
+                    interleavedCost += contiguousCost;
+                }
+                else if (!vectorIO && accessType->isVectorTy())
+                {
+                    interleavedCost += (unsigned)cast<IGCLLVM::FixedVectorType>(accessType)->getNumElements() * scatteredCost;
+                }
+                else
+                {
+                    interleavedCost += scatteredCost;
+                }
+                perLaneCost += scatteredCost;
+            }
+        }
+    }
+    return interleavedCost < perLaneCost;
+}
+
+// Scratch memory keeps interleaving every alloca it can. In stateless memory
+// the cost model decides, so allocas stay per lane unless block reads make
+// the interleaved layout cheaper.
+static bool useInterleavedLayout(AllocaInst* pAI, Type* pTypeOfAccessedObject, unsigned numUniformArgs, bool stateless)
+{
+    switch (IGC_GET_FLAG_VALUE(PrivateMemoryLayout))
+    {
+    case 1:
+        return false;
+    case 2:
+        return true;
+    default:
+        return !stateless || isInterleavedLayoutProfitable(pAI, pTypeOfAccessedObject, numUniformArgs);
+    }
+}
+
 class TransposeHelperPrivateMem : public TransposeHelper
 {
 public:
@@ -345,11 +456,18 @@ public:
     Value* base;
     unsigned int elementSize;
     bool vectorIO;
-    TransposeHelperPrivateMem(Value* b, Value* size, unsigned int eltSize, bool vectorType) : TransposeHelper(vectorType) {
+    unsigned int addrSpace;
+    // Lane-independent part of base. When set, scalar loads with a uniform
+    // index are lowered to SIMD block reads from it.
+    Value* blockReadBase = nullptr;
+    unsigned int numUniformArgs = 0;
+    unsigned int numBlockReads = 0;
+    TransposeHelperPrivateMem(Value* b, Value* size, unsigned int eltSize, bool vectorType, unsigned int AS) : TransposeHelper(vectorType) {
         simdSize = size;
         base = b;
         elementSize = eltSize;
         vectorIO = vectorType;
+        addrSpace = AS;
     }
     void handleLoadInst(LoadInst* pLoad, Value* pScalarizedIdx)
     {
@@ -362,30 +480,50 @@ public:
         }
         Value* eltSize = IRB.getInt32(elementSize);
         Value* stride = IRB.CreateMul(simdSize, eltSize);
-        Value* address = IRB.CreateMul(pScalarizedIdx, stride);
-        address = IRB.CreateAdd(base, address);
+        Value* offset = IRB.CreateZExt(IRB.CreateMul(pScalarizedIdx, stride), base->getType());
+        Value* address = IRB.CreateAdd(base, offset);
         IRB.SetInsertPoint(pLoad);
         if (!vectorIO && pLoad->getType()->isVectorTy())
         {
             Type* scalarType = pLoad->getPointerOperand()->getType()->getPointerElementType()->getScalarType();
             IGC_ASSERT(nullptr != scalarType);
-            Type* scalarptrTy = PointerType::get(scalarType, pLoad->getPointerAddressSpace());
+            Type* scalarptrTy = PointerType::get(scalarType, addrSpace);
             IGC_ASSERT(scalarType->getPrimitiveSizeInBits() / 8 == elementSize);
             Value* vec = UndefValue::get(pLoad->getType());
+            Value* addressStride = IRB.CreateZExt(stride, base->getType());
             auto pLoadVT = cast<IGCLLVM::FixedVectorType>(pLoad->getType());
             for (unsigned i = 0, e = (unsigned)pLoadVT->getNumElements(); i < e; ++i)
             {
                 Value* ptr = IRB.CreateIntToPtr(address, scalarptrTy);
                 Value* v = IRB.CreateLoad(ptr);
                 vec = IRB.CreateInsertElement(vec, v, IRB.getInt32(i));
-                address = IRB.CreateAdd(address, stride);
+                address = IRB.CreateAdd(address, addressStride);
             }
             pLoad->replaceAllUsesWith(vec);
             pLoad->eraseFromParent();
         }
+        else if (blockReadBase && !pLoad->getType()->isVectorTy() &&
+            (elementSize == 4 || elementSize == 8) &&
+            isUniformValue(pScalarizedIdx, numUniformArgs))
+        {
+            // All lanes read the same element, which is laid out contiguously
+            // across the lanes, so a single block read fetches it for all of
+            // them. Reads past inactive lanes stay within the thread's buffer.
+            Type* blockType = IRB.getIntNTy(elementSize * 8);
+            Value* blockAddress = IRB.CreateAdd(blockReadBase, offset);
+            Value* ptr = IRB.CreateIntToPtr(blockAddress, PointerType::get(blockType, addrSpace));
+            Type* types[] = { blockType, ptr->getType() };
+            Function* simdBlockReadFunc = GenISAIntrinsic::getDeclaration(
+                pLoad->getModule(), GenISAIntrinsic::GenISA_simdBlockRead, types);
+            Value* v = IRB.CreateCall(simdBlockReadFunc, ptr);
+            v = IRB.CreateBitCast(v, pLoad->getType());
+            pLoad->replaceAllUsesWith(v);
+            pLoad->eraseFromParent();
+            numBlockReads++;
+        }
         else
         {
-            Value* ptr = IRB.CreateIntToPtr(address, pLoad->getPointerOperand()->getType());
+            Value* ptr = IRB.CreateIntToPtr(address, PointerType::get(pLoad->getType(), addrSpace));
             pLoad->setOperand(0, ptr);
         }
     }
@@ -400,29 +538,32 @@ public:
         }
         Value* eltSize = IRB.getInt32(elementSize);
         Value* stride = IRB.CreateMul(simdSize, eltSize);
-        Value* address = IRB.CreateMul(pScalarizedIdx, stride);
-        address = IRB.CreateAdd(base, address);
+        Value* offset = IRB.CreateZExt(IRB.CreateMul(pScalarizedIdx, stride), base->getType());
+        Value* address = IRB.CreateAdd(base, offset);
         IRB.SetInsertPoint(pStore);
+        // Stores always stay per lane: a block write would also overwrite
+        // the elements of lanes that are inactive.
         if (!vectorIO && pStore->getValueOperand()->getType()->isVectorTy())
         {
             Type* scalarType = pStore->getPointerOperand()->getType()->getPointerElementType()->getScalarType();
             IGC_ASSERT(nullptr != scalarType);
-            Type* scalarptrTy = PointerType::get(scalarType, pStore->getPointerAddressSpace());
+            Type* scalarptrTy = PointerType::get(scalarType, addrSpace);
             IGC_ASSERT(scalarType->getPrimitiveSizeInBits() / 8 == elementSize);
             Value* vec = pStore->getValueOperand();
+            Value* addressStride = IRB.CreateZExt(stride, base->getType());
 
             unsigned vecNumElts = (unsigned)cast<IGCLLVM::FixedVectorType>(vec->getType())->getNumElements();
             for (unsigned i = 0; i < vecNumElts; ++i)
             {
                 Value* ptr = IRB.CreateIntToPtr(address, scalarptrTy);
                 IRB.CreateStore(IRB.CreateExtractElement(vec, IRB.getInt32(i)), ptr);
-                address = IRB.CreateAdd(address, stride);
+                address = IRB.CreateAdd(address, addressStride);
             }
             pStore->eraseFromParent();
         }
         else
         {
-            Value* ptr = IRB.CreateIntToPtr(address, pStore->getPointerOperand()->getType());
+            Value* ptr = IRB.CreateIntToPtr(address, PointerType::get(pStore->getValueOperand()->getType(), addrSpace));
             pStore->setOperand(1, ptr);
         }
     }
@@ -511,6 +652,31 @@ bool PrivateMemoryResolution::testTransposedMemory(const Type* pTmpType, const T
     return ok;
 }
 
+void PrivateMemoryResolution::reportLayout(AllocaInst* pAI, const char* memory, bool interleaved, unsigned int numBlockReads)
+{
+    if (IGC_IS_FLAG_DISABLED(EnableOptReportPrivateMemoryLayout))
+    {
+        return;
+    }
+
+    std::stringstream report;
+    report << "Function " << m_currFunction->getName().str()
+        << ", alloca " << pAI->getName().str() << ": " << memory
+        << (interleaved ? ", interleaved across SIMD lanes" : ", per lane");
+    if (numBlockReads > 0)
+    {
+        report << ", " << numBlockReads << " block reads";
+    }
+    report << std::endl;
+
+    std::stringstream optReportFile;
+    optReportFile << IGC::Debug::GetShaderOutputFolder() << "PrivateMemoryLayout.opt";
+
+    std::ofstream optReportStream;
+    optReportStream.open(optReportFile.str(), std::ios::app);
+    optReportStream << report.str();
+}
+
 bool PrivateMemoryResolution::resolveAllocaInstructions(bool privateOnStack)
 {
     CodeGenContext& Ctx = *getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
@@ -589,6 +755,13 @@ bool PrivateMemoryResolution::resolveAllocaInstructions(bool privateOnStack)
     DebugLoc entryDebugLoc;
     entryBuilder.SetCurrentDebugLocation(entryDebugLoc);
 
+    // Explicit kernel arguments have the same value in all SIMD lanes.
+    unsigned int numUniformArgs = 0;
+    if (isEntryFunc(m_pMdUtils, m_currFunction))
+    {
+        numUniformArgs = m_currFunction->arg_size() - implicitArgs.size();
+    }
+
     if (privateOnStack)
     {
         // Creates intrinsics that will be lowered in the CodeGen and will handle the stack-pointer
@@ -649,6 +822,8 @@ bool PrivateMemoryResolution::resolveAllocaInstructions(bool privateOnStack)
                 }
             }
 
+            reportLayout(pAI, "stack", false, 0);
+
             // Replace all uses of original alloca with the bitcast
             pAI->replaceAllUsesWith(privateBuffer);
             pAI->eraseFromParent();
@@ -736,14 +911,13 @@ bool PrivateMemoryResolution::resolveAllocaInstructions(bool privateOnStack)
 
             // Get buffer information from the analysis
             unsigned int scalarBufferOffset = m_ModAllocaInfo->getConstBufferOffset(pAI);
-            // If we can use SOA layout transpose the memory
+            // If we can use SOA layout transpose the memory, so that the
+            // elements of all SIMD lanes are interleaved.
             Type* pTypeOfAccessedObject = nullptr;
-
-            // TransposeMemLayout is not prepared to work on 64-bit pointers (originally, the private address space is expressed by 32-bit pointers).
-            // Address space casting
             bool TransposeMemLayout =
-                ADDRESS_SPACE_PRIVATE == scratchMemoryAddressSpace &&
-                CanUseSOALayout(pAI, pTypeOfAccessedObject);
+                CanUseSOALayout(pAI, pTypeOfAccessedObject) &&
+                useInterleavedLayout(pAI, pTypeOfAccessedObject, numUniformArgs,
+                    scratchMemoryAddressSpace == ADDRESS_SPACE_GLOBAL);
 
             unsigned int bufferSize = 0;
             if (TransposeMemLayout)
@@ -766,12 +940,27 @@ bool PrivateMemoryResolution::resolveAllocaInstructions(bool privateOnStack)
             Value* privateBufferPTR = builder.CreateIntToPtr(threadOffset, pAI->getAllocatedType()->getPointerTo(scratchMemoryAddressSpace), VALUE_NAME(pAI->getName() + ".privateBufferPTR"));
             Value* privateBuffer = builder.CreatePointerCast(privateBufferPTR, pAI->getType(), VALUE_NAME(pAI->getName() + ".privateBuffer"));
 
+            const char* layout = scratchMemoryAddressSpace == ADDRESS_SPACE_GLOBAL ? "stateless" : "scratch";
             if (TransposeMemLayout)
             {
-                TransposeHelperPrivateMem helper(threadOffset, simdSize, bufferSize, pTypeOfAccessedObject->isVectorTy());
+                TransposeHelperPrivateMem helper(threadOffset, simdSize, bufferSize, pTypeOfAccessedObject->isVectorTy(), scratchMemoryAddressSpace);
+                // Block reads are only used for stateless memory, and only
+                // when each lane has its own copy of the alloca.
+                if (scratchMemoryAddressSpace == ADDRESS_SPACE_GLOBAL && !isUniform &&
+                    IGC_IS_FLAG_ENABLED(EnablePrivateMemoryBlockRead))
+                {
+                    helper.blockReadBase = builder.CreateAdd(privateBase,
+                        builder.CreateZExt(bufferOffset, privateBase->getType()), VALUE_NAME(pAI->getName() + ".blockReadBase"));
+                    helper.numUniformArgs = numUniformArgs;
+                }
                 Value* Idx = builder.getInt32(0);
                 helper.HandleAllocaSources(pAI, Idx);
                 helper.EraseDeadCode();
+                reportLayout(pAI, layout, true, helper.numBlockReads);
+            }
+            else
+            {
+                reportLayout(pAI, layout, false, 0);
             }
 
             // Replace all uses of original alloca with the bitcast
@@ -889,6 +1078,8 @@ bool PrivateMemoryResolution::resolveAllocaInstructions(bool privateOnStack)
             }
         }
 
+        reportLayout(pAI, "stateless", false, 0);
+
         // Replace all uses of original alloca with the bitcast
         pAI->replaceAllUsesWith(privateBuffer);
         pAI->eraseFromParent();
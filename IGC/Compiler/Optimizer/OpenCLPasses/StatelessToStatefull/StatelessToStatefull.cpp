@@ -7,6 +7,7 @@ SPDX-License-Identifier: MIT
 ============================= end_copyright_notice ===========================*/
 
 #include "Compiler/IGCPassSupport.h"
+#include "Compiler/CISACodeGen/GenCodeGenModule.h"
 #include "Compiler/Optimizer/OCLBIUtils.h"
 #include "Compiler/Optimizer/CodeAssumption.hpp"
 #include "Compiler/Optimizer/OpenCLPasses/StatelessToStatefull/StatelessToStatefull.hpp"
@@ -18,8 +19,10 @@ SPDX-License-Identifier: MIT
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/GetElementPtrTypeIterator.h>
+#include <llvm/IR/InstIterator.h>
 #include <llvm/Analysis/ValueTracking.h>
 #include "common/LLVMWarningsPop.hpp"
+#include <functional>
 #include <string>
 #include "Probe/Assertion.h"
 
@@ -121,15 +124,26 @@ IGC_INITIALIZE_PASS_END(StatelessToStatefull, PASS_FLAG, PASS_DESCRIPTION, PASS_
 //     example: kernelArg[-2]
 //
 //
+//  Function calls
+//    When functions are not inlined, a kernel argument is often passed to a helper function
+//    (subroutine or stack call), which does the actual accesses. After GenXCodeGenModule each
+//    of those functions belongs to a single kernel's function group, so a pointer argument can
+//    be bound to a kernel argument if all its call sites pass a pointer into the same kernel
+//    argument buffer. The function then gets an extra i32 argument holding the offset into the
+//    buffer, which each call site computes the same way as for an access in the kernel, and its
+//    accesses are converted relative to that offset. Bound arguments propagate down the call
+//    graph. Functions that are called indirectly or recursively are left alone.
+//
 // Possible Todos:
 //  - Fancier back tracing to a kernel argument
 //  - Handle > 2 operand GetElementPtr instructions // DONE!
+//  - Track kernel argument buffers stored in structs
 //
 
 char StatelessToStatefull::ID = 0;
 
 StatelessToStatefull::StatelessToStatefull(bool hasBufOff)
-    : FunctionPass(ID),
+    : ModulePass(ID),
     m_hasBufferOffsetArg(hasBufOff),
     m_hasOptionalBufferOffsetArg(false),
     m_hasSubDWAlignedPtrArg(false),
@@ -142,6 +156,45 @@ StatelessToStatefull::StatelessToStatefull(bool hasBufOff)
     initializeStatelessToStatefullPass(*PassRegistry::getPassRegistry());
 }
 
+bool StatelessToStatefull::runOnModule(llvm::Module& M)
+{
+    MetaDataUtils* pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+    m_FGA = getAnalysisIfAvailable<GenXFunctionGroupAnalysis>();
+
+    // Collect the kernels first, as processing a kernel may replace the
+    // functions it calls.
+    SmallVector<Function*, 8> kernels;
+    for (Function& F : M)
+    {
+        if (!F.isDeclaration() && isEntryFunc(pMdUtils, &F))
+        {
+            kernels.push_back(&F);
+        }
+    }
+
+    bool changed = false;
+    for (Function* F : kernels)
+    {
+        changed |= runOnFunction(*F);
+    }
+
+    if (!m_funcsToRemove.empty())
+    {
+        for (Function* F : m_funcsToRemove)
+        {
+            IGC_ASSERT_MESSAGE(F->use_empty(), "All calls should have been moved to the new function");
+            F->eraseFromParent();
+        }
+        m_funcsToRemove.clear();
+        pMdUtils->save(M.getContext());
+        if (m_FGA)
+        {
+            m_FGA->rebuild(&M);
+        }
+    }
+    return changed;
+}
+
 bool StatelessToStatefull::runOnFunction(llvm::Function& F)
 {
     MetaDataUtils* pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
@@ -179,12 +232,20 @@ bool StatelessToStatefull::runOnFunction(llvm::Function& F)
     CodeGenContext* ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
     m_pKernelArgs = new KernelArgs(F, &(F.getParent()->getDataLayout()), pMdUtils, modMD, ctx->platform.getGRFSize());
 
+    m_kernel = &F;
     visit(F);
 
+    if (IGC_IS_FLAG_ENABLED(EnableStatelessToStatefullAcrossCalls))
+    {
+        processCallees(&F);
+    }
+
     finalizeArgInitialValue(&F);
     delete m_pImplicitArgs;
     delete m_pKernelArgs;
     m_promotedKernelArgs.clear();
+    m_argBindings.clear();
+    m_kernel = nullptr;
     return m_changed;
 }
 
@@ -216,9 +277,13 @@ Argument* StatelessToStatefull::getBufferOffsetArg(Function* F, uint32_t ArgNumb
 //
 // The final instruction of the expansion is returned in 'offset'
 //
+// If baseOffset is given, it is the offset of the GEPs' base pointer into the
+// buffer; otherwise the base is the kernel argument itself.
+//
 bool StatelessToStatefull::getOffsetFromGEP(
     Function* F, SmallVector<GetElementPtrInst*, 4> GEPs,
-    uint32_t argNumber, bool isImplicitArg, Value*& offset)
+    uint32_t argNumber, bool isImplicitArg, Value*& offset,
+    Value* baseOffset)
 {
     Module* M = F->getParent();
     const DataLayout* DL = &M->getDataLayout();
@@ -227,7 +292,11 @@ bool StatelessToStatefull::getOffsetFromGEP(
     Value* PointerValue;
     // If m_hasPositivePointerOffset is true, BUFFER_OFFSET are assumed to be zero,
     // so is that for any implicit argument
-    if (m_hasBufferOffsetArg && !isImplicitArg && !m_hasPositivePointerOffset)
+    if (baseOffset)
+    {
+        PointerValue = baseOffset;
+    }
+    else if (m_hasBufferOffsetArg && !isImplicitArg && !m_hasPositivePointerOffset)
     {
         PointerValue = getBufferOffsetArg(F, argNumber);
         if (PointerValue == nullptr)
@@ -331,6 +400,12 @@ const KernelArg* StatelessToStatefull::getKernelArgFromPtr(const PointerType& pt
     {
         if (const KernelArg* arg = getKernelArg(base))
             return arg;
+        if (Argument* A = dyn_cast<Argument>(base))
+        {
+            auto II = m_argBindings.find(A);
+            if (II != m_argBindings.end())
+                return II->second.kernelArg;
+        }
     }
     return nullptr;
 }
@@ -354,21 +429,22 @@ bool StatelessToStatefull::pointerIsFromKernelArgument(Value& ptr)
     return false;
 }
 
-bool StatelessToStatefull::pointerIsPositiveOffsetFromKernelArgument(
-    Function* F, Value* V, Value*& offset, unsigned int& argNumber, const KernelArg*& kernelArg)
+static unsigned getPointeeAlign(const DataLayout* DL, Value* ptrVal)
 {
-    auto getPointeeAlign = [](const DataLayout* DL, Value* ptrVal)-> unsigned {
-        if (PointerType* PTy = dyn_cast<PointerType>(ptrVal->getType()))
-        {
-            Type* pointeeTy = PTy->getElementType();
-            if (!pointeeTy->isSized()) {
-                return 0;
-            }
-            return DL->getABITypeAlignment(pointeeTy);
+    if (PointerType* PTy = dyn_cast<PointerType>(ptrVal->getType()))
+    {
+        Type* pointeeTy = PTy->getElementType();
+        if (!pointeeTy->isSized()) {
+            return 0;
         }
-        return 0;
-    };
+        return DL->getABITypeAlignment(pointeeTy);
+    }
+    return 0;
+}
 
+bool StatelessToStatefull::pointerIsPositiveOffsetFromKernelArgument(
+    Function* F, Value* V, Value*& offset, unsigned int& argNumber, const KernelArg*& kernelArg)
+{
     const DataLayout* DL = &F->getParent()->getDataLayout();
 
     AssumptionCache* AC = getAC(F);
@@ -391,6 +467,46 @@ bool StatelessToStatefull::pointerIsPositiveOffsetFromKernelArgument(
         base = gep->getPointerOperand()->stripPointerCasts();
     }
 
+    // if the base is a function argument bound to a kernel argument
+    auto bindingIter = isa<Argument>(base) ? m_argBindings.find(cast<Argument>(base)) : m_argBindings.end();
+    if (bindingIter != m_argBindings.end() &&
+        cast<PointerType>(base->getType())->getAddressSpace() == ptrType->getAddressSpace())
+    {
+        const ArgBinding& binding = bindingIter->second;
+        const KernelArg* arg = binding.kernelArg;
+        argNumber = arg->getAssociatedArgNo();
+        bool gepProducesPositivePointer = binding.isPositive;
+
+        // Same as for the kernel argument below, with the call sites' part of
+        // the offset already checked when the argument was bound.
+        if (!arg->isImplicitArg() &&
+            binding.isAligned &&
+            (!m_hasBufferOffsetArg || m_hasOptionalBufferOffsetArg) &&
+            !m_hasPositivePointerOffset)
+        {
+            for (GetElementPtrInst* tgep : GEPs)
+            {
+                for (auto U = tgep->idx_begin(), E = tgep->idx_end(); U != E; ++U)
+                {
+                    gepProducesPositivePointer &= valueIsPositive(U->get(), DL, AC);
+                }
+            }
+
+            if (m_hasOptionalBufferOffsetArg)
+            {
+                updateArgInfo(arg, gepProducesPositivePointer);
+            }
+        }
+        if ((m_hasBufferOffsetArg ||
+             (gepProducesPositivePointer && binding.isAligned)) &&
+            getOffsetFromGEP(F, GEPs, argNumber, arg->isImplicitArg(), offset, binding.offset))
+        {
+            kernelArg = arg;
+            return true;
+        }
+        return false;
+    }
+
     if (!m_supportNonGEPPtr && gep == nullptr)
     {
         return false;
@@ -472,6 +588,331 @@ bool StatelessToStatefull::pointerIsPositiveOffsetFromKernelArgument(
     return false;
 }
 
+//
+// Checks if pointer V, passed to a call in F, points into the buffer of a
+// kernel argument, either directly or through an argument of F that is
+// already bound. Unlike pointerIsPositiveOffsetFromKernelArgument, this does
+// not change the IR; the GEPs from the base are returned for the offset to be
+// computed later, and binding.offset is set to the offset of the base (null
+// if the base is the kernel argument itself).
+//
+bool StatelessToStatefull::getCallArgBinding(
+    Function* F, Value* V, ArgBinding& binding, SmallVector<GetElementPtrInst*, 4>& GEPs)
+{
+    PointerType* ptrType = dyn_cast<PointerType>(V->getType());
+    if (!ptrType || (ptrType->getAddressSpace() != ADDRESS_SPACE_GLOBAL &&
+        ptrType->getAddressSpace() != ADDRESS_SPACE_CONSTANT))
+    {
+        return false;
+    }
+
+    Value* base = V->stripPointerCasts();
+    while (GetElementPtrInst* gep = dyn_cast<GetElementPtrInst>(base))
+    {
+        GEPs.push_back(gep);
+        base = gep->getPointerOperand()->stripPointerCasts();
+    }
+    if (cast<PointerType>(base->getType())->getAddressSpace() != ptrType->getAddressSpace())
+    {
+        return false;
+    }
+
+    const DataLayout* DL = &F->getParent()->getDataLayout();
+    bool isPositive = true;
+    if (F == m_kernel)
+    {
+        const KernelArg* arg = getKernelArg(base);
+        if (!arg)
+        {
+            return false;
+        }
+        // getOffsetFromGEP starts from the argument's BUFFER_OFFSET in this
+        // case; leave the pointer unbound if the kernel doesn't have one.
+        if (m_hasBufferOffsetArg && !arg->isImplicitArg() && !m_hasPositivePointerOffset &&
+            !getBufferOffsetKernelArg(arg))
+        {
+            return false;
+        }
+        binding.kernelArg = arg;
+        binding.offset = nullptr;
+        // See pointerIsPositiveOffsetFromKernelArgument for why the base
+        // needs to be DW-aligned.
+        binding.isAligned =
+            (!m_hasSubDWAlignedPtrArg || arg->isImplicitArg())
+            ? true
+            : (getPointeeAlign(DL, base) >= 4);
+        // Offsets are known to be positive for these.
+        if (arg->isImplicitArg() || m_hasPositivePointerOffset)
+        {
+            binding.isPositive = true;
+            return true;
+        }
+    }
+    else
+    {
+        auto II = isa<Argument>(base) ? m_argBindings.find(cast<Argument>(base)) : m_argBindings.end();
+        if (II == m_argBindings.end())
+        {
+            return false;
+        }
+        binding = II->second;
+        isPositive = binding.isPositive;
+    }
+
+    AssumptionCache* AC = getAC(F);
+    for (GetElementPtrInst* gep : GEPs)
+    {
+        for (auto U = gep->idx_begin(), E = gep->idx_end(); U != E; ++U)
+        {
+            isPositive &= valueIsPositive(U->get(), DL, AC);
+        }
+    }
+    binding.isPositive = isPositive;
+    return true;
+}
+
+//
+// Binds pointer arguments of the functions in kernel K's function group to
+// the kernel arguments they point into, and converts the accesses through
+// them. A function is handled once all of its callers have been, so that
+// bindings propagate down the call graph.
+//
+void StatelessToStatefull::processCallees(Function* K)
+{
+    FunctionGroup* FG = m_FGA ? m_FGA->getGroup(K) : nullptr;
+    if (!FG || FG->isSingle() || m_FGA->isIndirectCallGroup(K))
+    {
+        return;
+    }
+
+    // Order the functions of the group so that callers come first.
+    SmallVector<Function*, 16> postOrder;
+    SmallPtrSet<Function*, 16> visited;
+    std::function<void(Function*)> walk = [&](Function* F)
+    {
+        visited.insert(F);
+        for (auto& I : instructions(F))
+        {
+            if (CallInst* CI = dyn_cast<CallInst>(&I))
+            {
+                Function* callee = CI->getCalledFunction();
+                if (callee && !callee->isDeclaration() &&
+                    m_FGA->getGroup(callee) == FG && !visited.count(callee))
+                {
+                    walk(callee);
+                }
+            }
+        }
+        postOrder.push_back(F);
+    };
+    walk(K);
+
+    MetaDataUtils* pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+    SmallPtrSet<Function*, 16> processed;
+    processed.insert(K);
+    for (auto FI = postOrder.rbegin(), FE = postOrder.rend(); FI != FE; ++FI)
+    {
+        Function* F = *FI;
+        if (F == K)
+        {
+            continue;
+        }
+
+        // Only direct calls from functions already handled are allowed,
+        // which also rules out recursion.
+        bool canBind = !F->isVarArg() && !F->hasFnAttribute("referenced-indirectly");
+        SmallVector<CallInst*, 8> callSites;
+        for (User* U : F->users())
+        {
+            CallInst* CI = dyn_cast<CallInst>(U);
+            if (!CI || CI->getCalledFunction() != F || !processed.count(CI->getFunction()))
+            {
+                canBind = false;
+                break;
+            }
+            callSites.push_back(CI);
+        }
+        processed.insert(F);
+        if (!canBind || callSites.empty())
+        {
+            continue;
+        }
+
+        ImplicitArgs implicitArgs(*F, pMdUtils);
+        unsigned numExplicitArgs = F->arg_size() - implicitArgs.size();
+
+        SmallVector<unsigned, 4> argNos;
+        SmallVector<ArgBinding, 4> bindings;
+        for (Argument& A : F->args())
+        {
+            if (A.getArgNo() >= numExplicitArgs || A.use_empty())
+            {
+                continue;
+            }
+
+            // All call sites must pass a pointer into the same buffer.
+            ArgBinding binding;
+            bool isBound = true;
+            for (CallInst* CI : callSites)
+            {
+                ArgBinding callBinding;
+                SmallVector<GetElementPtrInst*, 4> GEPs;
+                if (!getCallArgBinding(CI->getFunction(), CI->getArgOperand(A.getArgNo()), callBinding, GEPs) ||
+                    (binding.kernelArg && binding.kernelArg != callBinding.kernelArg))
+                {
+                    isBound = false;
+                    break;
+                }
+                binding.kernelArg = callBinding.kernelArg;
+                binding.isPositive &= callBinding.isPositive;
+                binding.isAligned &= callBinding.isAligned;
+            }
+            if (isBound && (m_hasBufferOffsetArg || (binding.isPositive && binding.isAligned)))
+            {
+                argNos.push_back(A.getArgNo());
+                bindings.push_back(binding);
+            }
+        }
+        if (argNos.empty())
+        {
+            continue;
+        }
+
+        Function* NF = addOffsetArgs(F, argNos, bindings);
+        processed.insert(NF);
+        visit(*NF);
+    }
+}
+
+//
+// Replaces F with a function taking an i32 offset for each bound pointer
+// argument in argNos. The offsets are inserted before the implicit arguments
+// and computed at each call site.
+//
+Function* StatelessToStatefull::addOffsetArgs(
+    Function* F, const SmallVector<unsigned, 4>& argNos, const SmallVector<ArgBinding, 4>& bindings)
+{
+    MetaDataUtils* pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+    ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
+    Module* M = F->getParent();
+    LLVMContext& C = M->getContext();
+    Type* int32Ty = Type::getInt32Ty(C);
+
+    ImplicitArgs implicitArgs(*F, pMdUtils);
+    unsigned insertPos = F->arg_size() - implicitArgs.size();
+    unsigned numOffsets = argNos.size();
+
+    FunctionType* FTy = F->getFunctionType();
+    SmallVector<Type*, 16> paramTys(FTy->param_begin(), FTy->param_begin() + insertPos);
+    paramTys.append(numOffsets, int32Ty);
+    paramTys.append(FTy->param_begin() + insertPos, FTy->param_end());
+    FunctionType* NFTy = FunctionType::get(FTy->getReturnType(), paramTys, false);
+
+    auto addOffsetAttrs = [&](AttributeList PAL)
+    {
+        SmallVector<AttributeSet, 16> argAttrs;
+        for (unsigned i = 0; i < FTy->getNumParams(); ++i)
+        {
+            if (i == insertPos)
+            {
+                argAttrs.append(numOffsets, AttributeSet());
+            }
+            argAttrs.push_back(PAL.getParamAttributes(i));
+        }
+        if (insertPos == FTy->getNumParams())
+        {
+            argAttrs.append(numOffsets, AttributeSet());
+        }
+        return AttributeList::get(C, PAL.getFnAttributes(), PAL.getRetAttributes(), argAttrs);
+    };
+
+    Function* NF = Function::Create(NFTy, F->getLinkage());
+    NF->copyAttributesFrom(F);
+    NF->setAttributes(addOffsetAttrs(F->getAttributes()));
+    NF->setSubprogram(F->getSubprogram());
+    M->getFunctionList().insert(F->getIterator(), NF);
+    NF->takeName(F);
+    NF->getBasicBlockList().splice(NF->begin(), F->getBasicBlockList());
+
+    Function::arg_iterator NAI = NF->arg_begin();
+    for (Argument& A : F->args())
+    {
+        if (A.getArgNo() == insertPos)
+        {
+            std::advance(NAI, numOffsets);
+        }
+        NAI->takeName(&A);
+        A.replaceAllUsesWith(&*NAI);
+        ++NAI;
+    }
+
+    // Pass the offsets at each call site.
+    SmallVector<CallInst*, 8> callSites;
+    for (User* U : F->users())
+    {
+        callSites.push_back(cast<CallInst>(U));
+    }
+    for (CallInst* CI : callSites)
+    {
+        Function* caller = CI->getFunction();
+        SmallVector<Value*, 16> args(CI->arg_begin(), CI->arg_begin() + insertPos);
+        for (unsigned argNo : argNos)
+        {
+            ArgBinding binding;
+            SmallVector<GetElementPtrInst*, 4> GEPs;
+            Value* offset = nullptr;
+            // processCallees only binds arguments whose call sites all
+            // passed getCallArgBinding, which also ensures that the offset
+            // can be computed.
+            bool isBound = getCallArgBinding(caller, CI->getArgOperand(argNo), binding, GEPs) &&
+                getOffsetFromGEP(caller, GEPs, binding.kernelArg->getAssociatedArgNo(),
+                    binding.kernelArg->isImplicitArg(), offset, binding.offset);
+            IGC_ASSERT_MESSAGE(isBound, "Call site does not match the argument binding");
+            args.push_back(offset);
+        }
+        args.append(CI->arg_begin() + insertPos, CI->arg_end());
+
+        CallInst* NCI = CallInst::Create(NF, args, "", CI);
+        NCI->setCallingConv(CI->getCallingConv());
+        NCI->setAttributes(addOffsetAttrs(CI->getAttributes()));
+        NCI->setDebugLoc(CI->getDebugLoc());
+        NCI->takeName(CI);
+        CI->replaceAllUsesWith(NCI);
+        CI->eraseFromParent();
+    }
+
+    for (unsigned i = 0; i < numOffsets; ++i)
+    {
+        Argument* ptrArg = NF->arg_begin() + argNos[i];
+        Argument* offsetArg = NF->arg_begin() + insertPos + i;
+        offsetArg->setName(ptrArg->getName() + ".offset");
+
+        ArgBinding binding = bindings[i];
+        binding.offset = offsetArg;
+        m_argBindings[ptrArg] = binding;
+    }
+
+    // Move the metadata over to the new function.
+    auto oldFuncIter = pMdUtils->findFunctionsInfoItem(F);
+    if (oldFuncIter != pMdUtils->end_FunctionsInfo())
+    {
+        pMdUtils->setFunctionsInfoItem(NF, oldFuncIter->second);
+        pMdUtils->eraseFunctionsInfoItem(oldFuncIter);
+    }
+    auto funcMDIter = modMD->FuncMD.find(F);
+    if (funcMDIter != modMD->FuncMD.end())
+    {
+        FunctionMetaData funcMD = funcMDIter->second;
+        modMD->FuncMD.erase(funcMDIter);
+        modMD->FuncMD[NF] = funcMD;
+    }
+    m_FGA->copyFuncProperties(NF, F);
+
+    m_funcsToRemove.push_back(F);
+    m_changed = true;
+    return NF;
+}
+
 void StatelessToStatefull::visitCallInst(CallInst& I)
 {
     auto doPromoteUntypedAtomics = [](const GenISAIntrinsic::ID intrinID, const GenIntrinsicInst* Inst)-> bool
@@ -536,7 +977,7 @@ void StatelessToStatefull::visitCallInst(CallInst& I)
             if (m_promotedKernelArgs.size() < maxPromotionCount && pointerIsPositiveOffsetFromKernelArgument(F, ptr, offset, baseArgNumber, kernelArg))
             {
                 ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
-                FunctionMetaData* funcMD = &modMD->FuncMD[F];
+                FunctionMetaData* funcMD = &modMD->FuncMD[m_kernel];
                 ResourceAllocMD* resAllocMD = &funcMD->resAllocMD;
                 IGC_ASSERT_MESSAGE(resAllocMD->argAllocMDList.size() > 0, "ArgAllocMDList is empty.");
                 ArgAllocMD* argAlloc = &resAllocMD->argAllocMDList[baseArgNumber];
@@ -646,7 +1087,7 @@ void StatelessToStatefull::visitCallInst(CallInst& I)
                 Value* ptr = finalInst->getOperand(0);
                 if (!pointerIsFromKernelArgument(*ptr)) {
                     ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
-                    FunctionMetaData* funcMD = &modMD->FuncMD[finalInst->getParent()->getParent()];
+                    FunctionMetaData* funcMD = &modMD->FuncMD[m_kernel];
                     if (isStoreIntrinsic(intrinID))
                         funcMD->hasNonKernelArgStore = true;
                     else if (isLoadIntrinsic(intrinID))
@@ -673,7 +1114,7 @@ void StatelessToStatefull::visitLoadInst(LoadInst& I)
     if (m_promotedKernelArgs.size() < maxPromotionCount && pointerIsPositiveOffsetFromKernelArgument(F, ptr, offset, baseArgNumber, kernelArg))
     {
         ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
-        FunctionMetaData* funcMD = &modMD->FuncMD[F];
+        FunctionMetaData* funcMD = &modMD->FuncMD[m_kernel];
         ResourceAllocMD* resAllocMD = &funcMD->resAllocMD;
         IGC_ASSERT_MESSAGE(resAllocMD->argAllocMDList.size() > 0, "ArgAllocMDList is empty.");
         ArgAllocMD* argAlloc = &resAllocMD->argAllocMDList[baseArgNumber];
@@ -711,7 +1152,7 @@ void StatelessToStatefull::visitLoadInst(LoadInst& I)
     if (IGC_IS_FLAG_ENABLED(DumpHasNonKernelArgLdSt) &&
         ptr != nullptr && !pointerIsFromKernelArgument(*ptr)) {
         ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
-        FunctionMetaData* funcMD = &modMD->FuncMD[F];
+        FunctionMetaData* funcMD = &modMD->FuncMD[m_kernel];
         funcMD->hasNonKernelArgLoad = true;
     }
 }
@@ -734,7 +1175,7 @@ void StatelessToStatefull::visitStoreInst(StoreInst& I)
         if (dataVal != nullptr)
         {
             ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
-            FunctionMetaData* funcMD = &modMD->FuncMD[F];
+            FunctionMetaData* funcMD = &modMD->FuncMD[m_kernel];
             ResourceAllocMD* resAllocMD = &funcMD->resAllocMD;
             IGC_ASSERT_MESSAGE(resAllocMD->argAllocMDList.size() > 0, "ArgAllocMDList is empty.");
             ArgAllocMD* argAlloc = &resAllocMD->argAllocMDList[baseArgNumber];
@@ -761,7 +1202,7 @@ void StatelessToStatefull::visitStoreInst(StoreInst& I)
     if (IGC_IS_FLAG_ENABLED(DumpHasNonKernelArgLdSt) &&
         ptr != nullptr && !pointerIsFromKernelArgument(*ptr)) {
         ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
-        FunctionMetaData* funcMD = &modMD->FuncMD[F];
+        FunctionMetaData* funcMD = &modMD->FuncMD[m_kernel];
         funcMD->hasNonKernelArgStore = true;
     }
 }
@@ -18,6 +18,7 @@ SPDX-License-Identifier: MIT
 #include <llvm/Analysis/AssumptionCache.h>
 #include "common/LLVMWarningsPop.hpp"
 #include "Probe/Assertion.h"
+#include <vector>
 
 namespace IGC
 {
@@ -26,7 +27,9 @@ namespace IGC
     // performace. Simplily disable stateful promotion after 32 args.
     constexpr uint maxPromotionCount = 32;
 
-    class StatelessToStatefull : public llvm::FunctionPass, public llvm::InstVisitor<StatelessToStatefull>
+    class GenXFunctionGroupAnalysis;
+
+    class StatelessToStatefull : public llvm::ModulePass, public llvm::InstVisitor<StatelessToStatefull>
     {
     public:
         typedef llvm::DenseMap<const KernelArg*, int> ArgInfoMap;
@@ -50,13 +53,26 @@ namespace IGC
             return "StatelessToStatefull";
         }
 
-        virtual bool runOnFunction(llvm::Function& F) override;
+        virtual bool runOnModule(llvm::Module& M) override;
+
+        bool runOnFunction(llvm::Function& F);
 
         void visitLoadInst(llvm::LoadInst& I);
         void visitStoreInst(llvm::StoreInst& I);
         void visitCallInst(llvm::CallInst& I);
 
     private:
+        // A pointer argument of a function called from the kernel that is
+        // known to point into the buffer of a kernel argument. The offset
+        // into the buffer is passed to the function as an extra i32 argument.
+        struct ArgBinding
+        {
+            const KernelArg* kernelArg = nullptr;
+            llvm::Value* offset = nullptr;
+            bool isPositive = true;
+            bool isAligned = true;
+        };
+
         llvm::CallInst* createBufferPtr(
             unsigned addrSpace, llvm::Constant* argNumber, llvm::Instruction* InsertBefore);
         bool pointerIsPositiveOffsetFromKernelArgument(
@@ -71,7 +87,18 @@ namespace IGC
 
         bool getOffsetFromGEP(
             llvm::Function* F, llvm::SmallVector<llvm::GetElementPtrInst*, 4> GEPs,
-            uint32_t argNumber, bool isImplicitArg, llvm::Value*& offset);
+            uint32_t argNumber, bool isImplicitArg, llvm::Value*& offset,
+            llvm::Value* baseOffset = nullptr);
+
+        // Interprocedural tracking of kernel argument buffers into the
+        // functions of the kernel's function group.
+        void processCallees(llvm::Function* K);
+        bool getCallArgBinding(
+            llvm::Function* F, llvm::Value* V, ArgBinding& binding,
+            llvm::SmallVector<llvm::GetElementPtrInst*, 4>& GEPs);
+        llvm::Function* addOffsetArgs(
+            llvm::Function* F, const llvm::SmallVector<unsigned, 4>& argNos,
+            const llvm::SmallVector<ArgBinding, 4>& bindings);
         llvm::Argument* getBufferOffsetArg(llvm::Function* F, uint32_t ArgNumber);
         void setPointerSizeTo32bit(int32_t AddrSpace, llvm::Module* M);
 
@@ -131,6 +158,11 @@ namespace IGC
 
         ImplicitArgs* m_pImplicitArgs;
         KernelArgs* m_pKernelArgs;
+        // The kernel whose arguments and binding table are used.
+        llvm::Function* m_kernel = nullptr;
+        GenXFunctionGroupAnalysis* m_FGA = nullptr;
+        llvm::DenseMap<const llvm::Argument*, ArgBinding> m_argBindings;
+        std::vector<llvm::Function*> m_funcsToRemove;
         ArgInfoMap   m_argsInfo;
         bool m_changed;
         std::unordered_set<const KernelArg*> m_promotedKernelArgs; // ptr args which have been promoted to stateful
@@ -38,6 +38,7 @@ SPDX-License-Identifier: MIT
 #include "AdaptorOCL/OCL/BuiltinResource.h"
 #include "AdaptorOCL/OCL/LoadBuffer.h"
 
+#include <algorithm>
 #include <vector>
 #include <utility>
 
@@ -57,6 +58,17 @@ IGC_INITIALIZE_PASS_END(PreCompiledFuncImport, PASS_FLAG, PASS_DESCRIPTION, PASS
 
 char PreCompiledFuncImport::ID = 0;
 
+// igc_opt creates the pass without a context; TestIGCPreCompiledFunctions
+// selects what it emulates.
+PreCompiledFuncImport::PreCompiledFuncImport() :
+    ModulePass(ID),
+    m_pCtx(nullptr),
+    m_enableSubroutineCallForEmulation(false),
+    m_emuKind(IGC_GET_FLAG_VALUE(TestIGCPreCompiledFunctions))
+{
+    initializePreCompiledFuncImportPass(*PassRegistry::getPassRegistry());
+}
+
 PreCompiledFuncImport::PreCompiledFuncImport(
     CodeGenContext* CGCtx, uint32_t TheEmuKind) :
     ModulePass(ID),
@@ -68,7 +80,7 @@ PreCompiledFuncImport::PreCompiledFuncImport(
 
     if (IGC_IS_FLAG_ENABLED(EnableSubroutineForEmulation))
     {
-        checkAndSetEnableSubroutine();
+        checkAndSetEnableSubroutine(m_pCtx->getModule());
     }
 }
 
@@ -411,11 +423,17 @@ bool PreCompiledFuncImport::runOnModule(Module& M)
         return false;
     }
 
+    bool hasContext = m_pCtx != nullptr;
     m_pCtx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
     m_pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
     m_pModule = &M;
     m_changed = false;
 
+    if (!hasContext && IGC_IS_FLAG_ENABLED(EnableSubroutineForEmulation))
+    {
+        checkAndSetEnableSubroutine(&M);
+    }
+
     m_roundingMode = m_pCtx->m_DriverInfo.DPEmulationRoundingMode();
     m_flushDenorm = (m_pCtx->m_DriverInfo.DPEmulationFlushDenorm()) ? 1 : 0 ;
     m_flushToZero = (m_pCtx->m_DriverInfo.DPEmulationFlushToZero()) ? 1 : 0 ;
@@ -599,7 +617,14 @@ bool PreCompiledFuncImport::runOnModule(Module& M)
         }
     }
 
-    unsigned totalNumberOfInlinedInst = 0;
+    // Emulation functions whose inlining is decided by the cost model below.
+    struct EmuFuncCost
+    {
+        Function* F;
+        unsigned NumInst;
+        unsigned NumSharedOperandCalls;
+    };
+    std::vector<EmuFuncCost> inlineCandidates;
 
     // Post processing, set those imported functions as internal linkage
     // and alwaysinline. Also count how many instructions would be added
@@ -633,6 +658,7 @@ bool PreCompiledFuncImport::runOnModule(Module& M)
                 (IGC_IS_FLAG_ENABLED(ForceSubroutineForEmulation)))
             {
                 // Disable inlining completely.
+                inlineCandidates.push_back({ Func, 0, 0 });
                 continue;
             }
 
@@ -660,7 +686,7 @@ bool PreCompiledFuncImport::runOnModule(Module& M)
                 continue;
             }
 
-            totalNumberOfInlinedInst += NumInst * Func->getNumUses();
+            inlineCandidates.push_back({ Func, NumInst, 0 });
         }
         else
         {
@@ -669,41 +695,125 @@ bool PreCompiledFuncImport::runOnModule(Module& M)
         }
     }
 
-    for (auto II = M.begin(), IE = M.end(); II != IE; )
+    // Count the calls that share an operand with another emulated operation
+    // in the same block. Once inlined, both copies unpack that operand
+    // (sign, exponent, mantissa) the same way, and EarlyCSE after inlining
+    // keeps only one copy.
+    for (EmuFuncCost& cost : inlineCandidates)
     {
-        Function* Func = &(*II);
-        ++II;
-        if (!Func || Func->isDeclaration())
+        for (User* U : cost.F->users())
         {
-            continue;
+            CallInst* CI = dyn_cast<CallInst>(U);
+            if (!CI)
+            {
+                continue;
+            }
+            bool sharesOperand = false;
+            for (Value* arg : CI->args())
+            {
+                if (isa<Constant>(arg))
+                {
+                    continue;
+                }
+                for (User* argUser : arg->users())
+                {
+                    CallInst* otherCI = dyn_cast<CallInst>(argUser);
+                    Function* otherFunc = otherCI ? otherCI->getCalledFunction() : nullptr;
+                    if (otherCI && otherCI != CI && otherFunc && !otherFunc->isDeclaration() &&
+                        !origFunctions.count(otherFunc) && otherCI->getParent() == CI->getParent())
+                    {
+                        sharesOperand = true;
+                        break;
+                    }
+                }
+                if (sharesOperand)
+                {
+                    break;
+                }
+            }
+            cost.NumSharedOperandCalls += sharesOperand ? 1 : 0;
         }
+    }
 
-        if (!origFunctions.count(Func) && !Func->hasFnAttribute(llvm::Attribute::AlwaysInline))
+    // Inline the candidates greedily, starting with those sharing operands
+    // with other emulated operations and then the ones adding the fewest
+    // instructions. A function becomes a subroutine once inlining it would
+    // exceed InlinedEmulationThreshold instructions in total, or, if set,
+    // InlinedEmulationCallerThreshold instructions in one of its callers.
+    // The latter stands in for register pressure, which grows with the
+    // number of emulation sequences inlined into one function.
+    std::sort(inlineCandidates.begin(), inlineCandidates.end(),
+        [](const EmuFuncCost& A, const EmuFuncCost& B)
         {
-            // Use subroutine if ForceSubroutineForEmulation is set or
-            // use subroutines if total number of instructions added when
-            // all emulated functions are inlined exceed InlinedEmulationThreshold.
-            if (m_enableSubroutineCallForEmulation &&
-                (IGC_IS_FLAG_ENABLED(ForceSubroutineForEmulation) ||
-                    totalNumberOfInlinedInst > (unsigned)IGC_GET_FLAG_VALUE(InlinedEmulationThreshold)))
+            if ((A.NumSharedOperandCalls > 0) != (B.NumSharedOperandCalls > 0))
             {
-                Func->addFnAttr(llvm::Attribute::NoInline);
-
-                // Create an entry in metadata for this function and add
-                // implicit args for private base if needed (note that the
-                // entry func should have private base as implicit arg
-                // already. It has been added in PrivateMemoryUsageAnalysis.
-                // And emulation functions may need implicit args for private
-                // memory only, not any other implicit args). Once implicit
-                // args are added, function signature and its calls are changed
-                // accordingly.
-                addMDFuncEntryForEmulationFunc(Func);
-                hasNewMDEntry = true;
+                return A.NumSharedOperandCalls > 0;
             }
-            else
+            return A.NumInst * A.F->getNumUses() < B.NumInst * B.F->getNumUses();
+        });
+
+    const unsigned callerThreshold = IGC_GET_FLAG_VALUE(InlinedEmulationCallerThreshold);
+    DenseMap<Function*, unsigned> callerNumInst;
+    unsigned totalNumberOfInlinedInst = 0;
+    for (const EmuFuncCost& cost : inlineCandidates)
+    {
+        Function* Func = cost.F;
+        unsigned inlinedInst = cost.NumInst * Func->getNumUses();
+
+        DenseMap<Function*, unsigned> callerGrowth;
+        for (User* U : Func->users())
+        {
+            if (Instruction* I = dyn_cast<Instruction>(U))
             {
-                // Add AlwaysInline attribute to force inlining all calls.
-                Func->addFnAttr(llvm::Attribute::AlwaysInline);
+                callerGrowth[I->getFunction()] += cost.NumInst;
+            }
+        }
+
+        bool useSubroutine = false;
+        if (m_enableSubroutineCallForEmulation)
+        {
+            useSubroutine =
+                IGC_IS_FLAG_ENABLED(ForceSubroutineForEmulation) ||
+                totalNumberOfInlinedInst + inlinedInst > (unsigned)IGC_GET_FLAG_VALUE(InlinedEmulationThreshold);
+            for (auto& growth : callerGrowth)
+            {
+                if (useSubroutine || callerThreshold == 0)
+                {
+                    break;
+                }
+                auto CI = callerNumInst.find(growth.first);
+                if (CI == callerNumInst.end())
+                {
+                    CI = callerNumInst.insert(
+                        std::make_pair(growth.first, (unsigned)growth.first->getInstructionCount())).first;
+                }
+                useSubroutine = CI->second + growth.second > callerThreshold;
+            }
+        }
+
+        if (useSubroutine)
+        {
+            Func->addFnAttr(llvm::Attribute::NoInline);
+
+            // Create an entry in metadata for this function and add
+            // implicit args for private base if needed (note that the
+            // entry func should have private base as implicit arg
+            // already. It has been added in PrivateMemoryUsageAnalysis.
+            // And emulation functions may need implicit args for private
+            // memory only, not any other implicit args). Once implicit
+            // args are added, function signature and its calls are changed
+            // accordingly.
+            addMDFuncEntryForEmulationFunc(Func);
+            hasNewMDEntry = true;
+        }
+        else
+        {
+            // Add AlwaysInline attribute to force inlining all calls.
+            Func->addFnAttr(llvm::Attribute::AlwaysInline);
+            totalNumberOfInlinedInst += inlinedInst;
+            for (auto& growth : callerGrowth)
+            {
+                callerNumInst[growth.first] += growth.second;
             }
         }
     }
@@ -2092,7 +2202,7 @@ ImplicitArgs* PreCompiledFuncImport::getImplicitArgs(Function* F)
     return FuncsImpArgs[F];
 }
 
-void PreCompiledFuncImport::checkAndSetEnableSubroutine()
+void PreCompiledFuncImport::checkAndSetEnableSubroutine(Module* M)
 {
     // Skip if subroutine is already on.
     if (m_pCtx->m_enableSubroutine)
@@ -2120,7 +2230,6 @@ void PreCompiledFuncImport::checkAndSetEnableSubroutine()
     bool DPEmu = isDPEmu();
     bool DPDivSqrtEmu = isDPDivSqrtEmu();
 
-    Module* M = m_pCtx->getModule();
     for (auto FI = M->begin(), FE = M->end(); FI != FE; ++FI)
     {
         Function* F = &*FI;
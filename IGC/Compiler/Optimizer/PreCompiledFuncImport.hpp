@@ -120,10 +120,7 @@ namespace IGC
         static char ID;
 
         // For pass registration
-        PreCompiledFuncImport() :
-            ModulePass(ID),
-            m_emuKind(EMU_UNUSED)
-        {};
+        PreCompiledFuncImport();
 
         PreCompiledFuncImport(CodeGenContext* CGCtx, uint32_t TheEmuKind);
 
@@ -187,7 +184,7 @@ namespace IGC
         void removeLLVMModuleFlag(llvm::Module* M);
 
         // Check if subroutine call is needed and set it if so.
-        void checkAndSetEnableSubroutine();
+        void checkAndSetEnableSubroutine(llvm::Module* M);
         CodeGenContext* m_pCtx;
         bool m_enableSubroutineCallForEmulation;
 
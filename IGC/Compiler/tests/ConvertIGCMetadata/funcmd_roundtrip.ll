@@ -0,0 +1,63 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2021 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+
+; RUN: igc_opt -igc-convert-metadata -S %s -o %t.blob.ll
+; RUN: FileCheck %s --input-file=%t.blob.ll --check-prefix=BLOB
+; RUN: igc_opt -igc-convert-metadata -globaldce -igc-convert-metadata -S %s -o %t.ll
+; RUN: FileCheck %s --input-file=%t.ll
+
+; FuncMD goes through the binary blob and back. @dead is deleted while the
+; metadata is in the blob, so its entry is skipped when the blob is read and
+; the entry of @after, written behind it, still decodes.
+
+; BLOB-NOT: !IGCMetadata =
+; BLOB: !IGCMetadataBlob =
+; BLOB-NOT: !IGCMetadata =
+
+; CHECK-NOT: @dead
+; CHECK: !IGCMetadata =
+; CHECK-NOT: !IGCMetadataBlob =
+; CHECK: !{!"FuncMDMap[0]", void (i32)* @kernel}
+; CHECK: !{!"localSize", i32 64}
+; CHECK: !{!"FuncMDMap[1]", void ()* @after}
+; CHECK: !{!"localSize", i32 16}
+; CHECK: !{!"privateMemoryPerWI", i32 128}
+; CHECK-NOT: FuncMDMap[2]
+; CHECK-NOT: !"dead"
+
+define void @kernel(i32 %x) {
+  ret void
+}
+
+define internal void @dead() {
+  ret void
+}
+
+define void @after() {
+  ret void
+}
+
+!igc.functions = !{!0}
+!IGCMetadata = !{!3}
+
+!0 = !{void (i32)* @kernel, !1}
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
+!3 = !{!"ModuleMD", !4}
+!4 = !{!"FuncMD", !5, !6, !8, !9, !12, !13}
+!5 = !{!"FuncMDMap[0]", void (i32)* @kernel}
+!6 = !{!"FuncMDValue[0]", !7}
+!7 = !{!"localSize", i32 64}
+!8 = !{!"FuncMDMap[1]", void ()* @dead}
+!9 = !{!"FuncMDValue[1]", !10, !11}
+!10 = !{!"localSize", i32 32}
+!11 = !{!"UserAnnotations", !{!"UserAnnotationsVec[0]", !"dead"}}
+!12 = !{!"FuncMDMap[2]", void ()* @after}
+!13 = !{!"FuncMDValue[2]", !14, !15}
+!14 = !{!"localSize", i32 16}
+!15 = !{!"privateMemoryPerWI", i32 128}
@@ -0,0 +1,27 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// REQUIRES: ocloc
+// RUN: not ocloc compile -file %s -device skl -out_dir %t 2>&1 | FileCheck %s
+
+// A fragment that does not parse fails the build with the parser's message
+// in the build log.
+
+// CHECK-DAG: parsing vISA inline assembly failed
+// CHECK-DAG: Build failed
+
+__attribute__((intel_reqd_sub_group_size(16)))
+__kernel void test_parse_error(__global int* out, __global const int* a)
+{
+    int gid = get_global_id(0);
+    int x = a[gid];
+    int c;
+    __asm__("not_an_opcode (M1, 16) %0(0, 0)<1> %1(0, 0)<1;1,0>"
+            : "=rw"(c) : "rw"(x));
+    out[gid] = c;
+}
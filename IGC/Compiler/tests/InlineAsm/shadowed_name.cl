@@ -0,0 +1,31 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// REQUIRES: ocloc
+// RUN: ocloc compile -file %s -device skl -out_dir %t 2>&1 | FileCheck %s
+
+// A fragment declares its own V0001, which is also the name of a kernel
+// variable. The declaration is scoped to the fragment, so it shadows the
+// kernel variable instead of clashing with it.
+
+// CHECK: Build succeeded
+// CHECK-NOT: error
+
+__attribute__((intel_reqd_sub_group_size(16)))
+__kernel void test_shadow(__global int* out, __global const int* a, __global const int* b)
+{
+    int gid = get_global_id(0);
+    int x = a[gid];
+    int y = b[gid];
+    int c;
+    __asm__(".decl V0001 v_type=G type=d num_elts=16 align=GRF\n"
+            "add (M1, 16) V0001(0, 0)<1> %1(0, 0)<1;1,0> %2(0, 0)<1;1,0>\n"
+            "mov (M1, 16) %0(0, 0)<1> V0001(0, 0)<1;1,0>\n"
+            : "=rw"(c) : "rw"(x), "rw"(y));
+    out[gid] = c;
+}
@@ -0,0 +1,28 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// REQUIRES: ocloc
+// RUN: ocloc compile -file %s -device skl -out_dir %t 2>&1 | FileCheck %s
+
+// The operands of the fragment bind to the kernel's variables and the
+// kernel passes the vISA verifier.
+
+// CHECK: Build succeeded
+// CHECK-NOT: error
+
+__attribute__((intel_reqd_sub_group_size(16)))
+__kernel void test_add(__global int* out, __global const int* a, __global const int* b)
+{
+    int gid = get_global_id(0);
+    int x = a[gid];
+    int y = b[gid];
+    int c;
+    __asm__("add (M1, 16) %0(0, 0)<1> %1(0, 0)<1;1,0> %2(0, 0)<1;1,0>"
+            : "=rw"(c) : "rw"(x), "rw"(y));
+    out[gid] = c;
+}
@@ -0,0 +1,44 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2021 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+
+; RUN: igc_opt %s -S -o - -igc-lower-gp-arg | FileCheck %s
+
+target datalayout = "e-p:32:32:32-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f16:16:16-f32:32:32-f64:64:64-f80:128:128-v16:16:16-v24:32:32-v32:32:32-v48:64:64-v64:64:64-v96:128:128-v128:128:128-v192:256:256-v256:256:256-v512:512:512-v1024:1024:1024-a:64:64-f80:128:128-n8:16:32:64"
+
+; The callee is called with a global and with a local pointer, so it is
+; cloned and each version gets its own address space.
+
+; CHECK-LABEL: define void @kernel
+define void @kernel(i32 addrspace(1)* %global, i32 addrspace(3)* %local) {
+  %asc0 = addrspacecast i32 addrspace(1)* %global to i32 addrspace(4)*
+  %asc1 = addrspacecast i32 addrspace(3)* %local to i32 addrspace(4)*
+
+  ; CHECK: call void @callee(i32 addrspace(1)* %global)
+  call void @callee(i32 addrspace(4)* %asc0)
+  ; CHECK: call void @[[CLONE:callee.+]](i32 addrspace(3)* %local)
+  call void @callee(i32 addrspace(4)* %asc1)
+
+  ret void
+}
+
+; CHECK: define void @callee(i32 addrspace(1)* %src)
+; CHECK: store i32 0, i32 addrspace(1)* %src, align 4
+; CHECK: define void @[[CLONE]](i32 addrspace(3)* %src)
+; CHECK: store i32 0, i32 addrspace(3)* %src, align 4
+define void @callee(i32 addrspace(4)* %src) {
+  store i32 0, i32 addrspace(4)* %src, align 4
+  ret void
+}
+
+!igc.functions = !{!0, !3}
+
+!0 = !{void (i32 addrspace(1)*, i32 addrspace(3)*)* @kernel, !1}
+!3 = !{void (i32 addrspace(4)*)* @callee, !1}
+
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
@@ -0,0 +1,52 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2021 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+
+; RUN: env IGC_TestIGCPreCompiledFunctions=2 igc_opt --platformskl -igc-precompiled-import -S %s -o %t.ll
+; RUN: FileCheck %s --input-file=%t.ll --check-prefix=ADD-INLINE
+; RUN: FileCheck %s --input-file=%t.ll --check-prefix=MUL-INLINE
+; RUN: env IGC_TestIGCPreCompiledFunctions=2 IGC_InlinedEmulationThreshold=1 igc_opt --platformskl -igc-precompiled-import -S %s -o %t.total.ll
+; RUN: FileCheck %s --input-file=%t.total.ll --check-prefix=ADD-SUBROUTINE
+; RUN: FileCheck %s --input-file=%t.total.ll --check-prefix=MUL-SUBROUTINE
+; RUN: env IGC_TestIGCPreCompiledFunctions=2 IGC_InlinedEmulationCallerThreshold=1 igc_opt --platformskl -igc-precompiled-import -S %s -o %t.caller.ll
+; RUN: FileCheck %s --input-file=%t.caller.ll --check-prefix=ADD-SUBROUTINE
+; RUN: FileCheck %s --input-file=%t.caller.ll --check-prefix=MUL-SUBROUTINE
+
+; The double adds and multiplies are emulated, and each emulation function
+; has two calls that share an operand with another emulated operation.
+; Within the default budgets, and with the per-caller limit off by default,
+; both functions are inlined. Sharing operands does not exempt them from the
+; total budget, and a per-caller limit, once set, turns them into
+; subroutines as well.
+
+; ADD-INLINE: define internal {{.*}}@__igcbuiltin_dp_add({{.*}} #[[ATTR:[0-9]+]]
+; ADD-INLINE: attributes #[[ATTR]] = { {{.*}}alwaysinline
+; MUL-INLINE: define internal {{.*}}@__igcbuiltin_dp_mul({{.*}} #[[ATTR:[0-9]+]]
+; MUL-INLINE: attributes #[[ATTR]] = { {{.*}}alwaysinline
+
+; ADD-SUBROUTINE: define internal {{.*}}@__igcbuiltin_dp_add({{.*}} #[[ATTR:[0-9]+]]
+; ADD-SUBROUTINE: attributes #[[ATTR]] = { {{.*}}noinline
+; MUL-SUBROUTINE: define internal {{.*}}@__igcbuiltin_dp_mul({{.*}} #[[ATTR:[0-9]+]]
+; MUL-SUBROUTINE: attributes #[[ATTR]] = { {{.*}}noinline
+
+define spir_kernel void @test_shared(double addrspace(1)* %out, double %a, double %b, double %c) {
+entry:
+  %x = fadd double %a, %b
+  %y = fmul double %a, %c
+  %z = fadd double %x, %c
+  %w = fmul double %y, %b
+  store double %z, double addrspace(1)* %out, align 8
+  %p = getelementptr inbounds double, double addrspace(1)* %out, i64 1
+  store double %w, double addrspace(1)* %p, align 8
+  ret void
+}
+
+!igc.functions = !{!0}
+
+!0 = !{void (double addrspace(1)*, double, double, double)* @test_shared, !1}
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
@@ -0,0 +1,62 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2021 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+
+; RUN: env IGC_PrivateMemoryLayout=2 IGC_EnablePrivateMemoryBlockRead=1 igc_opt --platformxehp -igc-private-mem-resolution -S %s -o %t.ll
+; RUN: FileCheck %s --input-file=%t.ll
+
+; In an interleaved stateless alloca, a scalar load whose index is uniform
+; (here a kernel argument) becomes a SIMD block read from the lane-independent
+; base. The store and the load with a per-lane index stay scattered.
+
+; CHECK-LABEL: define spir_kernel void @test_block_read(
+; CHECK: [[SIMD:%.*]] = call i32 @llvm.genx.GenISA.simdSize()
+; CHECK: [[BUFOFF:%.*]] = mul i32 [[SIMD]], 0
+; CHECK: [[TOTAL64:%.*]] = zext i32 {{%.*}} to i64
+; CHECK: [[BASE:%.*]] = add i64 [[PB:%.*]], [[TOTAL64]]
+; CHECK: [[BUFOFF64:%.*]] = zext i32 [[BUFOFF]] to i64
+; CHECK: [[BRBASE:%.*]] = add i64 [[PB]], [[BUFOFF64]]
+
+; CHECK: [[SADDR:%.*]] = add i64 [[BASE]], {{%.*}}
+; CHECK: [[SPTR:%.*]] = inttoptr i64 [[SADDR]] to float addrspace(1)*
+; CHECK: store float 1.000000e+00, float addrspace(1)* [[SPTR]]
+
+; CHECK: [[OFF:%.*]] = zext i32 {{%.*}} to i64
+; CHECK: [[BRADDR:%.*]] = add i64 [[BRBASE]], [[OFF]]
+; CHECK: [[BRPTR:%.*]] = inttoptr i64 [[BRADDR]] to i32 addrspace(1)*
+; CHECK: [[BR:%.*]] = call i32 @llvm.genx.GenISA.simdBlockRead{{.*}}(i32 addrspace(1)* [[BRPTR]])
+; CHECK: [[X:%.*]] = bitcast i32 [[BR]] to float
+
+; CHECK: [[ADDR:%.*]] = add i64 [[BASE]], {{%.*}}
+; CHECK: [[PTR:%.*]] = inttoptr i64 [[ADDR]] to float addrspace(1)*
+; CHECK: [[Y:%.*]] = load float, float addrspace(1)* [[PTR]]
+; CHECK: fadd float [[X]], [[Y]]
+
+define spir_kernel void @test_block_read(float addrspace(1)* %out, i32 addrspace(1)* %in, i32 %i) {
+entry:
+  %k = load i32, i32 addrspace(1)* %in, align 4
+  %a = alloca [16 x float], align 4
+  %p = getelementptr inbounds [16 x float], [16 x float]* %a, i32 0, i32 %k
+  store float 1.0, float* %p, align 4
+  %q = getelementptr inbounds [16 x float], [16 x float]* %a, i32 0, i32 %i
+  %x = load float, float* %q, align 4
+  %r = getelementptr inbounds [16 x float], [16 x float]* %a, i32 0, i32 %k
+  %y = load float, float* %r, align 4
+  %s = fadd float %x, %y
+  store float %s, float addrspace(1)* %out, align 4
+  ret void
+}
+
+!igc.functions = !{!0}
+!IGCMetadata = !{!3}
+
+!0 = !{void (float addrspace(1)*, i32 addrspace(1)*, i32)* @test_block_read, !1}
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
+!3 = !{!"ModuleMD", !4}
+!4 = !{!"compOpt", !5}
+!5 = !{!"OptDisable", i1 true}
@@ -0,0 +1,97 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2021 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+
+; RUN: env IGC_PrivateMemoryLayout=0 igc_opt --platformxehp -igc-private-mem-resolution -S %s -o %t.0.ll
+; RUN: FileCheck %s --input-file=%t.0.ll --check-prefix=MODEL
+; RUN: env IGC_PrivateMemoryLayout=0 IGC_EnablePrivateMemoryBlockRead=1 igc_opt --platformxehp -igc-private-mem-resolution -S %s -o %t.br.ll
+; RUN: FileCheck %s --input-file=%t.br.ll --check-prefix=BLOCKREAD
+; RUN: env IGC_PrivateMemoryLayout=1 igc_opt --platformxehp -igc-private-mem-resolution -S %s -o %t.1.ll
+; RUN: FileCheck %s --input-file=%t.1.ll --check-prefix=PERLANE
+; RUN: env IGC_PrivateMemoryLayout=2 igc_opt --platformxehp -igc-private-mem-resolution -S %s -o %t.2.ll
+; RUN: FileCheck %s --input-file=%t.2.ll --check-prefix=INTERLEAVED
+
+; The layout shows in the per-lane offset: a lane is one element (4 bytes)
+; away from the next in the interleaved layout and a whole array (64 bytes)
+; away in the per-lane layout.
+;
+; @uniform_index only accesses elements at uniform indices. Its load can
+; become a block read when interleaved, so the cost model interleaves it
+; only when block reads are enabled. Without them both layouts cost the
+; same and the tie keeps it per lane.
+; @vector_access loads a vector at a per-lane index, which the interleaved
+; layout would split into four scattered loads, so the cost model keeps it
+; per lane.
+
+; MODEL-LABEL: define spir_kernel void @uniform_index(
+; MODEL: [[LANE:%.*]] = zext i16 {{%.*}} to i32
+; MODEL: mul i32 [[LANE]], 64{{$}}
+; MODEL-LABEL: define spir_kernel void @vector_access(
+; MODEL: [[LANE:%.*]] = zext i16 {{%.*}} to i32
+; MODEL: mul i32 [[LANE]], 64{{$}}
+; MODEL: load <4 x float>, <4 x float> addrspace(1)*
+
+; BLOCKREAD-LABEL: define spir_kernel void @uniform_index(
+; BLOCKREAD: [[LANE:%.*]] = zext i16 {{%.*}} to i32
+; BLOCKREAD: mul i32 [[LANE]], 4{{$}}
+; BLOCKREAD: call i32 @llvm.genx.GenISA.simdBlockRead
+; BLOCKREAD-LABEL: define spir_kernel void @vector_access(
+; BLOCKREAD: [[LANE:%.*]] = zext i16 {{%.*}} to i32
+; BLOCKREAD: mul i32 [[LANE]], 64{{$}}
+; BLOCKREAD: load <4 x float>, <4 x float> addrspace(1)*
+
+; PERLANE-LABEL: define spir_kernel void @uniform_index(
+; PERLANE: [[LANE:%.*]] = zext i16 {{%.*}} to i32
+; PERLANE: mul i32 [[LANE]], 64{{$}}
+; PERLANE-LABEL: define spir_kernel void @vector_access(
+; PERLANE: [[LANE:%.*]] = zext i16 {{%.*}} to i32
+; PERLANE: mul i32 [[LANE]], 64{{$}}
+; PERLANE: load <4 x float>, <4 x float> addrspace(1)*
+
+; INTERLEAVED-LABEL: define spir_kernel void @uniform_index(
+; INTERLEAVED: [[LANE:%.*]] = zext i16 {{%.*}} to i32
+; INTERLEAVED: mul i32 [[LANE]], 4{{$}}
+; INTERLEAVED-LABEL: define spir_kernel void @vector_access(
+; INTERLEAVED: [[LANE:%.*]] = zext i16 {{%.*}} to i32
+; INTERLEAVED: mul i32 [[LANE]], 4{{$}}
+; INTERLEAVED-NOT: load <4 x float>
+; INTERLEAVED-COUNT-4: load float, float addrspace(1)*
+
+define spir_kernel void @uniform_index(float addrspace(1)* %out, i32 %i, float %v) {
+entry:
+  %a = alloca [16 x float], align 4
+  %p = getelementptr inbounds [16 x float], [16 x float]* %a, i32 0, i32 %i
+  store float %v, float* %p, align 4
+  %i1 = add i32 %i, 1
+  %q = getelementptr inbounds [16 x float], [16 x float]* %a, i32 0, i32 %i1
+  %x = load float, float* %q, align 4
+  store float %x, float addrspace(1)* %out, align 4
+  ret void
+}
+
+define spir_kernel void @vector_access(<4 x float> addrspace(1)* %out, i32 addrspace(1)* %in, float %v) {
+entry:
+  %k = load i32, i32 addrspace(1)* %in, align 4
+  %a = alloca [4 x <4 x float>], align 16
+  %p = getelementptr inbounds [4 x <4 x float>], [4 x <4 x float>]* %a, i32 0, i32 %k, i32 0
+  store float %v, float* %p, align 4
+  %q = getelementptr inbounds [4 x <4 x float>], [4 x <4 x float>]* %a, i32 0, i32 %k
+  %x = load <4 x float>, <4 x float>* %q, align 16
+  store <4 x float> %x, <4 x float> addrspace(1)* %out, align 16
+  ret void
+}
+
+!igc.functions = !{!0, !3}
+!IGCMetadata = !{!4}
+
+!0 = !{void (float addrspace(1)*, i32, float)* @uniform_index, !1}
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
+!3 = !{void (<4 x float> addrspace(1)*, i32 addrspace(1)*, float)* @vector_access, !1}
+!4 = !{!"ModuleMD", !5}
+!5 = !{!"compOpt", !6}
+!6 = !{!"OptDisable", i1 true}
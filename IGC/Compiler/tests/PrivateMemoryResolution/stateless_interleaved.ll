@@ -0,0 +1,60 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2021 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+
+; RUN: env IGC_PrivateMemoryLayout=2 igc_opt --platformxehp -igc-private-mem-resolution -S %s -o %t.ll
+; RUN: FileCheck %s --input-file=%t.ll
+
+; Private memory is stateless because OptDisable rules out the scratch
+; surface. The alloca is interleaved across SIMD lanes: each lane is offset
+; by one element, and element i of all lanes starts at i * simdSize * 4.
+; The offsets are computed in 32 bits and widened to the 64-bit base.
+
+; CHECK-LABEL: define spir_kernel void @test_interleaved(
+; CHECK: [[LANE16:%.*]] = call i16 @llvm.genx.GenISA.simdLaneId()
+; CHECK: [[LANE:%.*]] = zext i16 [[LANE16]] to i32
+; CHECK: [[SIMD:%.*]] = call i32 @llvm.genx.GenISA.simdSize()
+; CHECK: [[PERLANE:%.*]] = mul i32 [[LANE]], 4
+; CHECK: [[TOTAL:%.*]] = add i32 {{%.*}}, [[PERLANE]]
+; CHECK: [[TOTAL64:%.*]] = zext i32 [[TOTAL]] to i64
+; CHECK: [[BASE:%.*]] = add i64 {{%.*}}, [[TOTAL64]]
+
+; CHECK: [[STRIDE:%.*]] = mul i32 [[SIMD]], 4
+; CHECK: [[OFF:%.*]] = mul i32 {{%.*}}, [[STRIDE]]
+; CHECK: [[OFF64:%.*]] = zext i32 [[OFF]] to i64
+; CHECK: [[ADDR:%.*]] = add i64 [[BASE]], [[OFF64]]
+; CHECK: [[PTR:%.*]] = inttoptr i64 [[ADDR]] to float addrspace(1)*
+; CHECK: store float %v, float addrspace(1)* [[PTR]]
+
+; CHECK: [[STRIDE2:%.*]] = mul i32 [[SIMD]], 4
+; CHECK: [[OFF2:%.*]] = mul i32 3, [[STRIDE2]]
+; CHECK: [[OFF2_64:%.*]] = zext i32 [[OFF2]] to i64
+; CHECK: [[ADDR2:%.*]] = add i64 [[BASE]], [[OFF2_64]]
+; CHECK: [[PTR2:%.*]] = inttoptr i64 [[ADDR2]] to float addrspace(1)*
+; CHECK: [[X:%.*]] = load float, float addrspace(1)* [[PTR2]]
+; CHECK: store float [[X]], float addrspace(1)* %out
+
+define spir_kernel void @test_interleaved(float addrspace(1)* %out, i32 %i, float %v) {
+entry:
+  %a = alloca [16 x float], align 4
+  %p = getelementptr inbounds [16 x float], [16 x float]* %a, i32 0, i32 %i
+  store float %v, float* %p, align 4
+  %q = getelementptr inbounds [16 x float], [16 x float]* %a, i32 0, i32 3
+  %x = load float, float* %q, align 4
+  store float %x, float addrspace(1)* %out, align 4
+  ret void
+}
+
+!igc.functions = !{!0}
+!IGCMetadata = !{!3}
+
+!0 = !{void (float addrspace(1)*, i32, float)* @test_interleaved, !1}
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
+!3 = !{!"ModuleMD", !4}
+!4 = !{!"compOpt", !5}
+!5 = !{!"OptDisable", i1 true}
@@ -0,0 +1,116 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2021 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+
+; RUN: env IGC_SIMDSpillPrediction=2 igc_opt -simd-spill-prediction -analyze %s | FileCheck %s
+
+; 48 floats are live at once after the multiplies: one GRF each at SIMD8, two
+; at SIMD16 and four at SIMD32, where they exceed the 128 GRFs per thread.
+
+; CHECK: SIMD spill prediction for test_pressure (128 GRFs per thread):
+; CHECK-NEXT: SIMD8: {{[0-9]+}} GRFs, no-spill
+; CHECK-NEXT: SIMD16: {{[0-9]+}} GRFs, no-spill
+; CHECK-NEXT: SIMD32: {{[0-9]+}} GRFs, spill, skipped
+
+define float @test_pressure(float %a0, float %a1, float %a2, float %a3, float %a4, float %a5, float %a6, float %a7, float %a8, float %a9, float %a10, float %a11, float %a12, float %a13, float %a14, float %a15, float %a16, float %a17, float %a18, float %a19, float %a20, float %a21, float %a22, float %a23, float %a24, float %a25, float %a26, float %a27, float %a28, float %a29, float %a30, float %a31, float %a32, float %a33, float %a34, float %a35, float %a36, float %a37, float %a38, float %a39, float %a40, float %a41, float %a42, float %a43, float %a44, float %a45, float %a46, float %a47) {
+  %m0 = fmul float %a0, %a0
+  %m1 = fmul float %a1, %a1
+  %m2 = fmul float %a2, %a2
+  %m3 = fmul float %a3, %a3
+  %m4 = fmul float %a4, %a4
+  %m5 = fmul float %a5, %a5
+  %m6 = fmul float %a6, %a6
+  %m7 = fmul float %a7, %a7
+  %m8 = fmul float %a8, %a8
+  %m9 = fmul float %a9, %a9
+  %m10 = fmul float %a10, %a10
+  %m11 = fmul float %a11, %a11
+  %m12 = fmul float %a12, %a12
+  %m13 = fmul float %a13, %a13
+  %m14 = fmul float %a14, %a14
+  %m15 = fmul float %a15, %a15
+  %m16 = fmul float %a16, %a16
+  %m17 = fmul float %a17, %a17
+  %m18 = fmul float %a18, %a18
+  %m19 = fmul float %a19, %a19
+  %m20 = fmul float %a20, %a20
+  %m21 = fmul float %a21, %a21
+  %m22 = fmul float %a22, %a22
+  %m23 = fmul float %a23, %a23
+  %m24 = fmul float %a24, %a24
+  %m25 = fmul float %a25, %a25
+  %m26 = fmul float %a26, %a26
+  %m27 = fmul float %a27, %a27
+  %m28 = fmul float %a28, %a28
+  %m29 = fmul float %a29, %a29
+  %m30 = fmul float %a30, %a30
+  %m31 = fmul float %a31, %a31
+  %m32 = fmul float %a32, %a32
+  %m33 = fmul float %a33, %a33
+  %m34 = fmul float %a34, %a34
+  %m35 = fmul float %a35, %a35
+  %m36 = fmul float %a36, %a36
+  %m37 = fmul float %a37, %a37
+  %m38 = fmul float %a38, %a38
+  %m39 = fmul float %a39, %a39
+  %m40 = fmul float %a40, %a40
+  %m41 = fmul float %a41, %a41
+  %m42 = fmul float %a42, %a42
+  %m43 = fmul float %a43, %a43
+  %m44 = fmul float %a44, %a44
+  %m45 = fmul float %a45, %a45
+  %m46 = fmul float %a46, %a46
+  %m47 = fmul float %a47, %a47
+  %s0 = fadd float %m0, %m1
+  %s1 = fadd float %s0, %m2
+  %s2 = fadd float %s1, %m3
+  %s3 = fadd float %s2, %m4
+  %s4 = fadd float %s3, %m5
+  %s5 = fadd float %s4, %m6
+  %s6 = fadd float %s5, %m7
+  %s7 = fadd float %s6, %m8
+  %s8 = fadd float %s7, %m9
+  %s9 = fadd float %s8, %m10
+  %s10 = fadd float %s9, %m11
+  %s11 = fadd float %s10, %m12
+  %s12 = fadd float %s11, %m13
+  %s13 = fadd float %s12, %m14
+  %s14 = fadd float %s13, %m15
+  %s15 = fadd float %s14, %m16
+  %s16 = fadd float %s15, %m17
+  %s17 = fadd float %s16, %m18
+  %s18 = fadd float %s17, %m19
+  %s19 = fadd float %s18, %m20
+  %s20 = fadd float %s19, %m21
+  %s21 = fadd float %s20, %m22
+  %s22 = fadd float %s21, %m23
+  %s23 = fadd float %s22, %m24
+  %s24 = fadd float %s23, %m25
+  %s25 = fadd float %s24, %m26
+  %s26 = fadd float %s25, %m27
+  %s27 = fadd float %s26, %m28
+  %s28 = fadd float %s27, %m29
+  %s29 = fadd float %s28, %m30
+  %s30 = fadd float %s29, %m31
+  %s31 = fadd float %s30, %m32
+  %s32 = fadd float %s31, %m33
+  %s33 = fadd float %s32, %m34
+  %s34 = fadd float %s33, %m35
+  %s35 = fadd float %s34, %m36
+  %s36 = fadd float %s35, %m37
+  %s37 = fadd float %s36, %m38
+  %s38 = fadd float %s37, %m39
+  %s39 = fadd float %s38, %m40
+  %s40 = fadd float %s39, %m41
+  %s41 = fadd float %s40, %m42
+  %s42 = fadd float %s41, %m43
+  %s43 = fadd float %s42, %m44
+  %s44 = fadd float %s43, %m45
+  %s45 = fadd float %s44, %m46
+  %s46 = fadd float %s45, %m47
+  ret float %s46
+}
@@ -0,0 +1,65 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2021 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+
+; RUN: igc_opt -GenXCodeGenModule -igc-stateless-to-statefull-resolution -S %s -o %t.ll
+; RUN: FileCheck %s --input-file=%t.ll
+
+; A kernel argument buffer is passed down a kernel -> helper -> helper chain.
+; Each helper gets an i32 offset into the buffer next to the pointer, computed
+; at the call site, and its accesses use the offset statefully.
+
+; CHECK-LABEL: define spir_kernel void @kernel(
+; CHECK: [[KOFF:%.*]] = add i32 0, 16
+; CHECK: call spir_func void @helper1(float addrspace(1)* %p, i32 [[KOFF]])
+define spir_kernel void @kernel(float addrspace(1)* %buf) {
+  %p = getelementptr inbounds float, float addrspace(1)* %buf, i64 4
+  call spir_func void @helper1(float addrspace(1)* %p)
+  ret void
+}
+
+; CHECK-LABEL: define internal spir_func void @helper1(float addrspace(1)* %a, i32 %a.offset)
+; CHECK: add i32 %a.offset, 8
+; CHECK: call spir_func void @helper2(float addrspace(1)* %q, i32 %{{.*}})
+; CHECK: [[LPTR:%.*]] = inttoptr i32 %a.offset to float addrspace([[AS:[0-9]+]])*
+; CHECK: load float, float addrspace([[AS]])* [[LPTR]], align 4
+define internal spir_func void @helper1(float addrspace(1)* %a) {
+  %q = getelementptr inbounds float, float addrspace(1)* %a, i64 2
+  call spir_func void @helper2(float addrspace(1)* %q)
+  %v = load float, float addrspace(1)* %a, align 4
+  store float %v, float addrspace(1)* %q, align 4
+  ret void
+}
+
+; CHECK-LABEL: define internal spir_func void @helper2(float addrspace(1)* %b, i32 %b.offset)
+; CHECK: [[SPTR:%.*]] = inttoptr i32 %b.offset to float addrspace([[AS]])*
+; CHECK: store float 1.000000e+00, float addrspace([[AS]])* [[SPTR]], align 4
+define internal spir_func void @helper2(float addrspace(1)* %b) {
+  store float 1.0, float addrspace(1)* %b, align 4
+  ret void
+}
+
+!igc.functions = !{!0, !3, !4}
+!IGCMetadata = !{!6}
+
+!0 = !{void (float addrspace(1)*)* @kernel, !1}
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
+!3 = !{void (float addrspace(1)*)* @helper1, !5}
+!4 = !{void (float addrspace(1)*)* @helper2, !5}
+!5 = !{!{!"function_type", i32 2}}
+
+!6 = !{!"ModuleMD", !7}
+!7 = !{!"FuncMD", !8, !9}
+!8 = !{!"FuncMDMap[0]", void (float addrspace(1)*)* @kernel}
+!9 = !{!"FuncMDValue[0]", !10}
+!10 = !{!"resAllocMD", !11}
+!11 = !{!"argAllocMDList", !12}
+!12 = !{!"argAllocMDListVec[0]", !13, !14, !15}
+!13 = !{!"type", i32 1}
+!14 = !{!"extensionType", i32 -1}
+!15 = !{!"indexType", i32 0}
@@ -0,0 +1,45 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// REQUIRES: ocloc
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: env IGC_ShaderDumpEnable=1 IGC_DumpToCustomDir=%t/ ocloc compile -file %s -device skl -out_dir %t 2>&1 | FileCheck %s --check-prefix=BUILD
+// RUN: cat %t/*afterUnification.ll | FileCheck %s
+
+// The work group of 24 items runs as one full SIMD16 subgroup and one
+// partial subgroup of 8 lanes. The partial subgroup still adds the prefix
+// of the full one, and subgroup 0 returns its own scan without adding the
+// empty prefix, so a -0.0 input is not turned into +0.0.
+
+// BUILD: Build succeeded
+
+// CHECK-LABEL: define spir_kernel void @scan_incl
+// CHECK: icmp eq i32 {{.*}}, 0
+// CHECK: fadd {{.*}}float
+// CHECK: {{select i1 .*, float .*, float|phi float}}
+
+// CHECK-LABEL: define spir_kernel void @scan_excl
+// CHECK: icmp eq i32 {{.*}}, 0
+// CHECK: fadd {{.*}}float
+// CHECK: {{select i1 .*, float .*, float|phi float}}
+
+__attribute__((reqd_work_group_size(24, 1, 1)))
+__attribute__((intel_reqd_sub_group_size(16)))
+__kernel void scan_incl(__global float* out, __global const float* in)
+{
+    size_t lid = get_local_id(0);
+    out[lid] = work_group_scan_inclusive_add(in[lid]);
+}
+
+__attribute__((reqd_work_group_size(24, 1, 1)))
+__attribute__((intel_reqd_sub_group_size(16)))
+__kernel void scan_excl(__global float* out, __global const float* in)
+{
+    size_t lid = get_local_id(0);
+    out[lid] = work_group_scan_exclusive_add(in[lid]);
+}
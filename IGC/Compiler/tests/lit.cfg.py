@@ -24,7 +24,7 @@ config.name = 'IGC'
 config.test_format = lit.formats.ShTest(not llvm_config.use_lit_shell)
 
 # suffixes: A list of file extensions to treat as test files.
-config.suffixes = ['.ll']
+config.suffixes = ['.ll', '.cl']
 
 # excludes: A list of directories  and files to exclude from the testsuite.
 config.excludes = ['CMakeLists.txt']
@@ -43,3 +43,8 @@ tool_dirs = [config.igc_opt_dir, config.llvm_tools_dir]
 tools = [ToolSubst('igc_opt')]
 
 llvm_config.add_tool_substitutions(tools, tool_dirs)
+
+# The OpenCL C tests go through the whole compiler and need ocloc. They are
+# reported as unsupported when it is not on PATH.
+if lit.util.which('ocloc', config.environment['PATH']):
+    config.available_features.add('ocloc')
@@ -2736,7 +2736,7 @@ IGC::DIEBlock* CompileUnit::buildGeneral(const DbgVariable& var,
         const auto* loc = &locV;
         int64_t offset = 0;
 
-        const auto* storageMD = var.getDbgInst()->getMetadata("StorageOffset");
+        const auto* storageMD = var.getDbgInst()->getMetadata(DD->getStorageOffsetMDKind());
         const auto* VISAMod = loc->GetVISAModule();
         IGC_ASSERT_MESSAGE(VISAMod, "VISA Module is expected for LOC");
 
@@ -2883,7 +2883,7 @@ IGC::DIEBlock* CompileUnit::buildGeneral(const DbgVariable& var,
             }
         }
 
-        const auto* sizeMD = var.getDbgInst()->getMetadata("StorageSize");
+        const auto* sizeMD = var.getDbgInst()->getMetadata(DD->getStorageSizeMDKind());
         if (storageMD && (EmitSettings.EmitOffsetInDbgLoc || EmitSettings.UseOffsetInLocation) && sizeMD)
         {
             LLVM_DEBUG(dbgs() << "  generating FP-based location\n");
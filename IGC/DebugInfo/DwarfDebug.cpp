@@ -385,6 +385,9 @@ void DwarfDISubprogramCache::updateDISPCache(const llvm::Function *F)
 DwarfDISubprogramCache::DISubprogramNodes
 DwarfDISubprogramCache::findNodes (const std::vector<Function*>& Functions)
 {
+    // the cache is shared by the kernels whose debug info is emitted in parallel
+    std::lock_guard<std::mutex> Lock(Mutex);
+
     DISubprogramNodes Result;
     // to ensure that Result does not contain duplicates
     std::unordered_set<const llvm::DISubprogram*> UniqueDISP;
@@ -435,6 +438,10 @@ DwarfDebug::DwarfDebug(StreamEmitter* A, VISAModule* M) :
     ModuleBeginSym = ModuleEndSym = nullptr;;
 
     DwarfVersion = getDwarfVersionFromModule(M->GetModule());
+
+    llvm::LLVMContext& Ctx = M->GetModule()->getContext();
+    StorageOffsetMDKind = Ctx.getMDKindID("StorageOffset");
+    StorageSizeMDKind = Ctx.getMDKindID("StorageSize");
 }
 
 DwarfDebug::~DwarfDebug()
@@ -1149,9 +1156,11 @@ void DwarfDebug::ExtractConstantData(const llvm::Constant* ConstVal,
     else if (const ConstantDataSequential *cds =
              dyn_cast<ConstantDataSequential>(ConstVal))
     {
-        for (unsigned i = 0; i < cds->getNumElements(); i++) {
-            ExtractConstantData(cds->getElementAsConstant(i), Result);
-        }
+        // Read the elements' raw bytes: getElementAsConstant would create
+        // constants in the LLVMContext, which is shared by the threads
+        // emitting debug info.
+        StringRef rawData = cds->getRawDataValues();
+        Result.insert(Result.end(), rawData.begin(), rawData.end());
     }
     else if (const ConstantAggregateZero * cag = dyn_cast<ConstantAggregateZero>(ConstVal))
     {
@@ -1167,11 +1176,13 @@ void DwarfDebug::ExtractConstantData(const llvm::Constant* ConstVal,
              ConstVal->getType()->isArrayTy() ||
              ConstVal->getType()->isStructTy())
     {
+        // Take the elements from the operands rather than through
+        // getAggregateElement, which may create constants (see above).
         const int numElts = ConstVal->getNumOperands();
         for (int i = 0; i < numElts; ++i)
         {
-            Constant* C = ConstVal->getAggregateElement(i);
-            IGC_ASSERT_MESSAGE(C, "getAggregateElement returned null, unsupported constant");
+            const Constant* C = cast<Constant>(ConstVal->getOperand(i));
+            IGC_ASSERT_MESSAGE(C, "null aggregate element, unsupported constant");
             // Since the type may not be primitive, extra alignment is required.
             ExtractConstantData(C, Result);
         }
@@ -2354,8 +2365,10 @@ void DwarfDebug::identifyScopeMarkers()
 }
 
 // Walk up the scope chain of given debug loc and find line number info
-// for the function.
-static DebugLoc getFnDebugLoc(DebugLoc DL, const LLVMContext& Ctx)
+// for the function. The location is returned as the subprogram and its line
+// rather than as a new DILocation, so that emitting debug info never creates
+// metadata in the (shared) LLVMContext.
+static DISubprogram* getFnDebugLoc(DebugLoc DL, unsigned& Line)
 {
     // Get MDNode for DebugLoc's scope.
     while (DILocation * InlinedAt = DL.getInlinedAt())
@@ -2369,13 +2382,12 @@ static DebugLoc getFnDebugLoc(DebugLoc DL, const LLVMContext& Ctx)
     {
         // Check for number of operands since the compatibility is cheap here.
         if (SP->getNumOperands() > 19)
-        {
-            return DILocation::get(SP->getContext(), SP->getScopeLine(), 0, SP);
-        }
-        return DILocation::get(SP->getContext(), SP->getLine(), 0, SP);
+            Line = SP->getScopeLine();
+        else
+            Line = SP->getLine();
     }
 
-    return DebugLoc();
+    return SP;
 }
 
 // Gather pre-function debug information.  Assumes being called immediately
@@ -2501,11 +2513,11 @@ void DwarfDebug::beginFunction(const Function* MF, IGC::VISAModule* v)
     // Record beginning of function.
     if (PrologEndLoc)
     {
-        DebugLoc FnStartDL = getFnDebugLoc(PrologEndLoc, MF->getContext());
-        const MDNode* Scope = FnStartDL.getScope();
+        unsigned FnStartLine = 0;
+        const DISubprogram* Scope = getFnDebugLoc(PrologEndLoc, FnStartLine);
         // We'd like to list the prologue as "not statements" but GDB behaves
         // poorly if we do that. Revisit this with caution/GDB (7.5+) testing.
-        recordSourceLine(FnStartDL.getLine(), FnStartDL.getCol(), Scope, DWARF2_FLAG_IS_STMT);
+        recordSourceLine(FnStartLine, 0, Scope, DWARF2_FLAG_IS_STMT);
     }
 }
 
@@ -39,6 +39,7 @@ See LICENSE.TXT for details.
 
 #include "EmitterOpts.hpp"
 
+#include <mutex>
 #include <set>
 #include "Probe/Assertion.h"
 
@@ -264,10 +265,12 @@ namespace IGC
     //    subprograms ever referenced in this kernel (+ it's recursive
     //    callees). We skip emitting declaration DIEs for which no code is
     //    emitted in current kernel.
+    // findNodes may be called concurrently by kernels emitted in parallel.
     class DwarfDISubprogramCache
     {
         using DISubprogramNodes = std::vector<llvm::DISubprogram*>;
         std::unordered_map<const llvm::Function*, DISubprogramNodes> DISubprograms;
+        std::mutex Mutex;
 
         void updateDISPCache(const llvm::Function *F);
     public:
@@ -414,6 +417,13 @@ namespace IGC
         // Version of llvm::dwarf we're emitting.
         unsigned DwarfVersion;
 
+        // Kind IDs of the StorageOffset and StorageSize metadata. Looking a
+        // kind up by name may register it in the LLVMContext, so they are
+        // resolved when the emitter is created, before any debug info is
+        // emitted on a worker thread.
+        unsigned StorageOffsetMDKind;
+        unsigned StorageSizeMDKind;
+
         // A pointer to all units in the section.
         llvm::SmallVector<CompileUnit*, 1> CUs;
 
@@ -630,6 +640,9 @@ namespace IGC
         /// Returns the Dwarf Version.
         unsigned getDwarfVersion() const { return DwarfVersion; }
 
+        unsigned getStorageOffsetMDKind() const { return StorageOffsetMDKind; }
+        unsigned getStorageSizeMDKind() const { return StorageSizeMDKind; }
+
         /// Find the MDNode for the given reference.
         template <typename T> inline T* resolve(T* Ref) const
         {
@@ -0,0 +1,58 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include <stdint.h>
+
+#pragma once
+
+namespace IGCMetrics
+{
+    // "IGML"
+    constexpr uint32_t LIGHT_METRICS_MAGIC = 0x4C4D4749;
+    // Bump whenever the layout of IGCLightMetrics changes.
+    constexpr uint32_t LIGHT_METRICS_VERSION = 1;
+    constexpr unsigned LIGHT_METRICS_HIST_BUCKETS = 16;
+
+    // Per-program metrics cheap enough to collect on every compilation. The
+    // record only holds fixed-size counters and histograms updated at the
+    // existing metric hook points; it is attached to the output binary as
+    // the .misc.igc_metrics section and summed over many programs with
+    // Metrics/aggregate_light_metrics.py.
+    //
+    // All fields are little-endian uint32_t so that the record can be read
+    // without IGC headers. Histogram bucket 0 counts zero values and bucket
+    // i > 0 counts values in [2^(i-1), 2^i), the last bucket is open-ended.
+    // Kernel counts include every vISA compilation, so a kernel compiled in
+    // several SIMD widths or recompiled on retry is counted each time.
+    struct IGCLightMetrics
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t size;
+
+        uint32_t numKernels;
+        uint32_t numKernelsSIMD8;
+        uint32_t numKernelsSIMD16;
+        uint32_t numKernelsSIMD32;
+        uint32_t numSpillingKernels;
+        uint32_t numRetries;
+        uint32_t numEmulatedInsts;
+
+        // From the first IR unification to the binary emission.
+        uint32_t compileTimeUs;
+
+        uint32_t instCountHist[LIGHT_METRICS_HIST_BUCKETS];
+        // Bytes of GRF spill and fill code per kernel.
+        uint32_t spillBytesHist[LIGHT_METRICS_HIST_BUCKETS];
+        // Sum of the static cycle estimates per kernel.
+        uint32_t staticCyclesHist[LIGHT_METRICS_HIST_BUCKETS];
+    };
+
+    static_assert(sizeof(IGCLightMetrics) % sizeof(uint32_t) == 0,
+        "IGCLightMetrics must be made of uint32_t fields only");
+}
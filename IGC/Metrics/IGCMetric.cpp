@@ -39,6 +39,26 @@ namespace IGCMetrics
         get(igcMetric)->OutputMetrics();
     }
 
+    bool IGCMetric::EnableLight() const
+    {
+        return get(igcMetric)->EnableLight();
+    }
+
+    void IGCMetric::StatRetry()
+    {
+        get(igcMetric)->StatRetry();
+    }
+
+    void IGCMetric::FinalizeLightMetrics()
+    {
+        get(igcMetric)->FinalizeLightMetrics();
+    }
+
+    const IGCLightMetrics* IGCMetric::GetLightMetrics() const
+    {
+        return get(igcMetric)->GetLightMetrics();
+    }
+
     void IGCMetric::StatBeginEmuFunc(llvm::Instruction* instruction)
     {
         get(igcMetric)->StatBeginEmuFunc(instruction);
@@ -59,6 +79,11 @@ namespace IGCMetrics
         get(igcMetric)->CollectRegStats(kernelInfo);
     }
 
+    void IGCMetric::CollectISAStats(llvm::Function* pFunc, unsigned simdSize, const VISA_KERNEL_STATS* isaStats)
+    {
+        get(igcMetric)->CollectISAStats(pFunc, simdSize, isaStats);
+    }
+
     void IGCMetric::CollectFunctions(llvm::Module* pModule)
     {
         get(igcMetric)->CollectFunctions(pModule);
@@ -16,6 +16,8 @@ SPDX-License-Identifier: MIT
 #include <3d/common/iStdLib/types.h>
 #include <common/shaderHash.hpp>
 #include "KernelInfo.h"
+#include "JitterDataStruct.h"
+#include "IGCLightMetrics.h"
 
 #pragma once
 
@@ -44,8 +46,17 @@ namespace IGCMetrics
 
         void CollectRegStats(KERNEL_INFO* vISAstats);
 
+        void CollectISAStats(llvm::Function* pFunc, unsigned simdSize, const VISA_KERNEL_STATS* isaStats);
+
         void FinalizeStats();
 
         void OutputMetrics();
+
+        // Lightweight metrics, see IGCLightMetrics.h
+        bool EnableLight() const;
+        void StatRetry();
+        void FinalizeLightMetrics();
+        // nullptr if lightweight metrics are disabled
+        const IGCLightMetrics* GetLightMetrics() const;
     };
 }
@@ -62,6 +62,18 @@ namespace IGCMetrics
 
     void IGCMetricImpl::Init(ShaderHash* Hash, bool isEnabled)
     {
+        // Init runs again for every retry, the lightweight metrics cover the
+        // whole compilation.
+        if (!isLightStarted && IGC_IS_FLAG_ENABLED(EnableLightMetrics))
+        {
+            isLightEnabled = true;
+            isLightStarted = true;
+            lightStartTime = std::chrono::steady_clock::now();
+            lightMetrics.magic = LIGHT_METRICS_MAGIC;
+            lightMetrics.version = LIGHT_METRICS_VERSION;
+            lightMetrics.size = sizeof(IGCLightMetrics);
+        }
+
         this->isEnabled = isEnabled;
         if (!Enable()) return;
 #ifdef IGC_METRICS__PROTOBUF_ATTACHED
@@ -112,6 +124,36 @@ namespace IGCMetrics
 #endif
     }
 
+    static unsigned GetLightHistBucket(uint64_t value)
+    {
+        unsigned bucket = 0;
+        while (value != 0 && bucket < LIGHT_METRICS_HIST_BUCKETS - 1)
+        {
+            value >>= 1;
+            bucket++;
+        }
+        return bucket;
+    }
+
+    void IGCMetricImpl::StatRetry()
+    {
+        if (!EnableLight()) return;
+        lightMetrics.numRetries++;
+    }
+
+    void IGCMetricImpl::FinalizeLightMetrics()
+    {
+        if (!EnableLight()) return;
+        auto elapsed = std::chrono::steady_clock::now() - lightStartTime;
+        lightMetrics.compileTimeUs = (uint32_t)
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    }
+
+    const IGCLightMetrics* IGCMetricImpl::GetLightMetrics() const
+    {
+        return EnableLight() ? &lightMetrics : nullptr;
+    }
+
     void IGCMetricImpl::StatBeginEmuFunc(llvm::Instruction* instruction)
     {
         if (!Enable()) return;
@@ -142,6 +184,12 @@ namespace IGCMetrics
 
     void IGCMetricImpl::StatEndEmuFunc(llvm::Instruction* emulatedInstruction)
     {
+        // Counted here rather than in StatBeginEmuFunc, which is also called
+        // for instructions that end up not being emulated.
+        if (EnableLight())
+        {
+            lightMetrics.numEmulatedInsts++;
+        }
         if (!Enable()) return;
 #ifdef IGC_METRICS__PROTOBUF_ATTACHED
         llvm::DILocation* debLoc = (llvm::DILocation*)emulatedInstruction->getDebugLoc();
@@ -277,6 +325,88 @@ namespace IGCMetrics
 #endif
     }
 
+    void IGCMetricImpl::CollectISAStats(llvm::Function* pFunc, unsigned simdSize, const VISA_KERNEL_STATS* isaStats)
+    {
+        if (EnableLight() && isaStats != nullptr)
+        {
+            lightMetrics.numKernels++;
+            switch (simdSize)
+            {
+            case 8:  lightMetrics.numKernelsSIMD8++;  break;
+            case 16: lightMetrics.numKernelsSIMD16++; break;
+            case 32: lightMetrics.numKernelsSIMD32++; break;
+            default: break;
+            }
+            uint32_t spillBytes = isaStats->spillBytes + isaStats->fillBytes;
+            if (spillBytes > 0)
+            {
+                lightMetrics.numSpillingKernels++;
+            }
+            lightMetrics.instCountHist[GetLightHistBucket(isaStats->numInsts)]++;
+            lightMetrics.spillBytesHist[GetLightHistBucket(spillBytes)]++;
+            lightMetrics.staticCyclesHist[GetLightHistBucket(isaStats->staticCycles)]++;
+        }
+        if (!Enable()) return;
+#ifdef IGC_METRICS__PROTOBUF_ATTACHED
+        if (pFunc == nullptr || isaStats == nullptr)
+        {
+            return;
+        }
+
+        auto func_iter = map_Func.find(pFunc->getSubprogram());
+        if (func_iter == map_Func.end())
+        {
+            return;
+        }
+
+        auto isaStats_m = func_iter->second->add_isa_stats();
+        isaStats_m->set_simdsize(simdSize);
+        isaStats_m->set_countinst(isaStats->numInsts);
+        isaStats_m->set_countcompactedinst(isaStats->numCompactedInsts);
+        isaStats_m->set_countbasicblocks(isaStats->numBBs);
+
+        auto kinds_m = isaStats_m->mutable_inst_kinds();
+        kinds_m->set_countalu(isaStats->numInstsByKind[VISA_INST_KIND_ALU]);
+        kinds_m->set_countlogic(isaStats->numInstsByKind[VISA_INST_KIND_LOGIC]);
+        kinds_m->set_countmov(isaStats->numInstsByKind[VISA_INST_KIND_MOV]);
+        kinds_m->set_countsend(isaStats->numInstsByKind[VISA_INST_KIND_SEND]);
+        kinds_m->set_countselcmp(isaStats->numInstsByKind[VISA_INST_KIND_SEL_CMP]);
+        kinds_m->set_countstructcf(isaStats->numInstsByKind[VISA_INST_KIND_STRUCTCF]);
+        kinds_m->set_countgotojoin(isaStats->numInstsByKind[VISA_INST_KIND_GOTOJOIN]);
+        kinds_m->set_countthreadcf(isaStats->numInstsByKind[VISA_INST_KIND_THREADCF]);
+        kinds_m->set_countcall(isaStats->numInstsByKind[VISA_INST_KIND_CALL]);
+        kinds_m->set_countothers(isaStats->numInstsByKind[VISA_INST_KIND_OTHERS]);
+
+        auto pipes_m = isaStats_m->mutable_pipes();
+        pipes_m->set_countint(isaStats->numInstsByPipe[VISA_PIPE_INT]);
+        pipes_m->set_countfloat(isaStats->numInstsByPipe[VISA_PIPE_FLOAT]);
+        pipes_m->set_countlong(isaStats->numInstsByPipe[VISA_PIPE_LONG]);
+        pipes_m->set_countmath(isaStats->numInstsByPipe[VISA_PIPE_MATH]);
+        pipes_m->set_countsend(isaStats->numInstsByPipe[VISA_PIPE_SEND]);
+        pipes_m->set_countdpas(isaStats->numInstsByPipe[VISA_PIPE_DPAS]);
+        pipes_m->set_countjeu(isaStats->numInstsByPipe[VISA_PIPE_JEU]);
+        pipes_m->set_countother(isaStats->numInstsByPipe[VISA_PIPE_OTHER]);
+
+        for (int sfid = 0; sfid < VISA_NUM_SFIDS; ++sfid)
+        {
+            if (isaStats->numSendsBySFID[sfid] == 0)
+            {
+                continue;
+            }
+            auto sends_m = isaStats_m->add_sends();
+            sends_m->set_sfid(sfid);
+            sends_m->set_count(isaStats->numSendsBySFID[sfid]);
+        }
+
+        isaStats_m->set_countsyncinst(isaStats->numSyncInsts);
+        isaStats_m->set_countswsbtokendeps(isaStats->numSWSBTokenDeps);
+        isaStats_m->set_countswsbdistdeps(isaStats->numSWSBDistDeps);
+        isaStats_m->set_spillbytes(isaStats->spillBytes);
+        isaStats_m->set_fillbytes(isaStats->fillBytes);
+        isaStats_m->set_staticcycles(isaStats->staticCycles);
+#endif
+    }
+
     void IGCMetricImpl::CollectFunctions(llvm::Module* pModule)
     {
         if (!Enable()) return;
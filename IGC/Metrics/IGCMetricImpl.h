@@ -16,11 +16,16 @@ SPDX-License-Identifier: MIT
 #include <3d/common/iStdLib/types.h>
 #include <common/shaderHash.hpp>
 #include "KernelInfo.h"
+#include "JitterDataStruct.h"
+#include "IGCLightMetrics.h"
+
+#include <chrono>
 
 #ifdef IGC_METRICS__PROTOBUF_ATTACHED
 #include <google/protobuf/util/json_util.h>
 #include <Metrics/proto_schema/igc_metrics.pb.h>
 #include <Metrics/proto_schema/instruction_stats.pb.h>
+#include <Metrics/proto_schema/isa_stats.pb.h>
 
 #define HashKey size_t
 #define HashKey_NULL 0
@@ -38,6 +43,11 @@ namespace IGCMetrics
     {
     private:
         bool isEnabled;
+
+        bool isLightEnabled = false;
+        bool isLightStarted = false;
+        std::chrono::steady_clock::time_point lightStartTime;
+        IGCLightMetrics lightMetrics = {};
 #ifdef IGC_METRICS__PROTOBUF_ATTACHED
         IGC_METRICS::Program oclProgram;
 
@@ -101,8 +111,15 @@ namespace IGCMetrics
 
         void CollectRegStats(KERNEL_INFO* vISAstats);
 
+        void CollectISAStats(llvm::Function* pFunc, unsigned simdSize, const VISA_KERNEL_STATS* isaStats);
+
         void FinalizeStats();
 
         void OutputMetrics();
+
+        bool EnableLight() const { return isLightEnabled; }
+        void StatRetry();
+        void FinalizeLightMetrics();
+        const IGCLightMetrics* GetLightMetrics() const;
     };
 }
\ No newline at end of file
@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+# ========================== begin_copyright_notice ============================
+#
+# Copyright (C) 2021 Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+#
+# =========================== end_copyright_notice =============================
+
+"""Sums the IGCLightMetrics records of many programs.
+
+Each input is either a zebin, whose .misc.igc_metrics section holds the
+record, or a file containing the raw record. The layout must match
+IGCLightMetrics in IGCLightMetrics.h.
+
+    aggregate_light_metrics.py [--csv] <file-or-directory>...
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = 0x4C4D4749
+VERSION = 1
+HIST_BUCKETS = 16
+SECTION_NAME = b".misc.igc_metrics"
+
+COUNTERS = [
+    "numKernels",
+    "numKernelsSIMD8",
+    "numKernelsSIMD16",
+    "numKernelsSIMD32",
+    "numSpillingKernels",
+    "numRetries",
+    "numEmulatedInsts",
+    "compileTimeUs",
+]
+HISTOGRAMS = [
+    "instCountHist",
+    "spillBytesHist",
+    "staticCyclesHist",
+]
+HEADER_SIZE = 3 * 4
+RECORD_SIZE = HEADER_SIZE + 4 * (len(COUNTERS) + HIST_BUCKETS * len(HISTOGRAMS))
+
+
+def find_elf_section(data, name):
+    """Returns the contents of section name, or None if data is not ELF."""
+    if data[:4] != b"\x7fELF":
+        return None
+    elf_class, encoding = data[4], data[5]
+    if elf_class not in (1, 2) or encoding not in (1, 2):
+        raise ValueError("unsupported ELF class %d or data encoding %d" % (elf_class, encoding))
+    endian = "<" if encoding == 1 else ">"
+    if elf_class == 2:
+        shoff, = struct.unpack_from(endian + "Q", data, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", data, 0x3A)
+        shdr = endian + "IIQQQQ"
+    else:
+        shoff, = struct.unpack_from(endian + "I", data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", data, 0x2E)
+        shdr = endian + "IIIIII"
+
+    def header(i):
+        _, _, _, _, offset, size = struct.unpack_from(shdr, data, shoff + i * shentsize)
+        return offset, size
+
+    strtab_off, _ = header(shstrndx)
+    for i in range(shnum):
+        name_off, = struct.unpack_from(endian + "I", data, shoff + i * shentsize)
+        start = strtab_off + name_off
+        end = data.index(b"\0", start)
+        if data[start:end] == name:
+            offset, size = header(i)
+            return data[offset:offset + size]
+    return None
+
+
+def parse_record(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    section = find_elf_section(data, SECTION_NAME)
+    if section is not None:
+        data = section
+    if len(data) < RECORD_SIZE:
+        return None
+    magic, version, size = struct.unpack_from("<III", data, 0)
+    if magic != MAGIC or version != VERSION or size != RECORD_SIZE:
+        return None
+
+    values = struct.unpack_from("<%dI" % ((RECORD_SIZE - HEADER_SIZE) // 4), data, HEADER_SIZE)
+    record = dict(zip(COUNTERS, values))
+    pos = len(COUNTERS)
+    for hist in HISTOGRAMS:
+        record[hist] = list(values[pos:pos + HIST_BUCKETS])
+        pos += HIST_BUCKETS
+    return record
+
+
+def bucket(value):
+    b = 0
+    while value != 0 and b < HIST_BUCKETS - 1:
+        value >>= 1
+        b += 1
+    return b
+
+
+def bucket_label(b):
+    if b == 0:
+        return "0"
+    if b == HIST_BUCKETS - 1:
+        return ">=%d" % (1 << (b - 1))
+    return "%d-%d" % (1 << (b - 1), (1 << b) - 1)
+
+
+def collect_paths(inputs):
+    for path in inputs:
+        if os.path.isdir(path):
+            for root, _, files in os.walk(path):
+                for name in sorted(files):
+                    yield os.path.join(root, name)
+        else:
+            yield path
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--csv", action="store_true", help="print a single CSV row")
+    parser.add_argument("inputs", nargs="+")
+    args = parser.parse_args()
+
+    total = {name: 0 for name in COUNTERS}
+    for hist in HISTOGRAMS:
+        total[hist] = [0] * HIST_BUCKETS
+    # Per-program compile times, as the records hold one value each.
+    compile_time_hist = [0] * HIST_BUCKETS
+    num_programs = 0
+
+    for path in collect_paths(args.inputs):
+        try:
+            record = parse_record(path)
+        except (ValueError, struct.error) as e:
+            print("%s: cannot read ELF: %s" % (path, e), file=sys.stderr)
+            continue
+        if record is None:
+            continue
+        num_programs += 1
+        for name in COUNTERS:
+            total[name] += record[name]
+        for hist in HISTOGRAMS:
+            total[hist] = [a + b for a, b in zip(total[hist], record[hist])]
+        compile_time_hist[bucket(record["compileTimeUs"] // 1000)] += 1
+
+    if num_programs == 0:
+        print("no IGC light metrics records found", file=sys.stderr)
+        return 1
+
+    hists = [(hist, total[hist]) for hist in HISTOGRAMS]
+    hists.append(("compileTimeMsHist", compile_time_hist))
+
+    if args.csv:
+        names = ["numPrograms"] + COUNTERS
+        values = [num_programs] + [total[name] for name in COUNTERS]
+        for hist, counts in hists:
+            names += ["%s[%s]" % (hist, bucket_label(b)) for b in range(HIST_BUCKETS)]
+            values += counts
+        print(",".join(names))
+        print(",".join(str(v) for v in values))
+        return 0
+
+    print("%-20s %d" % ("numPrograms", num_programs))
+    for name in COUNTERS:
+        print("%-20s %d" % (name, total[name]))
+    for hist, counts in hists:
+        print("\n%s" % hist)
+        for b, count in enumerate(counts):
+            if count:
+                print("  %-12s %d" % (bucket_label(b), count))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -46,6 +46,7 @@ list(APPEND IGC_METRICS_SRCS "Metrics/IGCMetric.cpp")
 list(APPEND IGC_METRICS_SRCS "Metrics/IGCMetricImpl.cpp")
 list(APPEND IGC_METRICS_HDRS "Metrics/IGCMetric.h")
 list(APPEND IGC_METRICS_HDRS "Metrics/IGCMetricImpl.h")
+list(APPEND IGC_METRICS_HDRS "Metrics/IGCLightMetrics.h")
 
 add_library(igc_metric STATIC ${IGC_METRICS_SRCS} ${IGC_METRICS_HDRS})
 
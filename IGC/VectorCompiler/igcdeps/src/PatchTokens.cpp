@@ -188,7 +188,8 @@ void CGen8CMProgram::GetZEBinary(llvm::raw_pwrite_stream &programBinary,
   // is destroyed.
   std::unique_ptr<llvm::MemoryBuffer> DebugInfoHolder;
   iOpenCL::ZEBinaryBuilder zebuilder{m_Platform, pointerSizeInBytes == 8,
-                                     *m_programInfo, nullptr, 0};
+                                     *m_programInfo, nullptr, 0,
+                                     &programBinary};
   zebuilder.setGfxCoreFamily(m_Platform.eRenderCoreFamily);
 
   for (const auto &kernel : m_kernels) {
@@ -14,7 +14,8 @@ SPDX-License-Identifier: MIT
 #include "common/LLVMWarningsPush.hpp"
 #endif
 
-#include "llvm/MC/StringTableBuilder.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/Support/EndianStream.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/raw_ostream.h"
@@ -47,7 +48,7 @@ private:
     typedef ZEELFObjectBuilder::ZEInfoSection ZEInfoSection;
     typedef ZEELFObjectBuilder::RelocationListTy RelocationListTy;
     typedef std::map<ZEELFObjectBuilder::SectionID, uint32_t> SectionIndexMapTy;
-    typedef std::map<std::string, uint64_t> SymNameIndexMapTy;
+    typedef llvm::DenseMap<llvm::StringRef, uint64_t> SymNameIndexMapTy;
 
     struct SectionHdrEntry {
         uint32_t name    = 0;
@@ -63,11 +64,11 @@ private:
     typedef std::vector<SectionHdrEntry> SectionHdrListTy;
 
 private:
-    // set m_SectionHdrEntries and adjust the section index, also create
-    // strings for sections' name in StringTableBuilder
+    // set m_SectionHdrEntries and adjust the section index
     void createSectionHdrEntries();
-    // write elf header
-    void writeHeader();
+    // write elf header at the start of the object. This is done last, as
+    // e_shoff is only known once all sections have been written
+    void writeHeader(uint64_t sectHdrOff);
     // write sections and set the attributes in SectionHdrEntry
     void writeSections();
     // write a raw section
@@ -84,8 +85,6 @@ private:
     uint64_t writeStrTab();
     // write section header
     void writeSectionHeader();
-    // write the section header's offset into ELF header
-    void writeSectionHdrOffset(uint64_t offset);
     // write number of zero bytes
     void writePadding(uint32_t size);
 
@@ -100,11 +99,21 @@ private:
 
     bool is64Bit() { return m_ObjBuilder.m_is64Bit; }
 
+    // the standard sections' payloads have been written by
+    // ZEELFObjectBuilder::streamTo into the stream we're writing to
+    bool isStreamed() const {
+        return m_ObjBuilder.m_streamOS != nullptr &&
+            static_cast<llvm::raw_ostream*>(m_ObjBuilder.m_streamOS) == &m_W.OS;
+    }
+
+    // offset from the start of the ELF object
+    uint64_t curOffset() const { return m_W.OS.tell() - m_Start; }
+
     uint16_t numOfSections();
 
     // name is the string table index of the section name
     SectionHdrEntry& createSectionHdrEntry(
-        const std::string& name, unsigned type, const Section* sect = nullptr);
+        uint32_t name, unsigned type, const Section* sect = nullptr);
     SectionHdrEntry& createNullSectionHdrEntry();
 
     uint32_t getSymTabEntSize();
@@ -124,9 +133,11 @@ private:
 
 private:
     llvm::support::endian::Writer m_W;
-    llvm::StringTableBuilder m_StrTabBuilder{llvm::StringTableBuilder::ELF};
     ZEELFObjectBuilder& m_ObjBuilder;
 
+    // stream position of the ELF header
+    uint64_t m_Start = 0;
+
     // Map Section::m_id to ELF section index, used for creating symbol table
     SectionIndexMapTy m_SectionIndex;
     uint32_t m_SymTabIndex = 0;
@@ -146,6 +157,36 @@ private:
 using namespace zebin;
 using namespace llvm;
 
+llvm::StringRef
+ZEELFObjectBuilder::internString(llvm::StringRef str, uint32_t& strTabOff)
+{
+    llvm::StringRef saved = m_stringPool.save(str);
+    strTabOff = static_cast<uint32_t>(m_strTab.add(saved));
+    return saved;
+}
+
+void ZEELFObjectBuilder::streamTo(llvm::raw_pwrite_stream& os)
+{
+    IGC_ASSERT_MESSAGE(m_sectionIdCount == 0,
+        "streamTo must be called before adding sections");
+    m_streamOS = &os;
+    m_streamStart = os.tell();
+    // reserve the ELF header, it's backpatched in finalize
+    os.write_zeros(m_is64Bit ? sizeof(ELF::Elf64_Ehdr) : sizeof(ELF::Elf32_Ehdr));
+}
+
+void ZEELFObjectBuilder::streamSection(StandardSection& sect)
+{
+    if (m_streamOS == nullptr || sect.m_type == ELF::SHT_NOBITS)
+        return;
+
+    sect.m_offset = m_streamOS->tell() - m_streamStart;
+    // it's possible that a section has only pading but no data
+    if (sect.m_data != nullptr)
+        m_streamOS->write((const char*)sect.m_data, sect.m_size);
+    m_streamOS->write_zeros(sect.m_padding);
+}
+
 ZEELFObjectBuilder::Section&
 ZEELFObjectBuilder::addStandardSection(
     std::string sectName, const uint8_t* data, uint64_t size,
@@ -159,11 +200,15 @@ ZEELFObjectBuilder::addStandardSection(
     if (need_padding_for_align == align)
         need_padding_for_align = 0;
 
+    uint32_t nameOff = 0;
+    llvm::StringRef savedName = internString(sectName, nameOff);
+
     // total required padding is (padding + need_padding_for_align)
     sections.emplace_back(
-        ZEELFObjectBuilder::StandardSection(sectName, data, size, type,
+        ZEELFObjectBuilder::StandardSection(savedName, nameOff, data, size, type,
             (need_padding_for_align + padding), m_sectionIdCount));
     ++m_sectionIdCount;
+    streamSection(sections.back());
     return sections.back();
 }
 
@@ -282,6 +327,7 @@ ZEELFObjectBuilder::addSectionZEInfo(zeInfoContainer& zeInfo)
 {
     // every object should have at most one ze_info section
     IGC_ASSERT(!m_zeInfoSection);
+    internString(m_ZEInfoName, m_ZEInfoNameOff);
     m_zeInfoSection.reset(new ZEInfoSection(zeInfo, m_sectionIdCount));
     ++m_sectionIdCount;
 }
@@ -290,12 +336,17 @@ void ZEELFObjectBuilder::addSymbol(
     std::string name, uint64_t addr, uint64_t size, uint8_t binding,
     uint8_t type, ZEELFObjectBuilder::SectionID sectionId)
 {
+    if (m_SymTabNameOff == 0)
+        internString(m_SymTabName, m_SymTabNameOff);
+
+    uint32_t nameOff = 0;
+    llvm::StringRef savedName = internString(name, nameOff);
     if (binding == llvm::ELF::STB_LOCAL)
-        m_localSymbols.emplace_back(
-            ZEELFObjectBuilder::Symbol(name, addr, size, binding, type, sectionId));
+        m_localSymbols.emplace_back(ZEELFObjectBuilder::Symbol(
+            savedName, nameOff, addr, size, binding, type, sectionId));
     else
-        m_globalSymbols.emplace_back(
-            ZEELFObjectBuilder::Symbol(name, addr, size, binding, type, sectionId));
+        m_globalSymbols.emplace_back(ZEELFObjectBuilder::Symbol(
+            savedName, nameOff, addr, size, binding, type, sectionId));
 }
 
 ZEELFObjectBuilder::RelocSection&
@@ -313,13 +364,16 @@ ZEELFObjectBuilder::getOrCreateRelocSection(SectionID targetSectId, bool isRelFo
     // If the targt name is empty, we use the defualt name .rel/.rela as the section name
     // though in our case this should not happen
     std::string sectName;
-    std::string targetName = getSectionNameBySectionID(targetSectId);
+    llvm::StringRef targetName = getSectionNameBySectionID(targetSectId);
     if (!targetName.empty())
-        sectName = (isRelFormat? m_RelName : m_RelaName) + targetName;
+        sectName = (isRelFormat? m_RelName : m_RelaName) + targetName.str();
     else
         sectName = isRelFormat? m_RelName : m_RelaName;
 
-    m_relocSections.emplace_back(RelocSection(m_sectionIdCount, targetSectId, sectName, isRelFormat));
+    uint32_t nameOff = 0;
+    llvm::StringRef savedName = internString(sectName, nameOff);
+    m_relocSections.emplace_back(RelocSection(
+        m_sectionIdCount, targetSectId, savedName, nameOff, isRelFormat));
     ++m_sectionIdCount;
     return m_relocSections.back();
 }
@@ -330,7 +384,7 @@ void ZEELFObjectBuilder::addRelRelocation(
     RelocSection& reloc_sect = getOrCreateRelocSection(sectionId, true);
     // create the relocation
     reloc_sect.m_Relocations.emplace_back(
-        ZEELFObjectBuilder::Relocation(offset, symName, type));
+        ZEELFObjectBuilder::Relocation(offset, m_stringPool.save(symName), type));
 }
 
 void ZEELFObjectBuilder::addRelaRelocation(
@@ -339,7 +393,7 @@ void ZEELFObjectBuilder::addRelaRelocation(
     RelocSection& reloc_sect = getOrCreateRelocSection(sectionId, false);
     // create the relocation
     reloc_sect.m_Relocations.emplace_back(
-        ZEELFObjectBuilder::Relocation(offset, symName, type, addend));
+        ZEELFObjectBuilder::Relocation(offset, m_stringPool.save(symName), type, addend));
 }
 
 uint64_t ZEELFObjectBuilder::finalize(llvm::raw_pwrite_stream& os)
@@ -352,15 +406,15 @@ ZEELFObjectBuilder::SectionID
 ZEELFObjectBuilder::getSectionIDBySectionName(const char* name)
 {
     for (StandardSection& sect : m_textSections) {
-        if (strcmp(name, sect.m_sectName.c_str()) == 0)
+        if (sect.m_sectName == name)
             return sect.id();
     }
     for (StandardSection& sect : m_dataAndbssSections) {
-        if (strcmp(name, sect.m_sectName.c_str()) == 0)
+        if (sect.m_sectName == name)
             return sect.id();
     }
     for (StandardSection& sect : m_otherStdSections) {
-        if (strcmp(name, sect.m_sectName.c_str()) == 0)
+        if (sect.m_sectName == name)
             return sect.id();
     }
 
@@ -368,7 +422,7 @@ ZEELFObjectBuilder::getSectionIDBySectionName(const char* name)
     return 0;
 }
 
-std::string ZEELFObjectBuilder::getSectionNameBySectionID(SectionID id)
+llvm::StringRef ZEELFObjectBuilder::getSectionNameBySectionID(SectionID id)
 {
     // do linear search that we assume there won't be too many sections
     for (StandardSection& sect : m_textSections) {
@@ -403,8 +457,7 @@ uint64_t ELFWriter::writeSectionData(const uint8_t* data, uint64_t size, uint32_
 
 void ELFWriter::writePadding(uint32_t size)
 {
-    for (uint32_t i = 0; i < size; ++i)
-        m_W.write<uint8_t>(0x0);
+    m_W.OS.write_zeros(size);
 }
 
 uint32_t ELFWriter::getSymTabEntSize()
@@ -473,14 +526,14 @@ uint64_t ELFWriter::writeRelocTab(const RelocationListTy& relocs, bool isRelForm
 
     for (const ZEELFObjectBuilder::Relocation& reloc : relocs) {
         // the target symbol's name must have been added into symbol table
-        IGC_ASSERT(m_SymNameIdxMap.find(reloc.symName()) != m_SymNameIdxMap.end());
+        auto symIt = m_SymNameIdxMap.find(reloc.symName());
+        IGC_ASSERT(symIt != m_SymNameIdxMap.end());
 
         if (isRelFormat)
-            writeRelRelocation(
-                reloc.offset(), reloc.type(), m_SymNameIdxMap[reloc.symName()]);
+            writeRelRelocation(reloc.offset(), reloc.type(), symIt->second);
         else
             writeRelaRelocation(
-                reloc.offset(), reloc.type(), m_SymNameIdxMap[reloc.symName()], reloc.addend());
+                reloc.offset(), reloc.type(), symIt->second, reloc.addend());
     }
 
     return m_W.OS.tell() - start_off;
@@ -497,9 +550,6 @@ uint64_t ELFWriter::writeSymTab()
     ++symidx;
 
     auto writeOneSym = [&](ZEELFObjectBuilder::Symbol& sym) {
-        // create symbol name entry in str table
-        uint32_t nameoff = m_StrTabBuilder.add(StringRef(sym.name()));
-
         uint16_t sect_idx = 0;
         if (sym.sectionId() >= 0) {
             // the given section's index must have been adjusted in
@@ -511,7 +561,7 @@ uint64_t ELFWriter::writeSymTab()
             sect_idx = ELF::SHN_UNDEF;
         }
 
-        writeSymbol(nameoff, sym.addr(), sym.size(), sym.binding(), sym.type(),
+        writeSymbol(sym.nameOff(), sym.addr(), sym.size(), sym.binding(), sym.type(),
             0, sect_idx);
         // global symbol name must be unique
         IGC_ASSERT(sym.binding() != llvm::ELF::STB_GLOBAL || m_SymNameIdxMap.find(sym.name()) == m_SymNameIdxMap.end());
@@ -548,7 +598,7 @@ std::pair<uint64_t, uint64_t> ELFWriter::writeCompatibilityNote() {
         // The alignment of the Elf word, name and descriptor is 4.
         // Implementations differ from the specification here: in practice all
         // variants align both the name and descriptor to 4-bytes.
-        uint64_t cur = m_W.OS.tell();
+        uint64_t cur = curOffset();
         uint64_t next = llvm::alignTo(cur, 4);
         writePadding(next - cur);
     };
@@ -569,7 +619,7 @@ std::pair<uint64_t, uint64_t> ELFWriter::writeCompatibilityNote() {
     // Align the section offset to the required alignment first.
     // TODO: Handle the section alignment in a more generic place..
     padToRequiredAlign();
-    uint64_t start_off = m_W.OS.tell();
+    uint64_t start_off = curOffset();
     // write NT_INTELGT_PRODUCT_FAMILY
     writeOneNote("IntelGT",
                  static_cast<uint32_t>(m_ObjBuilder.m_productFamily),
@@ -584,19 +634,19 @@ std::pair<uint64_t, uint64_t> ELFWriter::writeCompatibilityNote() {
     writeOneNote("IntelGT",
                  m_ObjBuilder.m_metadata.packed,
                  NT_INTELGT_TARGET_METADATA);
-    return std::make_pair(start_off, m_W.OS.tell() - start_off);
+    return std::make_pair(start_off, curOffset() - start_off);
 }
 
 uint64_t ELFWriter::writeStrTab()
 {
     uint64_t start_off = m_W.OS.tell();
 
-    // at this point, all strings should be added. Finalized the string table
-    // and write it to OS
-    // must finalize it in order, that we take the offset of
-    // section and symbols' name when added
-    m_StrTabBuilder.finalizeInOrder();
-    m_StrTabBuilder.write(m_W.OS);
+    // all strings have been added by the builder when the sections and
+    // symbols were created. Finalize the string table in order, as the
+    // offsets were taken when the strings were added. Finalizing in order
+    // has no effect on an already finalized table
+    m_ObjBuilder.m_strTab.finalizeInOrder();
+    m_ObjBuilder.m_strTab.write(m_W.OS);
 
     return m_W.OS.tell() - start_off;
 }
@@ -632,28 +682,28 @@ void ELFWriter::writeSectionHeader()
 void ELFWriter::writeSections()
 {
     for (SectionHdrEntry& entry : m_SectionHdrEntries) {
-        entry.offset = m_W.OS.tell();
+        entry.offset = curOffset();
 
-        switch(entry.type) {
-        case ELF::SHT_PROGBITS:
-        case SHT_ZEBIN_SPIRV: {
-            IGC_ASSERT(nullptr != entry.section);
-            IGC_ASSERT(entry.section->getKind() == Section::STANDARD);
+        // standard sections: .text, .data, .bss, .spv, .debug_info, etc
+        if (entry.section != nullptr &&
+            entry.section->getKind() == Section::STANDARD) {
             const StandardSection* const stdsect =
                 static_cast<const StandardSection*>(entry.section);
-            IGC_ASSERT(nullptr != stdsect);
-            IGC_ASSERT(stdsect->m_size + stdsect->m_padding);
-            entry.size = writeSectionData(
-                stdsect->m_data, stdsect->m_size, stdsect->m_padding);
-            break;
-        }
-        case ELF::SHT_NOBITS: {
-            const StandardSection* const stdsect =
-                static_cast<const StandardSection*>(entry.section);
-            IGC_ASSERT(nullptr != stdsect);
-            entry.size = stdsect->m_size;
-            break;
+            if (entry.type == ELF::SHT_NOBITS) {
+                entry.size = stdsect->m_size;
+            } else if (isStreamed()) {
+                // the payload has been written when the section was added
+                entry.offset = stdsect->m_offset;
+                entry.size = stdsect->m_size + stdsect->m_padding;
+            } else {
+                IGC_ASSERT(stdsect->m_size + stdsect->m_padding);
+                entry.size = writeSectionData(
+                    stdsect->m_data, stdsect->m_size, stdsect->m_padding);
+            }
+            continue;
         }
+
+        switch(entry.type) {
         case ELF::SHT_SYMTAB:
             entry.size = writeSymTab();
             entry.entsize = getSymTabEntSize();
@@ -690,15 +740,8 @@ void ELFWriter::writeSections()
             break;
 
         case ELF::SHT_NOTE: {
-            // Currently we don't seem to reorder strings in the .strtab, and
-            // the offset returned by LLVM StringTableBuilder::add() will still
-            // be valid, so the section name can be checked in this way. Other
-            // possibilities are creating a new section kind and set the
-            // appropriate section pointer, or emitting .strtab before the note
-            // section.
-            auto strtabSize = m_StrTabBuilder.getSize();
-            if (entry.name == m_StrTabBuilder.add(m_ObjBuilder.m_CompatNoteName)) {
-                IGC_ASSERT(entry.name < strtabSize);
+            // .note.intelgt.compat is the only note section we emit
+            if (entry.name == m_ObjBuilder.m_CompatNoteNameOff) {
                 std::tie(entry.offset, entry.size) = writeCompatibilityNote();
                 break;
             }
@@ -711,79 +754,75 @@ void ELFWriter::writeSections()
     }
 }
 
-void ELFWriter::writeSectionHdrOffset(uint64_t offset)
+void ELFWriter::writeHeader(uint64_t sectHdrOff)
 {
-    auto &stream = static_cast<raw_pwrite_stream &>(m_W.OS);
-
-    if (is64Bit()) {
-        uint64_t Val =
-            support::endian::byte_swap<uint64_t>(offset, m_W.Endian);
-        stream.pwrite(reinterpret_cast<char *>(&Val), sizeof(Val),
-            offsetof(ELF::Elf64_Ehdr, e_shoff));
+    SmallString<sizeof(ELF::Elf64_Ehdr)> hdr;
+    raw_svector_ostream hdrOS(hdr);
+    support::endian::Writer W(hdrOS, support::little);
 
-    } else {
-        uint32_t Val =
-            support::endian::byte_swap<uint32_t>(
-                static_cast<uint32_t>(offset), m_W.Endian);
-        stream.pwrite(reinterpret_cast<char *>(&Val), sizeof(Val),
-            offsetof(ELF::Elf32_Ehdr, e_shoff));
-    }
-}
+    auto writeHdrWord = [&](uint64_t Word) {
+        if (is64Bit())
+            W.write<uint64_t>(Word);
+        else
+            W.write<uint32_t>(static_cast<uint32_t>(Word));
+    };
 
-void ELFWriter::writeHeader()
-{
     // e_ident[EI_MAG0] to e_ident[EI_MAG3]
-    m_W.OS << ELF::ElfMagic;
+    hdrOS << ELF::ElfMagic;
 
     // e_ident[EI_CLASS]
-    m_W.OS << char(m_ObjBuilder.m_is64Bit ? ELF::ELFCLASS64 : ELF::ELFCLASS32);
+    hdrOS << char(m_ObjBuilder.m_is64Bit ? ELF::ELFCLASS64 : ELF::ELFCLASS32);
 
     // e_ident[EI_DATA]
-    m_W.OS << char(ELF::ELFDATA2LSB);
+    hdrOS << char(ELF::ELFDATA2LSB);
 
     // e_ident[EI_VERSION]
-    m_W.OS << char(ELF::EV_CURRENT);
+    hdrOS << char(ELF::EV_CURRENT);
 
     // e_ident padding
-    m_W.OS.write_zeros(ELF::EI_NIDENT - ELF::EI_OSABI);
+    hdrOS.write_zeros(ELF::EI_NIDENT - ELF::EI_OSABI);
 
     // e_type: Currently IGC always emits a relocatable file
-    m_W.write<uint16_t>(ELF::ET_REL);
+    W.write<uint16_t>(ELF::ET_REL);
 
     // e_machine
-    m_W.write<uint16_t>(EM_INTELGT);
+    W.write<uint16_t>(EM_INTELGT);
 
     // e_version
-    m_W.write<uint32_t>(ELF::EV_CURRENT);
+    W.write<uint32_t>(ELF::EV_CURRENT);
 
     // e_entry, no entry point
-    writeWord(0);
+    writeHdrWord(0);
 
     // e_phoff, no program header
-    writeWord(0);
+    writeHdrWord(0);
 
-    // e_shoff, will write it later
-    writeWord(0);
+    // e_shoff
+    writeHdrWord(sectHdrOff);
 
     // e_flags
-    m_W.write<uint32_t>(0);
+    W.write<uint32_t>(0);
 
     // e_ehsize = ELF header size
-    m_W.write<uint16_t>(is64Bit() ?
+    W.write<uint16_t>(is64Bit() ?
         sizeof(ELF::Elf64_Ehdr) : sizeof(ELF::Elf32_Ehdr));
 
-    m_W.write<uint16_t>(0);          // e_phentsize = prog header entry size
-    m_W.write<uint16_t>(0);          // e_phnum = # prog header entries = 0
+    W.write<uint16_t>(0);          // e_phentsize = prog header entry size
+    W.write<uint16_t>(0);          // e_phnum = # prog header entries = 0
 
     // e_shentsize
-    m_W.write<uint16_t>(is64Bit() ?
+    W.write<uint16_t>(is64Bit() ?
         sizeof(ELF::Elf64_Shdr) : sizeof(ELF::Elf32_Shdr));
 
     // e_shnum
-    m_W.write<uint16_t>(numOfSections());
+    W.write<uint16_t>(numOfSections());
 
     // e_shstrndx  = .strtab index
-    m_W.write<uint16_t>(m_StringTableIndex);
+    W.write<uint16_t>(m_StringTableIndex);
+
+    IGC_ASSERT(hdr.size() ==
+        (is64Bit() ? sizeof(ELF::Elf64_Ehdr) : sizeof(ELF::Elf32_Ehdr)));
+    static_cast<raw_pwrite_stream&>(m_W.OS).pwrite(hdr.data(), hdr.size(), m_Start);
 }
 
 uint16_t ELFWriter::numOfSections()
@@ -800,14 +839,20 @@ ELFWriter::ELFWriter(llvm::raw_pwrite_stream& OS,
 
 uint64_t ELFWriter::write()
 {
-    uint64_t start = m_W.OS.tell();
+    if (isStreamed()) {
+        // the header space has been reserved by streamTo
+        m_Start = m_ObjBuilder.m_streamStart;
+    } else {
+        m_Start = m_W.OS.tell();
+        m_W.OS.write_zeros(is64Bit() ?
+            sizeof(ELF::Elf64_Ehdr) : sizeof(ELF::Elf32_Ehdr));
+    }
     createSectionHdrEntries();
-    writeHeader();
     writeSections();
-    uint64_t sectHdrOff = m_W.OS.tell();
+    uint64_t sectHdrOff = curOffset();
     writeSectionHeader();
-    writeSectionHdrOffset(sectHdrOff);
-    return m_W.OS.tell() - start;
+    writeHeader(sectHdrOff);
+    return curOffset();
 }
 
 ELFWriter::SectionHdrEntry& ELFWriter::createNullSectionHdrEntry()
@@ -820,14 +865,13 @@ ELFWriter::SectionHdrEntry& ELFWriter::createNullSectionHdrEntry()
 }
 
 ELFWriter::SectionHdrEntry& ELFWriter::createSectionHdrEntry(
-    const std::string& name, unsigned type, const Section* sect)
+    uint32_t name, unsigned type, const Section* sect)
 {
     m_SectionHdrEntries.emplace_back(SectionHdrEntry());
     SectionHdrEntry& entry = m_SectionHdrEntries.back();
     entry.type = type;
     entry.section = sect;
-    uint32_t nameoff = m_StrTabBuilder.add(StringRef(name));
-    entry.name = nameoff;
+    entry.name = name;
     return entry;
 }
 
@@ -852,14 +896,14 @@ void ELFWriter::createSectionHdrEntries()
     for (StandardSection& sect : m_ObjBuilder.m_textSections) {
         m_SectionIndex.insert(std::make_pair(sect.id(), index));
         ++index;
-        createSectionHdrEntry(sect.m_sectName, sect.m_type, &sect);
+        createSectionHdrEntry(sect.m_nameOff, sect.m_type, &sect);
     }
 
     // .data
     for (StandardSection& sect : m_ObjBuilder.m_dataAndbssSections) {
         m_SectionIndex.insert(std::make_pair(sect.id(), index));
         ++index;
-        createSectionHdrEntry(sect.m_sectName, sect.m_type, &sect);
+        createSectionHdrEntry(sect.m_nameOff, sect.m_type, &sect);
     }
 
     // .symtab
@@ -867,14 +911,14 @@ void ELFWriter::createSectionHdrEntries()
         !m_ObjBuilder.m_globalSymbols.empty()) {
         m_SymTabIndex = index;
         ++index;
-        createSectionHdrEntry(m_ObjBuilder.m_SymTabName, ELF::SHT_SYMTAB);
+        createSectionHdrEntry(m_ObjBuilder.m_SymTabNameOff, ELF::SHT_SYMTAB);
     }
 
     // other sections
     for (StandardSection& sect : m_ObjBuilder.m_otherStdSections) {
         m_SectionIndex.insert(std::make_pair(sect.id(), index));
         ++index;
-        createSectionHdrEntry(sect.m_sectName, sect.m_type, &sect);
+        createSectionHdrEntry(sect.m_nameOff, sect.m_type, &sect);
     }
 
     // .rel and .rela
@@ -883,8 +927,8 @@ void ELFWriter::createSectionHdrEntries()
         for (RelocSection& sect : m_ObjBuilder.m_relocSections) {
             SectionHdrEntry& entry =
                 sect.isRelFormat() ?
-                  createSectionHdrEntry(sect.m_sectName, ELF::SHT_REL, &sect) :
-                  createSectionHdrEntry(sect.m_sectName, ELF::SHT_RELA, &sect);
+                  createSectionHdrEntry(sect.m_nameOff, ELF::SHT_REL, &sect) :
+                  createSectionHdrEntry(sect.m_nameOff, ELF::SHT_RELA, &sect);
             // set apply target's section index
             // relocations could only apply to standard sections. At this point,
             // all standard section's section index should be adjusted
@@ -897,19 +941,19 @@ void ELFWriter::createSectionHdrEntries()
 
     // .ze_info
     if (m_ObjBuilder.m_zeInfoSection) {
-        createSectionHdrEntry(m_ObjBuilder.m_ZEInfoName, SHT_ZEBIN_ZEINFO,
+        createSectionHdrEntry(m_ObjBuilder.m_ZEInfoNameOff, SHT_ZEBIN_ZEINFO,
             m_ObjBuilder.m_zeInfoSection.get());
         ++index;
     }
 
     // .note.intelgt.compat
     // Create the compatibility note section
-    createSectionHdrEntry(m_ObjBuilder.m_CompatNoteName, ELF::SHT_NOTE);
+    createSectionHdrEntry(m_ObjBuilder.m_CompatNoteNameOff, ELF::SHT_NOTE);
     ++index;
 
     // .strtab
     m_StringTableIndex = index;
-    createSectionHdrEntry(m_ObjBuilder.m_StrTabName, ELF::SHT_STRTAB);
+    createSectionHdrEntry(m_ObjBuilder.m_StrTabNameOff, ELF::SHT_STRTAB);
 }
 
 // createKernel - create a zeInfoKernel and add it into zeInfoContainer
@@ -24,7 +24,11 @@ SPDX-License-Identifier: MIT
 #include "common/LLVMWarningsPush.hpp"
 #endif
 
+#include "llvm/ADT/StringRef.h"
 #include "llvm/BinaryFormat/ELF.h"
+#include "llvm/MC/StringTableBuilder.h"
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/StringSaver.h"
 
 #ifndef ZEBinStandAloneBuild
 #include "common/LLVMWarningsPop.hpp"
@@ -52,6 +56,9 @@ public:
     ZEELFObjectBuilder(bool is64Bit) : m_is64Bit(is64Bit)
     {
         m_metadata.packed = 0;
+        // these two sections are always emitted
+        internString(m_CompatNoteName, m_CompatNoteNameOff);
+        internString(m_StrTabName, m_StrTabNameOff);
     }
 
     ~ZEELFObjectBuilder() {}
@@ -65,6 +72,13 @@ public:
     void setTargetMetadata(TargetMetadata metadata) { m_metadata = metadata; }
     TargetMetadata getTargetMetadata() const { return m_metadata; }
 
+    // streamTo - write section payloads into os as soon as they are added
+    // instead of laying all of them out in finalize. Space for the ELF header
+    // is reserved here and the header is backpatched by finalize, which must
+    // be given the same os to complete the object.
+    // This must be called before any section is added.
+    void streamTo(llvm::raw_pwrite_stream& os);
+
     // add a text section contains gen binary
     // - name: section name. This is usually the kernel or function name of
     //         this text section. Do not includes leading .text in given
@@ -197,6 +211,8 @@ public:
 
     // finalize - Finalize the ELF Object, write ELF file into given os
     // return number of written bytes
+    // If os is the stream given to streamTo, only the sections that have not
+    // been streamed yet and the headers are written
     uint64_t finalize(llvm::raw_pwrite_stream& os);
 
     // get an ID of a section
@@ -223,22 +239,27 @@ private:
 
     class StandardSection : public Section {
     public:
-        StandardSection(std::string sectName, const uint8_t* data, uint64_t size,
-            unsigned type, uint32_t padding, uint32_t id)
-            : Section(id), m_sectName(sectName), m_data(data), m_size(size), m_type(type),
-              m_padding(padding)
+        StandardSection(llvm::StringRef sectName, uint32_t nameOff,
+            const uint8_t* data, uint64_t size, unsigned type, uint32_t padding,
+            uint32_t id)
+            : Section(id), m_sectName(sectName), m_nameOff(nameOff), m_data(data),
+              m_size(size), m_type(type), m_padding(padding)
         {}
 
         Kind getKind() const { return STANDARD; }
 
-        // m_sectName - the final name presented in ELF section header
-        // This field is required as the place holder for StringTable construction
-        std::string m_sectName;
+        // m_sectName - the final name presented in ELF section header, owned
+        // by the builder's string pool
+        llvm::StringRef m_sectName;
+        // m_nameOff - offset of m_sectName in .strtab
+        uint32_t m_nameOff;
         const uint8_t* m_data;
         uint64_t m_size;
         // section type
         unsigned m_type;
         uint32_t m_padding;
+        // m_offset - file offset of the payload if it has been streamed
+        uint64_t m_offset = 0;
     };
 
     class ZEInfoSection : public Section {
@@ -258,13 +279,14 @@ private:
 
     class Symbol {
     public:
-        Symbol(std::string name, uint64_t addr, uint64_t size, uint8_t binding,
-            uint8_t type, SectionID sectionId)
-            : m_name(name), m_addr(addr), m_size(size), m_binding(binding),
-            m_type(type), m_sectionId(sectionId)
+        Symbol(llvm::StringRef name, uint32_t nameOff, uint64_t addr, uint64_t size,
+            uint8_t binding, uint8_t type, SectionID sectionId)
+            : m_name(name), m_nameOff(nameOff), m_addr(addr), m_size(size),
+            m_binding(binding), m_type(type), m_sectionId(sectionId)
         {}
 
-        std::string& name()            { return m_name;      }
+        llvm::StringRef name()     const { return m_name;      }
+        uint32_t     nameOff()   const { return m_nameOff;   }
         uint64_t     addr()      const { return m_addr;      }
         uint64_t     size()      const { return m_size;      }
         uint8_t      binding()   const { return m_binding;   }
@@ -272,7 +294,8 @@ private:
         SectionID    sectionId() const { return m_sectionId; }
 
     private:
-        std::string m_name;
+        llvm::StringRef m_name;
+        uint32_t m_nameOff;
         uint64_t m_addr;
         uint64_t m_size;
         uint8_t m_binding;
@@ -285,18 +308,19 @@ private:
     /// It's rel or rela depends on it's in RelocSection or RelaRelocSection
     class Relocation {
     public:
-        Relocation(uint64_t offset, std::string symName, R_TYPE_ZEBIN type, uint64_t addend = 0)
+        Relocation(uint64_t offset, llvm::StringRef symName, R_TYPE_ZEBIN type, uint64_t addend = 0)
             : m_offset(offset), m_symName(symName), m_type(type), m_addend(addend)
         {}
 
         uint64_t            offset()  const { return m_offset;  }
-        const std::string&  symName() const { return m_symName; }
+        llvm::StringRef     symName() const { return m_symName; }
         R_TYPE_ZEBIN        type()    const { return m_type;    }
         uint64_t            addend()  const { return m_addend;  }
 
     private:
         uint64_t m_offset;
-        std::string m_symName;
+        // owned by the builder's string pool
+        llvm::StringRef m_symName;
         R_TYPE_ZEBIN m_type;
         uint64_t m_addend;
     };
@@ -307,8 +331,10 @@ private:
 
     class RelocSection : public Section {
     public:
-        RelocSection(SectionID myID, SectionID targetID, std::string sectName, bool isRelFormat) :
-            Section(myID), m_TargetID(targetID), m_sectName(sectName), m_isRelFormat (isRelFormat)
+        RelocSection(SectionID myID, SectionID targetID, llvm::StringRef sectName,
+            uint32_t nameOff, bool isRelFormat) :
+            Section(myID), m_TargetID(targetID), m_sectName(sectName),
+            m_nameOff(nameOff), m_isRelFormat (isRelFormat)
         {}
 
         Kind getKind() const { return RELOC; }
@@ -317,7 +343,8 @@ private:
     public:
         // target section's id that this relocation section apply to
         SectionID m_TargetID;
-        std::string m_sectName;
+        llvm::StringRef m_sectName;
+        uint32_t m_nameOff;
         RelocationListTy m_Relocations;
 
         // This is a rel or rela relocation format
@@ -333,7 +360,15 @@ private:
     // isRelFormat - rel or rela relocation format
     RelocSection& getOrCreateRelocSection(SectionID targetSectId, bool isRelFormat);
 
-    std::string getSectionNameBySectionID(SectionID id);
+    llvm::StringRef getSectionNameBySectionID(SectionID id);
+
+    // internString - save str into the string pool and add it into .strtab
+    // return the saved string and set strTabOff to its offset in .strtab
+    llvm::StringRef internString(llvm::StringRef str, uint32_t& strTabOff);
+
+    // streamSection - write the section's payload into the stream given to
+    // streamTo, if any
+    void streamSection(StandardSection& sect);
 
 private:
     // place holder for section default name
@@ -352,6 +387,12 @@ private:
     const std::string m_CompatNoteName = ".note.intelgt.compat";
     const std::string m_StrTabName     = ".strtab";
 
+    // .strtab offsets of the default section names, 0 if not interned yet
+    uint32_t m_SymTabNameOff     = 0;
+    uint32_t m_ZEInfoNameOff     = 0;
+    uint32_t m_CompatNoteNameOff = 0;
+    uint32_t m_StrTabNameOff     = 0;
+
 private:
     // 32 or 64 bit object
     bool m_is64Bit;
@@ -374,6 +415,17 @@ private:
     SymbolListTy m_localSymbols;
     SymbolListTy m_globalSymbols;
 
+    // String pool owning all section, symbol and relocation names. Every
+    // name is added into .strtab when it is created, so the string table
+    // only needs to be written out at finalize
+    llvm::BumpPtrAllocator m_stringAlloc;
+    llvm::UniqueStringSaver m_stringPool{m_stringAlloc};
+    llvm::StringTableBuilder m_strTab{llvm::StringTableBuilder::ELF};
+
+    // the stream section payloads are written into, set by streamTo
+    llvm::raw_pwrite_stream* m_streamOS = nullptr;
+    // position of the ELF header in m_streamOS
+    uint64_t m_streamStart = 0;
 };
 
 /// ZEInfoBuilder - Build a zeInfoContainer for .ze_info section
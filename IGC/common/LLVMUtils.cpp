@@ -72,6 +72,20 @@ llvm::Pass* createFlushPass(llvm::Pass* pass, Dump& dump)
     return nullptr;
 }
 
+static llvm::Pass* createTimeStatsPass(
+    CodeGenContext* ctx, const std::string& pmName, llvm::Pass* pass, TimeStatsCounterStartEndMode mode)
+{
+    std::string passName = pmName + '_' + std::string(pass->getPassName());
+    // Keep function passes within one function pass manager so that the
+    // analyses they share, e.g. between the SIMD variants of EmitPass, are
+    // computed once per function.
+    if (pass->getPassKind() == PT_Function)
+    {
+        return createTimeStatsIGCFunctionPass(ctx, passName, mode);
+    }
+    return createTimeStatsIGCPass(ctx, passName, mode);
+}
+
 void IGCPassManager::add(Pass *P)
 {
     //check only once
@@ -105,14 +119,14 @@ void IGCPassManager::add(Pass *P)
 
     if (IGC_REGKEY_OR_FLAG_ENABLED(DumpTimeStatsPerPass, TIME_STATS_PER_PASS))
     {
-        PassManager::add(createTimeStatsIGCPass(m_pContext, m_name + '_' + std::string(P->getPassName()), STATS_COUNTER_START));
+        PassManager::add(createTimeStatsPass(m_pContext, m_name, P, STATS_COUNTER_START));
     }
 
     PassManager::add(P);
 
     if (IGC_REGKEY_OR_FLAG_ENABLED(DumpTimeStatsPerPass, TIME_STATS_PER_PASS))
     {
-        PassManager::add(createTimeStatsIGCPass(m_pContext, m_name + '_' + std::string(P->getPassName()), STATS_COUNTER_END));
+        PassManager::add(createTimeStatsPass(m_pContext, m_name, P, STATS_COUNTER_END));
     }
 
     if (isPrintAfter(P))
@@ -222,7 +236,7 @@ void DumpLLVMIR(IGC::CodeGenContext* pContext, const char* dumpName)
     if (IGC_IS_FLAG_ENABLED(DumpLLVMIR))
     {
         pContext->getMetaDataUtils()->save(*pContext->getLLVMContext());
-        serialize(*(pContext->getModuleMetaData()), pContext->getModule());
+        serialize(*(pContext->getModuleMetaData()), pContext->getModule(), MDSerializationFormat::Readable);
         using namespace IGC::Debug;
         auto name =
             DumpName(IGC::Debug::GetShaderOutputName())
@@ -15,12 +15,16 @@ SPDX-License-Identifier: MIT
 #include <llvm/Support/Casting.h>
 #include <llvm/ADT/StringSwitch.h>
 #include <llvm/ADT/MapVector.h>
+#include <llvm/ADT/DenseMap.h>
 #include "common/LLVMWarningsPop.hpp"
 
 #include "StringMacros.hpp"
 #include "common/igc_regkeys.hpp"
+#include "Probe/Assertion.h"
 
 #include <iostream>
+#include <cstring>
+#include <type_traits>
 
 using namespace llvm;
 
@@ -73,6 +77,170 @@ void readNode(MapVector<Key, Value> &funcMD, MDNode* node);
 template<typename T>
 void readNode(T &t, MDNode* node, StringRef name);
 
+// Binary form of ModuleMetaData. Fields are written in declaration order
+// without names. Functions, globals and types are written as indices into a
+// list of ValueAsMetadata operands stored next to the blob, so LLVM keeps them
+// up to date when values are replaced or deleted.
+namespace
+{
+    const char cBinaryMDMagic[4] = { 'I', 'G', 'C', 'M' };
+    const uint32_t cNullRef = UINT32_MAX;
+
+    struct BinaryMDHeader
+    {
+        char magic[4];
+        // MDFrameWorkLayoutHash of the writer; the encoding has no field
+        // names, so a blob is only readable by a build with the same headers.
+        uint32_t layoutHash;
+    };
+}
+
+class MDBinaryWriter
+{
+public:
+    void writeBytes(const void* data, size_t size)
+    {
+        m_data.append(static_cast<const char*>(data), size);
+    }
+
+    template<typename T>
+    void writePOD(const T& value)
+    {
+        writeBytes(&value, sizeof(T));
+    }
+
+    template<typename T>
+    void patchPOD(size_t offset, const T& value)
+    {
+        memcpy(&m_data[offset], &value, sizeof(T));
+    }
+
+    void writeRef(Value* val)
+    {
+        if (!val)
+        {
+            writePOD(cNullRef);
+            return;
+        }
+        auto it = m_refIndices.insert(std::make_pair(val, (uint32_t)m_refs.size()));
+        if (it.second)
+        {
+            m_refs.push_back(ValueAsMetadata::get(val));
+        }
+        writePOD(it.first->second);
+    }
+
+    size_t size() const { return m_data.size(); }
+    const std::string& data() const { return m_data; }
+    ArrayRef<Metadata*> refs() const { return m_refs; }
+
+private:
+    std::string m_data;
+    std::vector<Metadata*> m_refs;
+    DenseMap<Value*, uint32_t> m_refIndices;
+};
+
+class MDBinaryReader
+{
+public:
+    // refs holds the blob in operand 0 and the referenced values after it.
+    MDBinaryReader(StringRef data, const MDNode* refs)
+        : m_data(data), m_refs(refs) {}
+
+    void readBytes(void* dst, size_t size)
+    {
+        if (m_error || size > m_data.size() - m_offset)
+        {
+            m_error = true;
+            memset(dst, 0, size);
+            return;
+        }
+        memcpy(dst, m_data.data() + m_offset, size);
+        m_offset += size;
+    }
+
+    template<typename T>
+    void readPOD(T& value)
+    {
+        readBytes(&value, sizeof(T));
+    }
+
+    void skip(size_t size)
+    {
+        seek(m_offset + size);
+    }
+
+    void seek(size_t offset)
+    {
+        if (offset > m_data.size())
+        {
+            m_error = true;
+            return;
+        }
+        m_offset = offset;
+    }
+
+    // Returns null for null references and for values that have been
+    // deleted since the module was serialized.
+    Value* readRef()
+    {
+        uint32_t index = cNullRef;
+        readPOD(index);
+        if (index == cNullRef || index + 1 >= m_refs->getNumOperands())
+        {
+            return nullptr;
+        }
+        auto* pVal = dyn_cast_or_null<ValueAsMetadata>(m_refs->getOperand(index + 1).get());
+        return pVal ? pVal->getValue() : nullptr;
+    }
+
+    bool hasError() const { return m_error; }
+
+private:
+    StringRef m_data;
+    const MDNode* m_refs;
+    size_t m_offset = 0;
+    bool m_error = false;
+};
+
+template<typename T>
+typename std::enable_if<std::is_arithmetic<T>::value>::type
+writeBinary(T x, MDBinaryWriter& writer);
+void writeBinary(const std::string& s, MDBinaryWriter& writer);
+void writeBinary(Value* val, MDBinaryWriter& writer);
+void writeBinary(StructType* Ty, MDBinaryWriter& writer);
+template<typename T>
+void writeBinary(const std::vector<T>& vec, MDBinaryWriter& writer);
+template<typename T, size_t s>
+void writeBinary(const std::array<T, s>& arr, MDBinaryWriter& writer);
+template<typename T>
+void writeBinary(const std::optional<T>& option, MDBinaryWriter& writer);
+template<typename Key, typename Value>
+void writeBinary(const std::map<Key, Value>& keyMD, MDBinaryWriter& writer);
+template<typename Key, typename Value>
+void writeBinary(const MapVector<Key, Value>& keyMD, MDBinaryWriter& writer);
+void writeBinary(const MapVector<Function*, IGC::FunctionMetaData>& funcMD, MDBinaryWriter& writer);
+
+template<typename T>
+typename std::enable_if<std::is_arithmetic<T>::value>::type
+readBinary(T& x, MDBinaryReader& reader);
+void readBinary(std::string& s, MDBinaryReader& reader);
+void readBinary(Value*& val, MDBinaryReader& reader);
+void readBinary(Function*& funcPtr, MDBinaryReader& reader);
+void readBinary(GlobalVariable*& globalVar, MDBinaryReader& reader);
+void readBinary(StructType*& Ty, MDBinaryReader& reader);
+template<typename T>
+void readBinary(std::vector<T>& vec, MDBinaryReader& reader);
+template<typename T, size_t s>
+void readBinary(std::array<T, s>& arr, MDBinaryReader& reader);
+template<typename T>
+void readBinary(std::optional<T>& option, MDBinaryReader& reader);
+template<typename Key, typename Value>
+void readBinary(std::map<Key, Value>& keyMD, MDBinaryReader& reader);
+template<typename Key, typename Value>
+void readBinary(MapVector<Key, Value>& keyMD, MDBinaryReader& reader);
+void readBinary(MapVector<Function*, IGC::FunctionMetaData>& funcMD, MDBinaryReader& reader);
+
 //including auto-generated functions
 #include "MDNodeFunctions.gen"
 namespace IGC
@@ -446,18 +614,316 @@ void readNode(T &t, MDNode* node, StringRef name)
     }
 }
 
+template<typename T>
+typename std::enable_if<std::is_arithmetic<T>::value>::type
+writeBinary(T x, MDBinaryWriter& writer)
+{
+    writer.writePOD(x);
+}
+
+void writeBinary(const std::string& s, MDBinaryWriter& writer)
+{
+    writer.writePOD((uint32_t)s.size());
+    writer.writeBytes(s.data(), s.size());
+}
+
+void writeBinary(Value* val, MDBinaryWriter& writer)
+{
+    writer.writeRef(val);
+}
+
+void writeBinary(StructType* Ty, MDBinaryWriter& writer)
+{
+    writer.writeRef(Ty ? UndefValue::get(Ty) : nullptr);
+}
+
+template<typename T>
+void writeBinary(const std::vector<T>& vec, MDBinaryWriter& writer)
+{
+    writer.writePOD((uint32_t)vec.size());
+    for (const T& vecEle : vec)
+    {
+        writeBinary(vecEle, writer);
+    }
+}
+
+template<typename T, size_t s>
+void writeBinary(const std::array<T, s>& arr, MDBinaryWriter& writer)
+{
+    for (const T& arrEle : arr)
+    {
+        writeBinary(arrEle, writer);
+    }
+}
+
+template<typename T>
+void writeBinary(const std::optional<T>& option, MDBinaryWriter& writer)
+{
+    writer.writePOD(option.has_value());
+    if (option.has_value())
+    {
+        writeBinary(*option, writer);
+    }
+}
+
+template<typename Key, typename Value>
+void writeBinary(const std::map<Key, Value>& keyMD, MDBinaryWriter& writer)
+{
+    writer.writePOD((uint32_t)keyMD.size());
+    for (const auto& it : keyMD)
+    {
+        writeBinary(it.first, writer);
+        writeBinary(it.second, writer);
+    }
+}
+
+template<typename Key, typename Value>
+void writeBinary(const MapVector<Key, Value>& keyMD, MDBinaryWriter& writer)
+{
+    writer.writePOD((uint32_t)keyMD.size());
+    for (const auto& it : keyMD)
+    {
+        writeBinary(it.first, writer);
+        writeBinary(it.second, writer);
+    }
+}
+
+// Every FunctionMetaData is prefixed with its size so that the entries of
+// functions deleted since serialization can be skipped.
+void writeBinary(const MapVector<Function*, IGC::FunctionMetaData>& funcMD, MDBinaryWriter& writer)
+{
+    writer.writePOD((uint32_t)funcMD.size());
+    for (const auto& it : funcMD)
+    {
+        writer.writeRef(it.first);
+        size_t sizeOffset = writer.size();
+        writer.writePOD((uint32_t)0);
+        writeBinary(it.second, writer);
+        writer.patchPOD(sizeOffset, (uint32_t)(writer.size() - sizeOffset - sizeof(uint32_t)));
+    }
+}
+
+template<typename T>
+typename std::enable_if<std::is_arithmetic<T>::value>::type
+readBinary(T& x, MDBinaryReader& reader)
+{
+    reader.readPOD(x);
+}
+
+void readBinary(std::string& s, MDBinaryReader& reader)
+{
+    uint32_t size = 0;
+    reader.readPOD(size);
+    if (reader.hasError())
+    {
+        return;
+    }
+    s.resize(size);
+    reader.readBytes(&s[0], size);
+}
+
+void readBinary(Value*& val, MDBinaryReader& reader)
+{
+    val = reader.readRef();
+}
+
+void readBinary(Function*& funcPtr, MDBinaryReader& reader)
+{
+    funcPtr = dyn_cast_or_null<Function>(reader.readRef());
+}
+
+void readBinary(GlobalVariable*& globalVar, MDBinaryReader& reader)
+{
+    globalVar = dyn_cast_or_null<GlobalVariable>(reader.readRef());
+}
+
+void readBinary(StructType*& Ty, MDBinaryReader& reader)
+{
+    Value* v = reader.readRef();
+    Ty = v ? dyn_cast<StructType>(v->getType()) : nullptr;
+}
+
+template<typename T>
+void readBinary(std::vector<T>& vec, MDBinaryReader& reader)
+{
+    uint32_t count = 0;
+    reader.readPOD(count);
+    for (uint32_t i = 0; i < count && !reader.hasError(); i++)
+    {
+        T vecEle;
+        readBinary(vecEle, reader);
+        vec.push_back(vecEle);
+    }
+}
+
+template<typename T, size_t s>
+void readBinary(std::array<T, s>& arr, MDBinaryReader& reader)
+{
+    for (T& arrEle : arr)
+    {
+        readBinary(arrEle, reader);
+    }
+}
+
+template<typename T>
+void readBinary(std::optional<T>& option, MDBinaryReader& reader)
+{
+    bool hasValue = false;
+    reader.readPOD(hasValue);
+    if (hasValue)
+    {
+        T tmp;
+        readBinary(tmp, reader);
+        option = tmp;
+    }
+    else
+    {
+        option = std::nullopt;
+    }
+}
+
+template<typename Key, typename Value>
+void readBinary(std::map<Key, Value>& keyMD, MDBinaryReader& reader)
+{
+    uint32_t count = 0;
+    reader.readPOD(count);
+    for (uint32_t i = 0; i < count && !reader.hasError(); i++)
+    {
+        std::pair<Key, Value> p;
+        readBinary(p.first, reader);
+        readBinary(p.second, reader);
+        keyMD.insert(p);
+    }
+}
+
+template<typename Key, typename Value>
+void readBinary(MapVector<Key, Value>& keyMD, MDBinaryReader& reader)
+{
+    uint32_t count = 0;
+    reader.readPOD(count);
+    for (uint32_t i = 0; i < count && !reader.hasError(); i++)
+    {
+        std::pair<Key, Value> p;
+        readBinary(p.first, reader);
+        readBinary(p.second, reader);
+        keyMD.insert(p);
+    }
+}
+
+void readBinary(MapVector<Function*, IGC::FunctionMetaData>& funcMD, MDBinaryReader& reader)
+{
+    uint32_t count = 0;
+    reader.readPOD(count);
+    for (uint32_t i = 0; i < count && !reader.hasError(); i++)
+    {
+        Function* F = dyn_cast_or_null<Function>(reader.readRef());
+        uint32_t size = 0;
+        reader.readPOD(size);
+        if (!F)
+        {
+            // The function was deleted after the metadata was serialized.
+            reader.skip(size);
+            continue;
+        }
+        readBinary(funcMD[F], reader);
+    }
+}
+
+static const MDNode* getBinaryMDRoot(const Module* module)
+{
+    NamedMDNode* root = module->getNamedMetadata("IGCMetadataBlob");
+    if (!root || root->getNumOperands() == 0)
+    {
+        return nullptr;
+    }
+    const MDNode* node = root->getOperand(0);
+    if (node->getNumOperands() == 0 || !isa_and_nonnull<MDString>(node->getOperand(0).get()))
+    {
+        return nullptr;
+    }
+    return node;
+}
+
+// Positions the reader after a valid header, or returns false if the blob
+// was written by another version.
+static bool readBinaryMDHeader(MDBinaryReader& reader)
+{
+    BinaryMDHeader header;
+    reader.readPOD(header);
+    return !reader.hasError() &&
+        memcmp(header.magic, cBinaryMDMagic, sizeof(cBinaryMDMagic)) == 0 &&
+        header.layoutHash == MDFrameWorkLayoutHash;
+}
+
+// Returns false if the module carries no binary metadata. serialize erases
+// the readable form when it writes the blob, so a blob that cannot be decoded
+// has nothing to fall back to and is a fatal error.
+static bool deserializeBinary(IGC::ModuleMetaData& deserializeMD, const Module* module)
+{
+    const MDNode* node = getBinaryMDRoot(module);
+    if (!node)
+    {
+        return false;
+    }
+    MDBinaryReader reader(cast<MDString>(node->getOperand(0))->getString(), node);
+    bool validHeader = readBinaryMDHeader(reader);
+    IGC_ASSERT_EXIT_MESSAGE(validHeader, "IGCMetadataBlob was written by a different IGC build");
+    readBinary(deserializeMD, reader);
+    IGC_ASSERT_EXIT_MESSAGE(!reader.hasError(), "IGCMetadataBlob is truncated");
+    return true;
+}
+
+static void serializeBinary(const IGC::ModuleMetaData& moduleMD, Module* module)
+{
+    MDBinaryWriter writer;
+    BinaryMDHeader header = {};
+    memcpy(header.magic, cBinaryMDMagic, sizeof(cBinaryMDMagic));
+    header.layoutHash = MDFrameWorkLayoutHash;
+    writer.writePOD(header);
+    writeBinary(moduleMD, writer);
+
+    LLVMContext& C = module->getContext();
+    std::vector<Metadata*> operands;
+    operands.reserve(writer.refs().size() + 1);
+    operands.push_back(MDString::get(C, writer.data()));
+    operands.insert(operands.end(), writer.refs().begin(), writer.refs().end());
+
+    NamedMDNode* LLVMMetadata = module->getOrInsertNamedMetadata("IGCMetadataBlob");
+    LLVMMetadata->clearOperands();
+    LLVMMetadata->addOperand(MDNode::get(C, operands));
+}
+
 void IGC::deserialize(IGC::ModuleMetaData &deserializeMD, const Module* module)
 {
     IGC::ModuleMetaData temp;
     deserializeMD = temp;
+    if (deserializeBinary(deserializeMD, module))
+    {
+        return;
+    }
     NamedMDNode* root = module->getNamedMetadata("IGCMetadata");
     if (!root) { return; } //module has not been serialized with IGCMetadata yet
     MDNode* moduleRoot = root->getOperand(0);
     readNode(deserializeMD, moduleRoot);
 }
 
-void IGC::serialize(const IGC::ModuleMetaData &moduleMD, Module* module)
+void IGC::serialize(const IGC::ModuleMetaData &moduleMD, Module* module, MDSerializationFormat format)
 {
+    // Only one form is kept so that a stale copy is never read back.
+    if (format == MDSerializationFormat::Binary)
+    {
+        if (NamedMDNode* readableMD = module->getNamedMetadata("IGCMetadata"))
+        {
+            module->eraseNamedMetadata(readableMD);
+        }
+        serializeBinary(moduleMD, module);
+        return;
+    }
+
+    if (NamedMDNode* binaryMD = module->getNamedMetadata("IGCMetadataBlob"))
+    {
+        module->eraseNamedMetadata(binaryMD);
+    }
     NamedMDNode* LLVMMetadata = module->getNamedMetadata("IGCMetadata");
     if(LLVMMetadata)
     {
@@ -485,7 +485,18 @@ namespace IGC
         bool hasNoLocalToGenericCast = false;
         bool hasNoPrivateToGenericCast = false;
     };
-    void serialize(const IGC::ModuleMetaData &moduleMD, llvm::Module* module);
+
+    // Binary is a single compact blob that is cheap to write and read back.
+    // Readable spells out every field as named MDNodes, for IR dumps and
+    // ShaderOverride.
+    enum class MDSerializationFormat
+    {
+        Binary,
+        Readable
+    };
+    void serialize(const IGC::ModuleMetaData &moduleMD, llvm::Module* module,
+        MDSerializationFormat format = MDSerializationFormat::Binary);
+    // Reads whichever form the module carries.
     void deserialize(IGC::ModuleMetaData &deserializedMD, const llvm::Module* module);
 
 }
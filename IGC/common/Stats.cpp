@@ -255,149 +255,27 @@ void ShaderStats::printOpcodeStats(ShaderHash hash, ShaderType shaderType, const
     ?*/
 }
 
-void ShaderStats::parseIsaShader( ShaderHash hash, ShaderType shaderType, SIMDMode simd )
+void ShaderStats::recordIsaStats(const VISA_KERNEL_STATS& isaStats)
 {
-
-    std::string line, instStr;
-
-    std::string asmFileName =
-        IGC::Debug::DumpName(IGC::Debug::GetShaderOutputName())
-            .Type(shaderType)
-            .Hash(hash)
-            .SIMDSize(simd)
-            .Extension("asm")
-            .str();
-    if (asmFileName.find_last_of("\\") != std::string::npos)
-    {
-        asmFileName = asmFileName.substr(asmFileName.find_last_of("\\") + 1, asmFileName.size());
-    }
-
-    std::ifstream asmFile(asmFileName.c_str());
-
-    while( getline(asmFile, line) )
+    static const SHADER_STATS_ITEMS kindItems[VISA_INST_KIND_NUM] =
     {
-        if( line == ".code" )
-        {
-            break;
-        }
-    }
-
-    while( getline(asmFile, line) )
-    {
-        if( line == "" || line.find( "//", 0 ) == 0 || line == "main:" || line.find( "label", 0 ) == 0)
-        {
-            continue;
-        }
-        else if (line.find(" ", 0) == std::string::npos && line.find(":", 0) == line.size() - 1)
-        {
-            continue;
-        }
-        else if( line == ".end_code" )
-        {
-            break;
-        }
-
-        if( line.find("(",0 ) == 0 )
-        {
-            line = line.substr( line.find(")",0) + 2, line.length() );
-        }
-
-        instStr = line.substr( 0, line.find(" ", 0) );
-
-        auto hasDot = instStr.find(".",0);
-        if (hasDot != std::string::npos)
-        {
-            instStr = instStr.substr( 0, hasDot );
-        }
+        STATS_ISA_ALU,          // VISA_INST_KIND_ALU
+        STATS_ISA_LOGIC,        // VISA_INST_KIND_LOGIC
+        STATS_ISA_MOV,          // VISA_INST_KIND_MOV
+        STATS_ISA_SEND,         // VISA_INST_KIND_SEND
+        STATS_ISA_SEL_CMP,      // VISA_INST_KIND_SEL_CMP
+        STATS_ISA_STRUCTCF,     // VISA_INST_KIND_STRUCTCF
+        STATS_ISA_GOTOJOIN,     // VISA_INST_KIND_GOTOJOIN
+        STATS_ISA_THREADCF,     // VISA_INST_KIND_THREADCF
+        STATS_ISA_CALL,         // VISA_INST_KIND_CALL
+        STATS_ISA_OTHERS,       // VISA_INST_KIND_OTHERS
+    };
 
-        if( line.find("L",0) == 0  || line.find("_AUTO_LABEL", 0) == 0)
-        {
-            m_CompileShaderStats[STATS_ISA_BASIC_BLOCKS]++;
-        }
-        else if( instStr == "add" || instStr == "addc" || instStr == "avg" || instStr == "dp2" ||
-            instStr == "dp3" || instStr == "dp4" || instStr == "dph" || instStr == "frc" ||
-            instStr == "line" || instStr == "lrp" || instStr == "mac" || instStr == "mach" ||
-            instStr == "mad" || instStr == "madm" || instStr == "math" || instStr == "mul" ||
-            instStr == "pln" || instStr == "rndd" || instStr == "rnde" || instStr == "rndu" ||
-            instStr == "rndz" || instStr == "sad2" || instStr == "sada2" || instStr == "subb" )
-        {
-            m_CompileShaderStats[STATS_ISA_ALU]++;
-        }
-        else if( instStr == "and" || instStr == "asr" || instStr == "bfe" || instStr == "bfi1" ||
-            instStr == "bfi2" || instStr == "bfrev" || instStr == "cbit" || instStr == "fbh" ||
-            instStr == "fbl" || instStr == "lzd" || instStr == "not" || instStr == "or" ||
-            instStr == "shl" || instStr == "shr" || instStr == "xor" )
-        {
-            m_CompileShaderStats[STATS_ISA_LOGIC]++;
-        }
-        else if( instStr == "brc" || instStr == "brd" || instStr == "jumpi")
-        {
-            m_CompileShaderStats[STATS_ISA_THREADCF]++;
-        }
-        else if(instStr == "break" || instStr == "cont" || instStr == "while" ||
-            instStr == "else" || instStr == "endif" || instStr == "if" )
-        {
-            m_CompileShaderStats[STATS_ISA_STRUCTCF]++;
-        }
-        else if( instStr == "goto" || instStr == "join" )
-        {
-            m_CompileShaderStats[STATS_ISA_GOTOJOIN]++;
-        }
-        else if( instStr == "call" || instStr == "calla" )
-        {
-            m_CompileShaderStats[STATS_ISA_CALL]++;
-        }
-        else if( instStr == "cmp" || instStr == "cmpn" || instStr == "csel" || instStr == "sel")
-        {
-            m_CompileShaderStats[STATS_ISA_SEL_CMP]++;
-        }
-        else if( instStr == "mov" || instStr == "movi" || instStr == "smov" )
-        {
-            m_CompileShaderStats[STATS_ISA_MOV]++;
-        }
-        else if( instStr == "send" || instStr == "sendc" || instStr == "sends" )
-        {
-            m_CompileShaderStats[STATS_ISA_SEND]++;
-        }
-        else if( instStr == "halt" || instStr == "illegal" || instStr == "nop" || instStr == "wait" ||
-            instStr == "ret" )
-        {
-            m_CompileShaderStats[STATS_ISA_OTHERS]++;
-        }
-        else if( line.find( "_GOTO_TARGET", 0 ) == 0 )
-        {
-            ;
-        }
-        else
-        {
-            IGC_ASSERT(0);
-        }
-    }
-
-    int statsIndex = STATS_ISA_INST_COUNT;
-    if( simd == SIMDMode::SIMD16 )
-    {
-        statsIndex = STATS_ISA_INST_COUNT_SIMD16;
-    }
-    else if( simd == SIMDMode::SIMD32 )
-    {
-        statsIndex = STATS_ISA_INST_COUNT_SIMD32;
-    }
-
-    for( int i=STATS_ISA_ALU; i<STATS_MAX_SHADER_STATS_ITEMS; i++)
-    {
-        m_CompileShaderStats[statsIndex] += m_CompileShaderStats[i];
-    }
-
-    if( simd == SIMDMode::SIMD16 )
-    {
-        m_CompileShaderStats[STATS_ISA_INST_COUNT_SIMD16] -= m_CompileShaderStats[STATS_ISA_INST_COUNT];
-    }
-    else if( simd == SIMDMode::SIMD32 )
+    for (int i = 0; i < VISA_INST_KIND_NUM; i++)
     {
-        m_CompileShaderStats[STATS_ISA_INST_COUNT_SIMD32] -= m_CompileShaderStats[STATS_ISA_INST_COUNT];
+        m_CompileShaderStats[kindItems[i]] += isaStats.numInstsByKind[i];
     }
-    asmFile.close();
+    m_CompileShaderStats[STATS_ISA_BASIC_BLOCKS] += isaStats.numBBs;
 }
 
 void ShaderStats::sumShaderStat( SHADER_STATS_ITEMS compileInterval, int count )
@@ -23,6 +23,7 @@ SPDX-License-Identifier: MIT
 #include "common/MemStats.h"
 
 #include "AdaptorCommon/customApi.hpp"
+#include "JitterDataStruct.h"
 
 #include <3d/common/iStdLib/utility.h>
 
@@ -69,7 +70,7 @@ public:
 
     void printShaderStats(ShaderHash hash, ShaderType shaderType, const std::string &postFix);
     void printOpcodeStats(ShaderHash hash, ShaderType shaderType, const std::string &postFix);
-    void parseIsaShader(ShaderHash hash, ShaderType shaderType, SIMDMode simd);
+    void recordIsaStats(const VISA_KERNEL_STATS& isaStats);
     int  getShaderStats(SHADER_STATS_ITEMS compileInterval);
     void sumShaderStat(SHADER_STATS_ITEMS compileInterval, int count);
     void miscSumShaderStat(ShaderStats* sStats);
@@ -84,21 +85,7 @@ private:
     int m_TotalSimd32;
 };
 
-#if PRINT_DETAIL_SHADER_STATS
-#define COMPILER_SHADER_STATS_PRINT( shaderStats, shaderType, hash, postFix ) \
-    do \
-    { \
-        if( shaderStats ) \
-        { \
-            (shaderStats)->parseIsaShader( hash, shaderType, SIMDMode::SIMD8 ); \
-            if( shaderType == ShaderType::PIXEL_SHADER || shaderType == ShaderType::COMPUTE_SHADER ) \
-            { \
-                (shaderStats)->parseIsaShader( hash, shaderType, SIMDMode::SIMD16 ); \
-                (shaderStats)->parseIsaShader( hash, shaderType, SIMDMode::SIMD32 ); \
-            } \
-        } \
-    } while (0)
-#elif PRINT_PER_SHADER_STATS
+#if PRINT_PER_SHADER_STATS || PRINT_DETAIL_SHADER_STATS
 #define COMPILER_SHADER_STATS_PRINT( shaderStats, shaderType, hash, postFix) \
     do \
     { \
@@ -122,6 +109,16 @@ private:
         } \
     } while (0)
 
+// Adds the per-category instruction counts vISA recorded for the kernel.
+#define COMPILER_SHADER_STATS_RECORD_ISA( shaderStats, isaStats ) \
+    do \
+    { \
+        if( shaderStats ) \
+        { \
+            (shaderStats)->recordIsaStats( isaStats ); \
+        } \
+    } while (0)
+
 #define COMPILER_SHADER_STATS_SUM( sumShaderStats, shaderStats, shaderType ) \
     do \
     { \
@@ -171,6 +168,7 @@ private:
 #else // GET_SHADER_STATS
 #   define COMPILER_SHADER_STATS_SUM( sumShaderStats, shaderStats, shaderType ) do { } while (0)
 #   define COMPILER_SHADER_STATS_SET( shaderStats, compileInterval, isacount ) do { } while (0)
+#   define COMPILER_SHADER_STATS_RECORD_ISA( shaderStats, isaStats ) do { } while (0)
 #   define COMPILER_SHADER_STATS_PRINT( shaderStats, shaderType, hash, postFix ) do { } while (0)
 #   define COMPILER_SHADER_STATS_PRINT_SUM( sumShaderStats ) do { } while (0)
 #   define COMPILER_SHADER_STATS_INIT( shaderStats ) do { } while (0)
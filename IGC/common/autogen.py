@@ -9,6 +9,7 @@
 import os
 import sys
 import errno
+import zlib
 from typing import List
 
 
@@ -27,6 +28,8 @@ class DeclHeader:
 
 enumNames: List[DeclHeader] = []
 structureNames: List[DeclHeader] = []
+# running checksum of every parsed header; it versions the binary encoding
+layoutHash = 0
 
 
 def parseCmdArgs():
@@ -104,9 +107,12 @@ def extractEnumVal(line, declHeader):
 
 
 def parseFile(fileName, insideIGCNameSpace):
+    global layoutHash
     inputFile = None
     try:
         inputFile = open(fileName, 'r')
+        layoutHash = zlib.crc32(inputFile.read().encode(), layoutHash)
+        inputFile.seek(0)
     except:
         sys.exit("Failed to open the file " + fileName)
 
@@ -213,6 +219,25 @@ def printEnumReadCalls(enumDecl, outputFile):
     outputFile.write("    }\n")
 
 
+def printStructWriteCalls(structDecl, outputFile):
+    for item in structDecl.fields:
+        item = item[:-1]
+        outputFile.write("    writeBinary(" + structDecl.declName + "Var" + "." + item + ", writer);\n")
+
+def printEnumWriteCalls(enumDecl, outputFile):
+    outputFile.write("    writer.writePOD(static_cast<int32_t>(" + enumDecl.declName + "Var));\n")
+
+def printStructBinaryReadCalls(structDecl, outputFile):
+    for item in structDecl.fields:
+        item = item[:-1]
+        outputFile.write("    readBinary(" + structDecl.declName + "Var" + "." + item + ", reader);\n")
+
+def printEnumBinaryReadCalls(enumDecl, outputFile):
+    outputFile.write("    int32_t val = 0;\n")
+    outputFile.write("    reader.readPOD(val);\n")
+    outputFile.write("    " + enumDecl.declName + "Var = static_cast<IGC::" + enumDecl.declName + ">(val);\n")
+
+
 def emitCodeBlock(names: List[DeclHeader], declType, fmtFn, printFn, outputFile):
     for item in names:
         outputFile.write(fmtFn(item.declName))
@@ -242,6 +267,27 @@ def emitStructReadNode(outputFile):
     emitCodeBlock(structureNames, "struct", fmtFn, printStructReadCalls, outputFile)
 
 
+def emitEnumWriteBinary(outputFile):
+    def fmtFn(item):
+        return "void writeBinary(IGC::" + item + " " + item + "Var, MDBinaryWriter& writer)\n"
+    emitCodeBlock(enumNames, "enum", fmtFn, printEnumWriteCalls, outputFile)
+
+def emitStructWriteBinary(outputFile):
+    def fmtFn(item):
+        return "void writeBinary(const IGC::" + item + "& " + item + "Var, MDBinaryWriter& writer)\n"
+    emitCodeBlock(structureNames, "struct", fmtFn, printStructWriteCalls, outputFile)
+
+def emitEnumReadBinary(outputFile):
+    def fmtFn(item):
+        return "void readBinary(IGC::" + item + " &" + item + "Var, MDBinaryReader& reader)\n"
+    emitCodeBlock(enumNames, "enum", fmtFn, printEnumBinaryReadCalls, outputFile)
+
+def emitStructReadBinary(outputFile):
+    def fmtFn(item):
+        return "void readBinary(IGC::" + item + " &" + item + "Var, MDBinaryReader& reader)\n"
+    emitCodeBlock(structureNames, "struct", fmtFn, printStructBinaryReadCalls, outputFile)
+
+
 def genCode(fileName):
     outputFile = None
     try:
@@ -249,10 +295,15 @@ def genCode(fileName):
     except:
         sys.exit("Failed to open the file " + fileName)
 
+    outputFile.write("static const uint32_t MDFrameWorkLayoutHash = " + hex(layoutHash) + ";\n\n")
     emitEnumCreateNode(outputFile)
     emitStructCreateNode(outputFile)
     emitEnumReadNode(outputFile)
     emitStructReadNode(outputFile)
+    emitEnumWriteBinary(outputFile)
+    emitStructWriteBinary(outputFile)
+    emitEnumReadBinary(outputFile)
+    emitStructReadBinary(outputFile)
 
     outputFile.close()
 
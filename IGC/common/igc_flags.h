@@ -177,6 +177,7 @@ DECLARE_IGC_REGKEY(bool, EnableWaveForce32,             false, "Force Wave to us
 DECLARE_IGC_REGKEY(bool, EnableMergeTransposeSLM,       false, "Transpose SLM float3 storage from 3 separate x,y,z buffers to 1 big buffer with xyz consecutively", false)
 DECLARE_IGC_REGKEY(bool, EnableSLMConstProp,            true,   "Enable SLM constant propagation (compute shader only).", false)
 DECLARE_IGC_REGKEY(bool, EnableStatelessToStatefull,    true,  "Enable Stateless To Statefull transformation for global and constant address space in OpenCL kernels", false)
+DECLARE_IGC_REGKEY(bool, EnableStatelessToStatefullAcrossCalls, true, "Enable Stateless To Statefull transformation for kernel argument buffers passed to non-inlined functions", false)
 DECLARE_IGC_REGKEY(bool, EnableStatefulToken,           true,  "Enable generating patch token to indicate a ptr argument is fully converted to stateful (temporary)", false)
 DECLARE_IGC_REGKEY(bool, EnableGenUpdateCB,             false, "Enable derived constant optimization.", false)
 DECLARE_IGC_REGKEY(bool, EnableGenUpdateCBResInfo,      false, "Enable derived constant optimization with resinfo.", false)
@@ -255,6 +256,7 @@ DECLARE_IGC_REGKEY(bool, EnableCosDump, false, "Enable cos dump", true)
 DECLARE_IGC_REGKEY(bool, EnableCisDump, false, "Enable cis dump", true)
 DECLARE_IGC_REGKEY(bool, DumpLLVMIR,                    false, "dump LLVM IR", true)
 DECLARE_IGC_REGKEY(bool, QualityMetricsEnable,          false, "Enable Quality Metrics for IGC", true)
+DECLARE_IGC_REGKEY(bool, EnableLightMetrics,            true,  "Attach low-overhead per-program metrics (counters and histograms) to the zebin as .misc.igc_metrics", true)
 DECLARE_IGC_REGKEY(bool, ShaderDumpEnable,              false, "dump LLVM IR, visaasm, and GenISA", true)
 DECLARE_IGC_REGKEY(bool, ShaderDumpEnableAll,           false, "dump all LLVM IR passes, visaasm, and GenISA", true)
 DECLARE_IGC_REGKEY(DWORD, ShaderDumpEnableG4,           false, "same as ShaderDumpEnable but adds G4 dumps (0 = off, 1 = some, 2 = all)", 0)
@@ -297,6 +299,7 @@ DECLARE_IGC_REGKEY(bool, EnableWriteOldFPToStack,       true,  "Setting this to
 DECLARE_IGC_REGKEY(bool, ZeBinCompatibleDebugging,      true,  "Setting this to 1 (true) enables embed debug info in zeBinary", true)
 DECLARE_IGC_REGKEY(bool, DebugInfoEnforceAmd64EM,       false, "Enforces elf file with the debug infomation to have eMachine set to AMD64", false)
 DECLARE_IGC_REGKEY(bool, DebugInfoValidation,           false, "Enable optional (strict) checks to detect debug information inconsistencies", false)
+DECLARE_IGC_REGKEY(DWORD, DebugInfoThreads,             1,     "Number of threads emitting per-kernel debug info. 0 means one per hardware thread, 1 emits serially (default).", false)
 DECLARE_IGC_REGKEY(debugString, ExtraOCLOptions,        0,     "Extra options for OpenCL", true)
 DECLARE_IGC_REGKEY(debugString, ExtraOCLInternalOptions, 0,    "Extra internal options for OpenCL", true)
 DECLARE_IGC_REGKEY(bool, UseVISAVarNames,               false, "Make VISA generate names for virtual variables so they match with dbg file", true)
@@ -307,6 +310,8 @@ DECLARE_IGC_REGKEY(bool, EnableOCLSIMD32,               true,  "Enable OCL SIMD3
 DECLARE_IGC_REGKEY(DWORD, ForceOCLSIMDWidth,            0,     "Force using SIMD width specified. 0 : no forcing. This overrides driver forced SIMD value(if any) and runtime behaviour could be different if driver expects something fixed", true)
 DECLARE_IGC_REGKEY(bool, SendMultipleSIMDModesCS,       true,  "Send multiple SIMD modes for CS", false)
 DECLARE_IGC_REGKEY(DWORD, OCLSIMD16SelectionMask,       6,     "Select SIMD 16 heuristics. Valid values are 0, 1, 2 and 3", false)
+DECLARE_IGC_REGKEY(DWORD, SIMDSpillPrediction,          0,     "Predict register pressure per SIMD width before codegen. 0: off, 1: log the predictions against the compile outcome to SIMDSpillPrediction.csv, 2: also skip the widths predicted to spill when another width can be used instead", false)
+DECLARE_IGC_REGKEY(DWORD, SIMDSpillPredictionThreshold, 100,   "Percentage of the GRFs per thread that the predicted register pressure may reach before a SIMD width is considered likely to spill", false)
 DECLARE_IGC_REGKEY(bool, EnableHSSinglePatchDispatch,   false, "Setting this to 1/true enables SIMD8 single-patch dispatch in HullShader. Default is either SIMD8 single patch/dual patch dispatch based on control point count", false)
 DECLARE_IGC_REGKEY(bool, DisableGPGPUIndirectPayload,   false, "Disable OCL indirect GPGPU payload", false)
 DECLARE_IGC_REGKEY(bool, DisableDSDualPatch,            false, "Setting it to true with enable Single and Dual Patch dispatch mode for Domain Shader", false)
@@ -327,6 +332,9 @@ DECLARE_IGC_REGKEY(bool, EnableTypeDemotion,            true,  "Enable Type Demo
 DECLARE_IGC_REGKEY(bool, EnablePreRARematFlag,          true,  "Enable PreRA Rematerialization of Flag", false)
 DECLARE_IGC_REGKEY(bool, EnableGASResolver,             true,  "Enable GAS Resolver", false)
 DECLARE_IGC_REGKEY(bool, EnableLowerGPCallArg,          true,  "Enable pass to lower generic pointers in function arguments", false)
+DECLARE_IGC_REGKEY(bool, EnableGASSpecialization,       true,  "Clone functions whose generic pointer arguments come from different address spaces so that each clone can be lowered", false)
+DECLARE_IGC_REGKEY(DWORD, GASSpecializationMaxInsts,    500,   "Maximum number of instructions of a function cloned by EnableGASSpecialization", false)
+DECLARE_IGC_REGKEY(DWORD, GASSpecializationMaxClones,   3,     "Maximum number of clones made of one function by EnableGASSpecialization", false)
 DECLARE_IGC_REGKEY(bool, DisableRecompilation,          false, "Disable recompilation", false)
 DECLARE_IGC_REGKEY(bool, SampleMultiversioning,         false, "Create branches aroung samplers which can be redundant with some values", false)
 DECLARE_IGC_REGKEY(bool, EnableSMRescheduling,          false, "Change instruction order to enable extra Sample Multiversioning cases", false)
@@ -366,6 +374,10 @@ DECLARE_IGC_REGKEY(DWORD, OverrideRevIdForWA,           0xff,   "Enable this to
 DECLARE_IGC_REGKEY(DWORD, OverrideDeviceIdForWA,          0,   "Enable this to override DeviceId ", false)
 DECLARE_IGC_REGKEY(DWORD, OverrideProductFamilyForWA,     0,   "Enable this to override the product family, get the correct enum from igfxfmid.h", false)
 DECLARE_IGC_REGKEY(bool, EnableImplicitArgAsIntrinsic,  true,  "Use GenISAIntrinsic instructions for supported implicit args instead of passing them as function arguments", true)
+DECLARE_IGC_REGKEY(debugString, ProgramBinaryCacheDir,  0,     "Enables the on-disk OpenCL program binary cache in the given directory. Identical builds are served from the cache.", true)
+DECLARE_IGC_REGKEY(DWORD, ProgramBinaryCacheMaxSizeMB,  1024,  "Size limit of the program binary cache in MB. Least recently used entries are evicted beyond it. 0 means unlimited.", true)
+DECLARE_IGC_REGKEY(bool, EnableLazySPIRVTranslation,   true,  "Translate only SPIR-V functions reachable from kernels, exported or indirectly referenced functions", false)
+DECLARE_IGC_REGKEY(DWORD, TranslateBatchThreads,        0,     "Number of threads used by the batch translation API. 0 means one per hardware thread.", true)
 
 
 DECLARE_IGC_REGKEY(bool, EnableGlobalStateBuffer,              false, "This key allows stack calls to read implicit args from side buffer. It also emits a relocatable add in VISA.", true)
@@ -411,6 +423,7 @@ DECLARE_IGC_REGKEY(bool, AllowNonLoopConstantPromotion, false, "Allows promotion
 DECLARE_IGC_REGKEY(DWORD, ConstantPromotionSize,        2, "Threshold in number of GRFs", false)
 DECLARE_IGC_REGKEY(DWORD, ConstantPromotionCmpSelSize,  4, "Array size threshold for cmp-sel transform", false)
 DECLARE_IGC_REGKEY(bool, EnableVariableReuse,           true, "Enable local variable reuse", false)
+DECLARE_IGC_REGKEY(bool, EnableUniformBroadcastReuse,   true, "Reuse the broadcast of a uniform value for later uses in the same basic block", false)
 DECLARE_IGC_REGKEY(bool, EnableVariableAlias,           true, "Enable variable aliases (part of VariableReuse Pass, but separate functionality)", false)
 DECLARE_IGC_REGKEY(DWORD, VATemp,                       0, "[temp]New code to replace code under EnableVATemp (removed already). Once stable, remove this.", false)
 DECLARE_IGC_REGKEY(bool, EnableExtractMask,             false, "When enabled, it is mostly for reducing response size of send messages.", false)
@@ -451,6 +464,7 @@ DECLARE_IGC_REGKEY(DWORD, FastestS1Experiments,         0,      "Select configs
 DECLARE_IGC_REGKEY(bool, EnableFastestForVulkan,        false,   "Enable Fastest/LinearScanRA to run on Vulkan unit test case.", false)
 DECLARE_IGC_REGKEY(bool, FastestWALinearScanForCS,      true,   "WA LinearScanRA for fastest in CS due to regressions.", false)
 DECLARE_IGC_REGKEY(bool, ForceFastestSIMD, false,  "Force pixel shader to return SIMD8 as fast as possible.", false)
+DECLARE_IGC_REGKEY(DWORD, CompileTimeBudget,            0,      "Compile-time budget in milliseconds for each kernel compiled by vISA, counted separately for every SIMD variant. Expensive vISA phases switch to cheaper algorithms once it runs out. 0 means unlimited.", false)
 DECLARE_IGC_REGKEY(bool, ForceBestSIMD, false,  "Force pixel shader to return the best SIMD, either SIMD16 or SIMD8.", false)
 DECLARE_IGC_REGKEY(bool, SkipTREarlyExitCheck, false, "Skip SIMD16 early exit check in ShaderCodeGen", false)
 DECLARE_IGC_REGKEY(bool, EnableTCSHWBarriers, false,  "Enable TCS pass with HW barriers support. Default TCS pass is TCS pass with multiple continuation functions.", false)
@@ -477,6 +491,9 @@ DECLARE_IGC_REGKEY(bool, EnableTEFactorsClear, true,  "Enable clearing of tessel
 DECLARE_IGC_REGKEY(bool, EnableSubroutineForEmulation,  true,  "Enable subroutine call support when emulation(double) is on. Heuristic decides which use subroutine calls.", false)
 DECLARE_IGC_REGKEY(bool, ForceSubroutineForEmulation,   false,  "Force subroutine call for all emulation functions if emulation(double) is on.", false)
 DECLARE_IGC_REGKEY(DWORD, InlinedEmulationThreshold,    125000, "Inlined instruction threshold for enabling subroutines", false)
+DECLARE_IGC_REGKEY(DWORD, InlinedEmulationCallerThreshold, 0, "Inlined instruction threshold per caller for enabling subroutines for an emulation function. 0 disables the per-caller limit", false)
+DECLARE_IGC_REGKEY(bool, EnableEmulationCSE,           false,  "Run EarlyCSE after inlining emulation functions to share operand unpacking between emulated operations", false)
+DECLARE_IGC_REGKEY(DWORD, TestIGCPreCompiledFunctions,  0,     "Emulation kinds (EmuKind bits) PreCompiledFuncImport handles when igc_opt creates it without a context, e.g. 2 for DP emulation", false)
 DECLARE_IGC_REGKEY(int, ByPassAllocaSizeHeuristic,   0,  "Force some Alloca to pass the pressure heuristic until the given size", false)
 DECLARE_IGC_REGKEY(DWORD, MemOptWindowSize,   150,  "Size of the window in unit of instructions in which load/stores are allowed to be coalesced. Keep it limited in order to avoid creating long liveranges. Default value is 150", false)
 DECLARE_IGC_REGKEY(bool, ForceNoFP64bRegioning, false, "force regioning rules for FP and 64b FPU instructions", false)
@@ -501,6 +518,9 @@ DECLARE_IGC_REGKEY(DWORD, OverrideOCLMaxParamSize, 0,  "Override the value impos
 DECLARE_IGC_REGKEY(bool, EnableOptReportPrivateMemoryToSLM, false, "[POC] Generate opt report file for moving private memory allocations to SLM.", false)
 DECLARE_IGC_REGKEY(bool, ForceAllPrivateMemoryToSLM, false, "[POC] Force moving all private memory allocations to SLM.", false)
 DECLARE_IGC_REGKEY(debugString, ForcePrivateMemoryToSLMOnBuffers, 0, "[POC] Force moving private memory allocations to SLM, semicolon-separated list of buffers.", false)
+DECLARE_IGC_REGKEY(DWORD, PrivateMemoryLayout, 0, "Layout of private arrays in scratch or stateless memory. 0: interleaved in scratch, chosen per alloca by a cost model in stateless memory, 1: per lane, 2: interleaved across SIMD lanes whenever possible", false)
+DECLARE_IGC_REGKEY(bool, EnablePrivateMemoryBlockRead, false, "Read interleaved stateless private arrays with SIMD block reads when the index is uniform", false)
+DECLARE_IGC_REGKEY(bool, EnableOptReportPrivateMemoryLayout, false, "Generate opt report file with the memory and layout chosen for each private memory allocation.", false)
 DECLARE_IGC_REGKEY(bool, ForcePrivateMemoryToGlobalOnGeneric, true, "Force moving private memory allocations to global buffer when generic pointer is present", true)
 DECLARE_IGC_REGKEY(bool, DetectCastToGAS,                     true, "Check if the module contains local/private to GAS (Gerneric Address Space) cast, it also check internal flags", true)
 
@@ -28,4 +28,6 @@ DEFINE_SHADER_STAT( STATS_ISA_GOTOJOIN,                   "Goto Join"        )
 DEFINE_SHADER_STAT( STATS_ISA_THREADCF,                   "Thread CF"        )
 DEFINE_SHADER_STAT( STATS_ISA_CALL,                       "Call"             )
 DEFINE_SHADER_STAT( STATS_ISA_OTHERS,                     "Others"           )
+DEFINE_SHADER_STAT( STATS_UNIFORM_BROADCAST_MOVS_SAVED,   "Uniform broadcast movs saved" )
+DEFINE_SHADER_STAT( STATS_UNIFORM_BROADCAST_BYTES_SAVED,  "Uniform broadcast bytes saved" )
 DEFINE_SHADER_STAT( STATS_MAX_SHADER_STATS_ITEMS,         ""                 )
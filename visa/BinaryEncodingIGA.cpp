@@ -975,10 +975,21 @@ void BinaryEncodingIGA::Encode()
     }
 
     // encodedPC is available after encoding
+    uint32_t numCompactedInsts = 0;
     for (auto&& inst : encodedInsts)
     {
-        inst.second->setGenOffset(inst.first->getPC());
+        int32_t pc = inst.first->getPC();
+        inst.second->setGenOffset(pc);
+
+        // CmptCtrl is bit 29 of the first dword on all platforms
+        uint32_t dw0;
+        memcpy_s(&dw0, sizeof(dw0), (const uint8_t*)m_kernelBuffer + pc, sizeof(dw0));
+        if (dw0 & (1u << 29))
+        {
+            numCompactedInsts++;
+        }
     }
+    kernel.fg.builder->getJitInfo()->stats.numCompactedInsts = numCompactedInsts;
     if (kernel.hasPerThreadPayloadBB())
     {
         kernel.fg.builder->getJitInfo()->offsetToSkipPerThreadDataLoad =
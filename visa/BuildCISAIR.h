@@ -73,6 +73,7 @@ public:
     // Used for inline asm code generation
     VISA_BUILDER_API int ParseVISAText(const std::string& visaText, const std::string& visaTextFile) override;
     VISA_BUILDER_API int ParseVISAText(const std::string& visaFile) override;
+    VISA_BUILDER_API int ParseVISAInlineAsm(VISAKernel* kernel, const std::string& asmText) override;
     VISA_BUILDER_API std::stringstream& GetAsmTextStream() override { return m_ssIsaAsm; }
     VISA_BUILDER_API VISAKernel* GetVISAKernel(const std::string& kernelName) override;
     VISA_BUILDER_API int ClearAsmTextStreams() override;
@@ -100,6 +101,15 @@ public:
 
     bool debugParse() const {return m_options.getOption(vISA_DebugParse);}
 
+    // The lexer returns INLINE_ASM_START once when ParseVISAInlineAsm starts,
+    // so that the parser accepts statements without a listing header.
+    bool takeInlineAsmStartToken()
+    {
+        bool start = m_inlineAsmStart;
+        m_inlineAsmStart = false;
+        return start;
+    }
+
     int verifyVISAIR();
 
 
@@ -870,6 +880,8 @@ private:
     unsigned int m_kernel_count = 0;
     unsigned int m_function_count = 0;
 
+    bool m_inlineAsmStart = false;
+
     // list of kernels and functions added to this builder
     std::list<VISAKernelImpl *> m_kernelsAndFunctions;
     // for cases of several kernels/functions in one CisaBuilder
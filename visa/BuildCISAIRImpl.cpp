@@ -893,6 +893,7 @@ typedef struct yy_buffer_state * YY_BUFFER_STATE;
 extern int CISAparse(CISA_IR_Builder *builder);
 extern YY_BUFFER_STATE CISA_scan_string(const char* yy_str);
 extern void CISA_delete_buffer(YY_BUFFER_STATE buf);
+extern int CISAlineno;
 
 int CISA_IR_Builder::ParseVISAText(const std::string& visaText, const std::string& visaTextFile)
 {
@@ -985,6 +986,63 @@ int CISA_IR_Builder::ParseVISAText(const std::string& visaFile)
 #endif
 }
 
+// Parses an inline asm fragment directly into kernel. Operands are bound
+// through the kernel's name map, so unlike ParseVISAText the rest of the
+// kernel never has to be printed and re-parsed.
+int CISA_IR_Builder::ParseVISAInlineAsm(VISAKernel* kernel, const std::string& asmText)
+{
+#if defined(__linux__) || defined(_WIN64) || defined(_WIN32)
+    if (!m_options.getOption(vISA_NameVarsForInlineAsm))
+    {
+        assert(0 && "vISA_NameVarsForInlineAsm must be set before the kernel is added");
+        return VISA_FAILURE;
+    }
+
+    // Direct output of parser to null
+#if defined(_WIN64) || defined(_WIN32)
+    CISAout = fopen("nul", "w");
+#else
+    CISAout = fopen("/dev/null", "w");
+#endif
+
+    VISAKernelImpl* prevKernel = m_kernel;
+    m_kernel = static_cast<VISAKernelImpl*>(kernel);
+
+    // Declarations in the fragment get their own scope, as they would in a
+    // listing, so fragments may reuse names and shadow kernel variables.
+    m_options.setOptionInternally(vISA_isParseMode, true);
+    m_kernel->pushIndexMapScopeLevel();
+    m_inlineAsmStart = true;
+    CISAlineno = 1;
+
+    int status = VISA_SUCCESS;
+    YY_BUFFER_STATE visaBuf = CISA_scan_string(asmText.c_str());
+    if (CISAparse(this) != 0)
+    {
+#ifndef DLL_MODE
+        std::cerr << "Parsing inline vISA assembly failed.\n" << criticalMsg.str();
+#endif //DLL_MODE
+        status = VISA_FAILURE;
+    }
+    CISA_delete_buffer(visaBuf);
+
+    m_inlineAsmStart = false;
+    m_kernel->popIndexMapScopeLevel();
+    m_options.setOptionInternally(vISA_isParseMode, false);
+    m_kernel = prevKernel;
+
+    if (CISAout)
+    {
+        fclose(CISAout);
+    }
+
+    return status;
+#else
+    assert(0 && "vISA asm parsing not supported on this platform");
+    return VISA_FAILURE;
+#endif
+}
+
 // default size of the kernel mem manager in bytes
 #define KERNEL_MEM_SIZE    (4*1024*1024)
 int CISA_IR_Builder::Compile(const char* nameInput, std::ostream* os, bool emit_visa_only)
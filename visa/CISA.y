@@ -211,7 +211,7 @@ std::vector<attr_gen_struct*> AttrOptVar;
     CISA_GEN_VAR*          vISADecl;
 } // end of possible token types
 
-%start Listing
+%start Input
 
 %type <intval> ScopeStart
 
@@ -231,6 +231,9 @@ std::vector<attr_gen_struct*> AttrOptVar;
 %token          DIRECTIVE_PARAMETER   // .parameter
 %token          DIRECTIVE_VERSION     // .verions
 
+// first token of an inline asm fragment (see ParseVISAInlineAsm)
+%token          INLINE_ASM_START
+
 // tokens to support .decl and .input
 %token ALIAS_EQ             // .decl ... alias=...
 %token ALIGN_EQ             // .decl ... align=...
@@ -516,11 +519,18 @@ std::vector<attr_gen_struct*> AttrOptVar;
 
 
 %%
+Input: Listing | InlineAsmFragment
+
 Listing: NewlinesOpt ListingHeader NewlinesOpt Statements NewlinesOpt {
         TRACE("** Listing Complete\n");
         pBuilder->CISA_post_file_parse();
     }
 
+// statements appended to the current kernel without a listing header
+InlineAsmFragment:
+      INLINE_ASM_START NewlinesOpt
+    | INLINE_ASM_START NewlinesOpt Statements NewlinesOpt
+
 ListingHeader: DirectiveVersion
 
 Statements: Statements Newlines Statement | Statement
@@ -11,6 +11,7 @@ SPDX-License-Identifier: MIT
 #include <cstdio>
 #include <map>
 #include <tuple>
+#include <unordered_map>
 
 #include "cm_fc_ld.h"
 
@@ -19,31 +20,26 @@ SPDX-License-Identifier: MIT
 using namespace cm::patch;
 
 
-DepNode *DepGraph::getDepNode(Binary *B, unsigned Off, bool Barrier = false) {
-  auto P = std::make_tuple(B, Off, Barrier);
-  auto I = NodeMap.find(P);
-  if (I != NodeMap.end())
-    return I->second;
-  Nodes.push_back(DepNode{B, Off, Barrier});
-  DepNode *N = &Nodes.back();
-  NodeMap[P] = N;
-  return N;
+unsigned DepGraph::getDepNode(Binary *B, unsigned Off, bool Barrier = false) {
+  auto I = NodeMap.insert(
+      std::make_pair(std::make_tuple(B, Off, Barrier), unsigned(Nodes.size())));
+  if (I.second)
+    Nodes.push_back(DepNode{B, Off, Barrier});
+  return I.first->second;
 }
 
-DepEdge *DepGraph::getDepEdge(DepNode *From, DepNode *To, bool FromDef) {
+unsigned DepGraph::getDepEdge(unsigned From, unsigned To, bool FromDef) {
   if (From == To) // No dependency on itself.
-    return nullptr;
-  auto P = std::make_pair(From, To);
-  auto I = EdgeMap.find(P);
-  if (I != EdgeMap.end())
-    return I->second;
+    return INVALID_ID;
+  uint64_t Key = uint64_t(From) << 32 | To;
+  auto I = EdgeMap.insert(std::make_pair(Key, unsigned(Edges.size())));
+  if (!I.second)
+    return I.first->second;
   // Add new edge.
   Edges.push_back(DepEdge{From, To, FromDef});
-  DepEdge *E = &Edges.back();
-  EdgeMap[P] = E;
-  From->addToNode(To, FromDef);
-  To->addFromNode(From);
-  return E;
+  Nodes[From].addToNode(To, FromDef);
+  Nodes[To].addFromNode(From);
+  return I.first->second;
 }
 
 void DepGraph::build() {
@@ -51,18 +47,19 @@ void DepGraph::build() {
   if (Policy == SWSB_POLICY_0 || Policy == SWSB_POLICY_2)
     return;
 
-  std::map<unsigned, DepNode *> State;
+  // The last node accessing each register.
+  std::map<unsigned, unsigned> State;
 
-  auto requireDefSync = [](std::map<unsigned, DepNode *> &State) {
+  auto requireDefSync = [this](std::map<unsigned, unsigned> &State) {
     for (auto &KV : State)
-      if (KV.second->isDefByToken(KV.first))
+      if (Nodes[KV.second].isDefByToken(KV.first))
         return true;
     return false;
   };
 
-  auto requireUseSync = [](std::map<unsigned, DepNode *> &State) {
+  auto requireUseSync = [this](std::map<unsigned, unsigned> &State) {
     for (auto &KV : State)
-      if (KV.second->isUseByToken(KV.first))
+      if (Nodes[KV.second].isUseByToken(KV.first))
         return true;
     return false;
   };
@@ -79,7 +76,8 @@ void DepGraph::build() {
       Symbol *Sym = Rel.getSymbol();
       Binary &Callee = *Sym->getBinary();
       // Add a barrier node just before 'call' to resolve dependency.
-      DepNode *Node = getDepNode(&B, Rel.getOffset(), true);
+      unsigned NodeId = getDepNode(&B, Rel.getOffset(), true);
+      DepNode *Node = &Nodes[NodeId];
       for (auto RI = Callee.initreg_begin(),
                 RE = Callee.initreg_end(); RI != RE; ++RI) {
         unsigned Reg = RI->getRegNo();
@@ -91,7 +89,7 @@ void DepGraph::build() {
             Node->clearAccList();
             if (reqDefSync) Node->setRdTokenMask(unsigned(-1));
             if (reqUseSync) Node->setWrTokenMask(unsigned(-1));
-            B.insertSyncPoint(Node);
+            B.insertSyncPoint(NodeId);
           // Clear state after barrier.
           State.clear();
           break;
@@ -101,18 +99,19 @@ void DepGraph::build() {
         auto SI = State.find(Reg);
         if (SI == State.end())
           continue;
-        auto From = SI->second;
+        const DepNode &From = Nodes[SI->second];
         // Skip access not by token.
-        if (!From->isDefByToken(Reg) && !From->isUseByToken(Reg))
+        if (!From.isDefByToken(Reg) && !From.isUseByToken(Reg))
           continue;
         // Skip RAR.
-        if (From->isUseOnly(Reg) && RI->isUse())
+        if (From.isUseOnly(Reg) && RI->isUse())
           continue;
         Node->appendRegAcc(&*RI);
-        //auto E = getDepEdge(From, Node, From->isDef(Reg));
+        //auto E = getDepEdge(SI->second, NodeId, From.isDef(Reg));
       }
       // Only update token-based dependency.
-      Node = getDepNode(&B, Rel.getOffset());
+      NodeId = getDepNode(&B, Rel.getOffset());
+      Node = &Nodes[NodeId];
       for (auto RI = Callee.finireg_begin(),
                 RE = Callee.finireg_end(); RI != RE; ++RI) {
         // Skip use-only access without token associated.
@@ -120,7 +119,7 @@ void DepGraph::build() {
           continue;
         unsigned Reg = RI->getRegNo();
         Node->appendRegAcc(&*RI);
-        State[Reg] = Node;
+        State[Reg] = NodeId;
       }
       continue;
     }
@@ -133,10 +132,11 @@ void DepGraph::build() {
         bool reqDefSync = requireDefSync(State);
         bool reqUseSync = requireUseSync(State);
         if (reqDefSync || reqUseSync) {
-          DepNode *Node = getDepNode(&B, RI->getOffset(), true);
-          if (reqDefSync) Node->setRdTokenMask(unsigned(-1));
-          if (reqUseSync) Node->setWrTokenMask(unsigned(-1));
-          B.insertSyncPoint(Node);
+          unsigned NodeId = getDepNode(&B, RI->getOffset(), true);
+          DepNode &Node = Nodes[NodeId];
+          if (reqDefSync) Node.setRdTokenMask(unsigned(-1));
+          if (reqUseSync) Node.setWrTokenMask(unsigned(-1));
+          B.insertSyncPoint(NodeId);
         // Clean state after barrier.
         State.clear();
         break;
@@ -146,16 +146,17 @@ void DepGraph::build() {
       // Skip if that register has no dependency.
       if (SI == State.end())
         continue;
-      auto From = SI->second;
+      const DepNode &From = Nodes[SI->second];
       // Skip if the previous node is a use without token.
-      if (From->isUseNotByToken(Reg))
+      if (From.isUseNotByToken(Reg))
         continue;
       // Skip RAR.
-      if (From->isUseOnly(Reg) && RI->isUse())
+      if (From.isUseOnly(Reg) && RI->isUse())
         continue;
-      auto To = getDepNode(&B, RI->getOffset());
-      To->appendRegAcc(&*RI);
-      //auto E = getDepEdge(From, To, From->isDef(Reg));
+      // Adding the node may reallocate Nodes; don't use From afterwards.
+      unsigned To = getDepNode(&B, RI->getOffset());
+      Nodes[To].appendRegAcc(&*RI);
+      //auto E = getDepEdge(SI->second, To, Nodes[SI->second].isDef(Reg));
     }
     // Update the current from the last access list.
     for (auto RI = B.finireg_begin(), RE = B.finireg_end(); RI != RE; ++RI) {
@@ -163,8 +164,8 @@ void DepGraph::build() {
       if (RI->isUseNotByToken())
         continue;
       unsigned Reg = RI->getRegNo();
-      auto Node = getDepNode(&B, RI->getOffset());
-      Node->appendRegAcc(&*RI);
+      unsigned Node = getDepNode(&B, RI->getOffset());
+      Nodes[Node].appendRegAcc(&*RI);
       State[Reg] = Node;
     }
   }
@@ -181,10 +182,10 @@ void DepGraph::resolve() {
       Binary &B = *I;
       if (B.getLinkType() == CM_FC_LINK_TYPE_CALLEE)
         continue;
-      DepNode *Node = getDepNode(&B, 0, true);
-      Node->setRdTokenMask(unsigned(-1));
-      Node->setWrTokenMask(unsigned(-1));
-      B.insertSyncPoint(Node);
+      unsigned NodeId = getDepNode(&B, 0, true);
+      Nodes[NodeId].setRdTokenMask(unsigned(-1));
+      Nodes[NodeId].setWrTokenMask(unsigned(-1));
+      B.insertSyncPoint(NodeId);
     }
     return;
   }
@@ -200,32 +201,26 @@ void DepGraph::resolve() {
     return 0U;
   };
 
-  auto calcDistance = [](Collection &C,
-                         Binary *From, unsigned FOff,
-                         Binary *To, unsigned TOff) {
+  // Offset of each binary if binaries were laid out back to back in linking
+  // order, and the index of each binary in that order.
+  std::unordered_map<const Binary *, std::pair<unsigned, unsigned>> Layout;
+  unsigned TotalSize = 0;
+  unsigned NumBins = 0;
+  for (auto BI = C.bin_begin(), BE = C.bin_end(); BI != BE; ++BI) {
+    Layout[&*BI] = std::make_pair(TotalSize, NumBins++);
+    TotalSize += unsigned(BI->getSize());
+  }
+
+  auto calcDistance = [&Layout, TotalSize](Binary *From, unsigned FOff,
+                                           Binary *To, unsigned TOff) {
     // Always assuem there's no compact instruction.
     if (From == To)
       return (TOff - FOff) / 16;
-    unsigned D = 0;
-    bool FoundFrom = false;
-    for (auto BI = C.bin_begin(), BE = C.bin_end(); BI != BE; ++BI) {
-      Binary *B = &*BI;
-      if (From == B) {
-        FoundFrom = true;
-        D = unsigned(B->getSize()) - FOff;
-        continue;
-      }
-      if (!FoundFrom)
-        continue;
-      if (To != B) {
-        D += unsigned(B->getSize());
-        continue;
-      }
-      if (To == B) {
-        D += TOff;
-        break;
-      }
-    }
+    auto F = Layout[From];
+    auto T = Layout[To];
+    // If To doesn't follow From, count up to the end of the last binary.
+    unsigned D = (F.second < T.second) ? T.first + TOff : TotalSize;
+    D -= F.first + FOff;
     return D / 16;
   };
 
@@ -238,11 +233,12 @@ void DepGraph::resolve() {
 
   // Fix the dependency. Assume edges are processed in the linking/program
   // order.
-  for (auto EI = Edges.begin(), EE = Edges.end(); EI != EE; ++EI) {
-    auto H = EI->getHead();
-    auto T = EI->getTail();
+  for (std::size_t EI = 0, EE = Edges.size(); EI != EE; ++EI) {
+    bool HeadDef = Edges[EI].isHeadDef();
+    DepNode *H = &Nodes[Edges[EI].getHead()];
+    DepNode *T = &Nodes[Edges[EI].getTail()];
 
-    if (H->to_empty(EI->isHeadDef()) || T->from_empty())
+    if (H->to_empty(HeadDef) || T->from_empty())
       continue;
 
     if (!T->isBarrier())
@@ -252,7 +248,7 @@ void DepGraph::resolve() {
       RegAccess *To = *RI;
       unsigned Reg = To->getRegNo();
       for (auto DI = T->from_begin(), DE = T->from_end(); DI != DE; ++DI) {
-        auto Def = *DI;
+        DepNode *Def = &Nodes[*DI];
         for (auto AI = Def->acc_begin(), AE = Def->acc_end(); AI != AE; ++AI) {
           RegAccess *From = *AI;
           if (From->getRegNo() != Reg)
@@ -265,8 +261,7 @@ void DepGraph::resolve() {
             if (HasToken)
               T->mergeWrTokenMask(1 << Tok);
             else
-              T->updateDistance(calcDistance(C,
-                                             Def->getBinary(), Def->getOffset(),
+              T->updateDistance(calcDistance(Def->getBinary(), Def->getOffset(),
                                              T->getBinary(), T->getOffset()));
           } else if (To->isDef()) {
             // WAR
@@ -291,9 +286,14 @@ void DepGraph::resolve() {
     unsigned NumWrToks = countBits(T->getWrTokenMask());
     if ((NumRdToks + NumWrToks) > 0) {
       // Already has SBID associated. Need to insert additional sync barrier.
-      DepNode *Node = T;
-      if (!T->isBarrier())
-        Node = getDepNode(T->getBinary(), T->getOffset(), true);
+      unsigned TailId = Edges[EI].getTail();
+      unsigned NodeId = TailId;
+      if (!T->isBarrier()) {
+        NodeId = getDepNode(T->getBinary(), T->getOffset(), true);
+        // Adding the node may reallocate Nodes.
+        T = &Nodes[TailId];
+      }
+      DepNode *Node = &Nodes[NodeId];
       // Rd tokens.
       if (NumRdToks == 1)
         Node->setRdTokenMask(T->getRdTokenMask());
@@ -304,11 +304,11 @@ void DepGraph::resolve() {
         Node->setWrTokenMask(T->getWrTokenMask());
       else if (NumWrToks != 0)
         Node->setWrTokenMask(unsigned(-1));
-      T->getBinary()->insertSyncPoint(Node);
+      T->getBinary()->insertSyncPoint(NodeId);
     }
 
     for (auto DI = T->from_begin(), DE = T->from_end(); DI != DE; ++DI)
-      (*DI)->clearToNodes(EI->isHeadDef());
+      Nodes[*DI].clearToNodes(HeadDef);
     T->clearFromNodes();
   }
 }
@@ -11,10 +11,13 @@ SPDX-License-Identifier: MIT
 #ifndef __CM_FC_DEPGRAPH_H__
 #define __CM_FC_DEPGRAPH_H__
 
-#include <list>
-#include <map>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "PatchInfoRecord.h"
 
@@ -22,16 +25,28 @@ namespace cm {
 namespace patch {
 
 
+/// Nodes and edges are referred to by their index in Nodes and Edges.
 class DepGraph {
+  typedef std::tuple<Binary *, unsigned, bool> NodeKey;
+  struct NodeKeyHash {
+    std::size_t operator()(const NodeKey &K) const {
+      std::size_t H = std::hash<Binary *>()(std::get<0>(K));
+      H ^= (std::size_t(std::get<1>(K)) << 1 | std::get<2>(K)) +
+           0x9e3779b9 + (H << 6) + (H >> 2);
+      return H;
+    }
+  };
+
   Collection &C;
 
   unsigned Policy;
 
-  std::list<DepNode> Nodes;
-  std::list<DepEdge> Edges;
+  std::vector<DepNode> Nodes;
+  std::vector<DepEdge> Edges;
 
-  std::map<std::tuple<Binary *, unsigned, bool>, DepNode *> NodeMap;
-  std::map<std::pair<DepNode *, DepNode *>, DepEdge *> EdgeMap;
+  std::unordered_map<NodeKey, unsigned, NodeKeyHash> NodeMap;
+  // Keyed by (From << 32 | To).
+  std::unordered_map<uint64_t, unsigned> EdgeMap;
 
 public:
   enum {
@@ -39,13 +54,18 @@ public:
     SWSB_POLICY_1,
     SWSB_POLICY_2
   };
+  enum : unsigned { INVALID_ID = ~0U };
+
   DepGraph(Collection &_C, unsigned P) : C(_C), Policy(P) {};
   void build();
   void resolve();
 
+  DepNode &getNode(unsigned N) { return Nodes[N]; }
+  const DepNode &getNode(unsigned N) const { return Nodes[N]; }
+
 protected:
-  DepNode *getDepNode(Binary *B, unsigned R, bool Barrier);
-  DepEdge *getDepEdge(DepNode *From, DepNode *To, bool FromDef);
+  unsigned getDepNode(Binary *B, unsigned R, bool Barrier);
+  unsigned getDepEdge(unsigned From, unsigned To, bool FromDef);
 };
 
 
@@ -9,10 +9,16 @@ SPDX-License-Identifier: MIT
 // PatchInfo linker.
 //
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <map>
+#include <thread>
+#include <vector>
 
 #include "cm_fc_ld.h"
 
@@ -65,11 +71,13 @@ public:
   }
 
   bool link(cm::patch::Collection &C);
+  bool linkCollected(cm::patch::Collection &C);
 
 protected:
-  unsigned align(unsigned);
-  unsigned writeNOP(unsigned);
-  unsigned writeEOT();
+  // The write* functions emit code at Out and return its size in bytes. With
+  // a null Out they only return the size.
+  unsigned writeNOP(char *Out, unsigned N) const;
+  unsigned writeEOT(char *Out) const;
 
   void parseOptions() {
     std::string Opt;
@@ -117,9 +125,49 @@ protected:
     } while (pos < Opt.size());
   }
 
-  unsigned writeSync(unsigned RdMask, unsigned WrMask);
+  unsigned writeSync(char *Out, unsigned RdMask, unsigned WrMask) const;
+
+  // Copies Bin to its position in Linked, inserting its sync points, and
+  // patches its relocations.
+  void emitBinary(cm::patch::Binary &Bin, const cm::patch::DepGraph &DG,
+                  bool IsLastTop);
 };
 
+// Minimal number of binaries for a thread to emit. Smaller links are emitted
+// on the calling thread.
+const std::size_t MinBinariesPerThread = 64;
+
+// Calls F(i) for i in [0, N), spreading the calls over threads. F must be
+// safe to call concurrently for different i.
+template <typename Fn> void parallelFor(std::size_t N, Fn F) {
+  std::size_t NumThreads =
+      std::min<std::size_t>(std::thread::hardware_concurrency(),
+                            N / MinBinariesPerThread);
+  if (NumThreads <= 1) {
+    for (std::size_t i = 0; i != N; ++i)
+      F(i);
+    return;
+  }
+  std::atomic<std::size_t> Next(0);
+  auto Worker = [&]() {
+    for (std::size_t i = Next++; i < N; i = Next++)
+      F(i);
+  };
+  std::vector<std::thread> Threads;
+  for (std::size_t t = 1; t != NumThreads; ++t)
+    Threads.emplace_back(Worker);
+  Worker();
+  for (auto &T : Threads)
+    T.join();
+}
+
+// Writes QW at Out + B unless Out is null, and advances B past it.
+inline void writeQW(char *Out, unsigned &B, uint64_t QW) {
+  if (Out)
+    std::memcpy(Out + B, &QW, sizeof(QW));
+  B += sizeof(QW);
+}
+
 } // End anonymous namespace
 
 bool linkPatchInfo(cm::patch::Collection &C,
@@ -129,11 +177,21 @@ bool linkPatchInfo(cm::patch::Collection &C,
   return LD.link(C);
 }
 
+bool linkCollectedPatchInfo(cm::patch::Collection &C,
+                            std::size_t NumKernels, cm_fc_kernel_t *Kernels,
+                            const char *Options) {
+  PatchInfoLinker LD(NumKernels, Kernels, Options);
+  return LD.linkCollected(C);
+}
+
 bool PatchInfoLinker::link(cm::patch::Collection &C) {
   for (unsigned i = 0, e = unsigned(NumKernels); i != e; ++i)
     if (readPatchInfo(Kernels[i].patch_buf, Kernels[i].patch_size, C))
       return true;
+  return linkCollected(C);
+}
 
+bool PatchInfoLinker::linkCollected(cm::patch::Collection &C) {
   Platform = C.getPlatform();
 
   std::map<cm::patch::Binary *, cm::patch::Symbol *> BinMap;
@@ -188,65 +246,44 @@ bool PatchInfoLinker::link(cm::patch::Collection &C) {
   DG.build();
   DG.resolve();
 
-  // Link all kernels into 'linked' buffer.
-  Linked.clear();
+  // Lay out all kernels first so that they can be copied and patched
+  // independently.
+  auto getOffset = [&DG](unsigned N) { return DG.getNode(N).getOffset(); };
+  std::vector<std::pair<unsigned, unsigned>> Paddings; // offset and size
+  unsigned Size = 0;
   for (auto I = C.bin_begin(), E = C.bin_end(); I != E; ++I) {
     auto Bin = &*I;
-    align(4); // Align to 16B, i.e. 1 << 4.
+    // Align to 16B. Padding that can't be filled with 'nop's is skipped.
+    unsigned Padding = writeNOP(nullptr, ((Size + 15) / 16) * 16 - Size);
+    if (Padding)
+      Paddings.push_back(std::make_pair(Size, Padding));
+    Size += Padding;
     // Real binary starts from here.
-    Bin->setPos(unsigned(Linked.size()));
-    Bin->sortSyncPoints();
-    unsigned Start = 0;
-    unsigned Inserted = 0;
+    Bin->setPos(Size);
+    Bin->sortSyncPoints(getOffset);
+    Size += unsigned(Bin->getSize());
     for (auto SI = Bin->sp_begin(), SE = Bin->sp_end(); SI != SE; ++SI) {
-      auto Node = *SI;
-      unsigned Offset = Node->getOffset();
-      assert(Start <= Offset && "Invalid insert point!");
-      if (Start < Offset) {
-        Linked.append(Bin->getData() + Start, Offset - Start);
-        // Adjust relocation in this range.
-        for (auto RI = Bin->rel_begin(), RE = Bin->rel_end(); RI != RE; ++RI) {
-          unsigned RelOff = RI->getOffset();
-          if (Start <= RelOff && RelOff < Offset)
-            RI->setOffset(RelOff + Inserted);
-        }
-      }
-      Start = Offset;
-      Inserted += writeSync(Node->getRdTokenMask(), Node->getWrTokenMask());
-    }
-    Linked.append(Bin->getData() + Start, Bin->getSize() - Start);
-    for (auto RI = Bin->rel_begin(), RE = Bin->rel_end(); RI != RE; ++RI) {
-      unsigned RelOff = RI->getOffset();
-      if (Start <= RelOff && RelOff < Bin->getSize())
-        RI->setOffset(RelOff + Inserted);
+      const cm::patch::DepNode &Node = DG.getNode(*SI);
+      Size += writeSync(nullptr, Node.getRdTokenMask(), Node.getWrTokenMask());
     }
     if (Bin == LastTopBin)
-      writeEOT();
+      Size += writeEOT(nullptr);
   }
-  writeNOP(64);
 
-  // Fix relocations.
-  for (auto I = C.bin_begin(), E = C.bin_end(); I != E; ++I) {
-    auto Bin = &*I;
-    unsigned Offset = Bin->getPos();
-    // Bail out if this binary is not in the position map.
-    if (Offset == unsigned(-1))
-      return true;
-    for (auto RI = Bin->rel_begin(), RE = Bin->rel_end(); RI != RE; ++RI) {
-      auto S = RI->getSymbol();
-      auto Target = S->getBinary();
-      unsigned TargetOffset = Target->getPos();
-      // Bail out if this binary is not in the position map.
-      if (TargetOffset == unsigned(-1))
-        return true;
-      unsigned AbsIP = Offset + RI->getOffset();
-      unsigned AbsJIP = TargetOffset + S->getAddr();
-      int Imm = AbsJIP - AbsIP;
-      uint32_t *p = reinterpret_cast<uint32_t *>(&Linked[AbsIP]);
-      p[3] = Imm;
-      ++n;
-    }
-  }
+  unsigned Tail = writeNOP(nullptr, 64);
+  Paddings.push_back(std::make_pair(Size, Tail));
+
+  Linked.clear();
+  Linked.resize(Size + Tail);
+  for (auto &P : Paddings)
+    writeNOP(&Linked[P.first], P.second);
+
+  // Relocations are relative to the binaries' final positions, which are all
+  // known now.
+  parallelFor(C.bin_size(), [&](std::size_t i) {
+    cm::patch::Binary *Bin = C.getBinary(i);
+    emitBinary(*Bin, DG, Bin == LastTopBin);
+  });
 
   if (Policy == cm::patch::DepGraph::SWSB_POLICY_2) {
     std::string Out;
@@ -263,15 +300,54 @@ bool PatchInfoLinker::link(cm::patch::Collection &C) {
   return false;
 }
 
-unsigned PatchInfoLinker::align(unsigned Align) {
-  unsigned A = (1U << Align);
-  unsigned Origin = unsigned(Linked.size());
-  unsigned Padding = ((Origin + A - 1) / A) * A;
-  return writeNOP(Padding - Origin);
+void PatchInfoLinker::emitBinary(cm::patch::Binary &Bin,
+                                 const cm::patch::DepGraph &DG,
+                                 bool IsLastTop) {
+  char *Out = &Linked[Bin.getPos()];
+  unsigned Start = 0;
+  unsigned Inserted = 0;
+  for (auto SI = Bin.sp_begin(), SE = Bin.sp_end(); SI != SE; ++SI) {
+    const cm::patch::DepNode &Node = DG.getNode(*SI);
+    unsigned Offset = Node.getOffset();
+    assert(Start <= Offset && "Invalid insert point!");
+    if (Start < Offset) {
+      std::memcpy(Out + Start + Inserted, Bin.getData() + Start,
+                  Offset - Start);
+      // Adjust relocation in this range.
+      for (auto RI = Bin.rel_begin(), RE = Bin.rel_end(); RI != RE; ++RI) {
+        unsigned RelOff = RI->getOffset();
+        if (Start <= RelOff && RelOff < Offset)
+          RI->setOffset(RelOff + Inserted);
+      }
+    }
+    Start = Offset;
+    Inserted += writeSync(Out + Start + Inserted,
+                          Node.getRdTokenMask(), Node.getWrTokenMask());
+  }
+  std::memcpy(Out + Start + Inserted, Bin.getData() + Start,
+              Bin.getSize() - Start);
+  for (auto RI = Bin.rel_begin(), RE = Bin.rel_end(); RI != RE; ++RI) {
+    unsigned RelOff = RI->getOffset();
+    if (Start <= RelOff && RelOff < Bin.getSize())
+      RI->setOffset(RelOff + Inserted);
+  }
+  if (IsLastTop)
+    writeEOT(Out + Bin.getSize() + Inserted);
+
+  // Fix relocations.
+  for (auto RI = Bin.rel_begin(), RE = Bin.rel_end(); RI != RE; ++RI) {
+    auto S = RI->getSymbol();
+    auto Target = S->getBinary();
+    unsigned AbsIP = Bin.getPos() + RI->getOffset();
+    unsigned AbsJIP = Target->getPos() + S->getAddr();
+    int Imm = AbsJIP - AbsIP;
+    uint32_t *p = reinterpret_cast<uint32_t *>(&Linked[AbsIP]);
+    p[3] = Imm;
+  }
 }
 
-/// Append Linked with 'nop' taking up to N bytes.
-unsigned PatchInfoLinker::writeNOP(unsigned N) {
+/// Write 'nop's taking up to N bytes.
+unsigned PatchInfoLinker::writeNOP(char *Out, unsigned N) const {
   // Bail out if N is not aligned with 8B, i.e. 64 bits. That's the minimal
   // size of 'nop' instruction.
   if (N % 8 != 0)
@@ -291,20 +367,18 @@ unsigned PatchInfoLinker::writeNOP(unsigned N) {
   }
   unsigned B = 0;
   while (N > 8) {
-    Linked.append(reinterpret_cast<char *>(&regular_nop), sizeof(regular_nop));
-    Linked.append(sizeof(uint64_t), 0);
+    writeQW(Out, B, regular_nop);
+    writeQW(Out, B, 0);
     N -= 16;
-    B += 16;
   }
   while (N > 0) {
-    Linked.append(reinterpret_cast<char *>(&compact_nop), sizeof(compact_nop));
+    writeQW(Out, B, compact_nop);
     N -= 8;
-    B += 8;
   }
   return B;
 }
 
-unsigned PatchInfoLinker::writeEOT() {
+unsigned PatchInfoLinker::writeEOT(char *Out) const {
   uint64_t mov0 = 0;
   uint64_t mov1 = 0;
   uint64_t snd0 = 0;
@@ -338,25 +412,20 @@ unsigned PatchInfoLinker::writeEOT() {
   unsigned B = 0;
   if (hasR127Token)
   {
-      Linked.append(reinterpret_cast<char *>(&r127_sync0), sizeof(r127_sync0));
-      B += sizeof(r127_sync0);
-      Linked.append(reinterpret_cast<char *>(&r127_sync1), sizeof(r127_sync1));
-      B += sizeof(r127_sync1);
+      writeQW(Out, B, r127_sync0);
+      writeQW(Out, B, r127_sync1);
   }
-  Linked.append(reinterpret_cast<char *>(&mov0), sizeof(mov0));
-  B += sizeof(mov0);
-  Linked.append(reinterpret_cast<char *>(&mov1), sizeof(mov1));
-  B += sizeof(mov1);
-  Linked.append(reinterpret_cast<char *>(&snd0), sizeof(snd0));
-  B += sizeof(snd0);
-  Linked.append(reinterpret_cast<char *>(&snd1), sizeof(snd1));
-  B += sizeof(snd1);
+  writeQW(Out, B, mov0);
+  writeQW(Out, B, mov1);
+  writeQW(Out, B, snd0);
+  writeQW(Out, B, snd1);
 
   return B;
 }
 
 
-unsigned PatchInfoLinker::writeSync(unsigned RdMask, unsigned WrMask) {
+unsigned PatchInfoLinker::writeSync(char *Out, unsigned RdMask,
+                                    unsigned WrMask) const {
   uint64_t sysrd0 = 0x0001000000000101;
   uint64_t sysrd1 = 0x0000000020000000;
 
@@ -375,10 +444,8 @@ unsigned PatchInfoLinker::writeSync(unsigned RdMask, unsigned WrMask) {
   if (RdMask == unsigned(-1)) {
     uint64_t qw0 = (sysrd0 & ~swsb_mask) | (dist << 8);
     uint64_t qw1 = (sysrd1 & ~fc_mask) | allrd;
-    Linked.append(reinterpret_cast<char *>(&qw0), sizeof(qw0));
-    B += sizeof(qw0);
-    Linked.append(reinterpret_cast<char *>(&qw1), sizeof(qw1));
-    B += sizeof(qw1);
+    writeQW(Out, B, qw0);
+    writeQW(Out, B, qw1);
     // Clear distance.
     dist = 0;
   } else {
@@ -387,20 +454,16 @@ unsigned PatchInfoLinker::writeSync(unsigned RdMask, unsigned WrMask) {
         uint64_t swsb = 0x30 | Tok;
         uint64_t qw0 = (sysrd0 & ~swsb_mask) | (swsb << 8);
         uint64_t qw1 = (sysrd1 & ~fc_mask) | nop;
-        Linked.append(reinterpret_cast<char *>(&qw0), sizeof(qw0));
-        B += sizeof(qw0);
-        Linked.append(reinterpret_cast<char *>(&qw1), sizeof(qw1));
-        B += sizeof(qw1);
+        writeQW(Out, B, qw0);
+        writeQW(Out, B, qw1);
       }
     }
   }
   if (WrMask == unsigned(-1)) {
     uint64_t qw0 = (sysrd0 & ~swsb_mask) | (dist << 8);
     uint64_t qw1 = (sysrd1 & ~fc_mask) | allwr;
-    Linked.append(reinterpret_cast<char *>(&qw0), sizeof(qw0));
-    B += sizeof(qw0);
-    Linked.append(reinterpret_cast<char *>(&qw1), sizeof(qw1));
-    B += sizeof(qw1);
+    writeQW(Out, B, qw0);
+    writeQW(Out, B, qw1);
     // Clear distance.
     dist = 0;
   } else {
@@ -409,10 +472,8 @@ unsigned PatchInfoLinker::writeSync(unsigned RdMask, unsigned WrMask) {
         uint64_t swsb = 0x80 | Tok | (dist << 4);
         uint64_t qw0 = (sysrd0 & ~swsb_mask) | (swsb << 8);
         uint64_t qw1 = (sysrd1 & ~fc_mask) | nop;
-        Linked.append(reinterpret_cast<char *>(&qw0), sizeof(qw0));
-        B += sizeof(qw0);
-        Linked.append(reinterpret_cast<char *>(&qw1), sizeof(qw1));
-        B += sizeof(qw1);
+        writeQW(Out, B, qw0);
+        writeQW(Out, B, qw1);
         // Clear distance.
         dist = 0;
       }
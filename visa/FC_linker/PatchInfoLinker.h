@@ -22,4 +22,10 @@ bool linkPatchInfo(cm::patch::Collection &C,
                    std::size_t NumKernels, cm_fc_kernel_t *Kernels,
                    const char *Options);
 
+// Same as linkPatchInfo but for patch info already read into C, e.g. by
+// readPatchInfo. Only the binaries of Kernels are used.
+bool linkCollectedPatchInfo(cm::patch::Collection &C,
+                            std::size_t NumKernels, cm_fc_kernel_t *Kernels,
+                            const char *Options);
+
 #endif // __CM_FC_PATCHINFO_LINKER_H__
@@ -18,11 +18,11 @@ SPDX-License-Identifier: MIT
 #include <cstring>
 
 #include <algorithm>
-#include <list>
-#include <map>
-#include <queue>
+#include <deque>
 #include <string>
 #include <tuple>
+#include <unordered_map>
+#include <vector>
 
 #include "../PatchInfo.h"
 
@@ -148,9 +148,12 @@ public:
   unsigned getTokenNo() const { return TokenNo; }
 };
 
+/// DepNode is owned by DepGraph and referenced by its index there, so nodes
+/// can be stored contiguously and added without invalidating references.
+///
 class DepNode {
-  typedef std::list<RegAccess *> RegAccRefList;
-  typedef std::list<DepNode *> NodeRefList;
+  typedef std::vector<RegAccess *> RegAccRefList;
+  typedef std::vector<unsigned> NodeRefList;
 
   Binary *Bin;
   unsigned Offset;
@@ -189,8 +192,8 @@ public:
     AccList.push_back(Acc);
   }
 
-  void addFromNode(DepNode *N) { FromList.push_back(N); }
-  void addToNode(DepNode *N, bool FromDef) { ToList[FromDef].push_back(N); }
+  void addFromNode(unsigned N) { FromList.push_back(N); }
+  void addToNode(unsigned N, bool FromDef) { ToList[FromDef].push_back(N); }
 
   void clearFromNodes() { FromList.clear(); }
   void clearToNodes(bool FromDef) { ToList[FromDef].clear(); }
@@ -301,16 +304,16 @@ public:
 };
 
 class DepEdge {
-  DepNode *Head;
-  DepNode *Tail;
+  unsigned Head; ///< Index of the head node in its DepGraph.
+  unsigned Tail; ///< Index of the tail node in its DepGraph.
   bool HeadDef;
 
 public:
-  DepEdge(DepNode *H, DepNode *T, bool FromDef)
+  DepEdge(unsigned H, unsigned T, bool FromDef)
       : Head(H), Tail(T), HeadDef(FromDef) {}
 
-  DepNode *getHead() const { return Head; }
-  DepNode *getTail() const { return Tail; }
+  unsigned getHead() const { return Head; }
+  unsigned getTail() const { return Tail; }
 
   bool isHeadDef() const { return HeadDef; }
 };
@@ -320,18 +323,16 @@ public:
 /// Data and @p Size. It has 0 or more reference to symbol and 0 or more
 /// relocations.
 ///
+/// Relocations, register accesses and tokens are only added while the patch
+/// info is read; pointers to them stay valid once reading is done.
+///
 class Binary {
 public:
-  typedef std::list<Relocation> RelList;
-  typedef std::list<RegAccess>  RegAccList;
-  typedef std::list<Token>      TokList;
-
-  struct DepNodeCompare {
-    bool operator()(DepNode *A, DepNode *B) {
-      return A->getOffset() < B->getOffset();
-    }
-  };
-  typedef std::list<DepNode *> SyncPointList;
+  typedef std::vector<Relocation> RelList;
+  typedef std::vector<RegAccess>  RegAccList;
+  typedef std::vector<Token>      TokList;
+  /// Indices of DepGraph nodes.
+  typedef std::vector<unsigned>   SyncPointList;
 
 private:
   const char *Data;     ///< The buffer containing the binary.
@@ -407,8 +408,17 @@ public:
   }
 
   void clearSyncPoints() { SyncPoints.clear(); }
-  void insertSyncPoint(DepNode *N) { SyncPoints.push_back(N); }
-  void sortSyncPoints() { SyncPoints.sort(DepNodeCompare()); }
+  void insertSyncPoint(unsigned N) { SyncPoints.push_back(N); }
+  /// Sorts sync points by their offset, keeping the insertion order of sync
+  /// points at the same offset.
+  template <typename GetOffsetFn>
+  void sortSyncPoints(GetOffsetFn GetOffset) {
+    std::stable_sort(SyncPoints.begin(), SyncPoints.end(),
+                     [&](unsigned A, unsigned B) {
+                       return GetOffset(A) < GetOffset(B);
+                     });
+  }
+  bool sp_empty() const { return SyncPoints.empty(); }
 
   SyncPointList::const_iterator sp_begin() const { return SyncPoints.begin(); }
   SyncPointList::const_iterator sp_end()   const { return SyncPoints.end(); }
@@ -428,22 +438,35 @@ public:
   const unsigned getOrder() const { return Order; }
   void setOrder(unsigned O) { Order = O; }
 
-  const unsigned getPos() const { return Order; }
-  void setPos(unsigned O) { Order = O; }
+  const unsigned getPos() const { return Position; }
+  void setPos(unsigned P) { Position = P; }
 
   const Symbol *getName() const { return Name; }
   void setName(const Symbol *S) { Name = S; }
 };
 
 /// Collection
+///
+/// Binaries and symbols reference each other by pointer, so they are kept in
+/// deques which don't move elements on insertion.
+///
 class Collection {
 public:
-  typedef std::list<Binary> BinaryList;
-  typedef std::list<Symbol> SymbolList;
-
-  struct cstring_less {
+  typedef std::deque<Binary> BinaryList;
+  typedef std::deque<Symbol> SymbolList;
+
+  struct cstring_hash {
+    std::size_t operator()(const char *s) const {
+      // FNV-1a
+      std::size_t h = 2166136261U;
+      for (; *s; ++s)
+        h = (h ^ static_cast<unsigned char>(*s)) * 16777619U;
+      return h;
+    }
+  };
+  struct cstring_equal {
     bool operator()(const char *s0, const char *s1) const {
-      return std::strcmp(s0, s1) < 0;
+      return std::strcmp(s0, s1) == 0;
     }
   };
 
@@ -454,9 +477,10 @@ private:
   unsigned Platform;
   unsigned UniqueID;
 
-  std::list<std::string> NewNames;
+  std::deque<std::string> NewNames;
 
-  std::map<const char *, Symbol *, cstring_less> SymbolMap;
+  std::unordered_map<const char *, Symbol *, cstring_hash, cstring_equal>
+      SymbolMap;
 
   std::string Linked;
 
@@ -478,6 +502,10 @@ public:
   SymbolList::iterator sym_begin() { return Symbols.begin(); }
   SymbolList::iterator sym_end()   { return Symbols.end(); }
 
+  std::size_t bin_size() const { return Binaries.size(); }
+
+  Binary *getBinary(std::size_t i) { return &Binaries[i]; }
+
   Binary *addBinary(const char *B, std::size_t S) {
     Binaries.push_back(Binary(B, S));
     return &Binaries.back();
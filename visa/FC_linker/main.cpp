@@ -13,6 +13,9 @@ SPDX-License-Identifier: MIT
 #include <cstdio>
 #include <cstring>
 
+#include <algorithm>
+#include <chrono>
+#include <deque>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -94,9 +97,13 @@ int getopt(int nargc, char *const nargv[], const char *ostr) {
 static bool Brief = false;
 
 static void usage(FILE *fp, int argc, char *argv[]) {
-  std::fprintf(fp, "usage: %s [-c|-d|-q] [-e <string>] [-o <file>] file...\n\n",
+  std::fprintf(fp, "usage: %s [-c|-d|-q] [-e <string>] [-o <file>] file...\n",
+               argv[0]);
+  std::fprintf(fp, "       %s -b [-e <string>] [-o <file>] <num-callees>\n\n",
                argv[0]);
   std::fprintf(fp, "CM fast composite offline linker.\n\n");
+  std::fprintf(fp, "%-28s%s\n", "  -b", "Benchmark linking a synthetic "
+                                      "caller with <num-callees> callees.");
   std::fprintf(fp, "%-28s%s\n", "  -c", "Combine kernels specified.");
   std::fprintf(fp, "%-28s%s\n", "  -d", "Dump the patch info.");
   std::fprintf(fp, "%-28s%s\n", "  -q", "Query the callee info.");
@@ -315,14 +322,99 @@ static void read_args(int argc, char *argv[], const char *Out) {
     fclose(fp);
 }
 
+// Links a caller calling NumCallees callees. The kernels are built directly
+// in a collection so that only the linker itself is measured.
+static void bench(unsigned NumCallees, FILE *fp, const char *ExtraOpts) {
+  const unsigned NumRuns = 10;
+  const unsigned CalleeSize = 16 * 16;
+  const unsigned CallerSize = 16 * (NumCallees + 1);
+
+  // Zeros are fine; only the SWSB of instructions with dependencies is read.
+  std::vector<char> CallerBin(CallerSize), CalleeBin(CalleeSize);
+  std::vector<cm_fc_kernel_t> Kernels(NumCallees + 1);
+  Kernels[0] = {nullptr, 0, CallerBin.data(), CallerBin.size()};
+  for (unsigned i = 1; i <= NumCallees; ++i)
+    Kernels[i] = {nullptr, 0, CalleeBin.data(), CalleeBin.size()};
+
+  std::deque<std::string> Names;
+  Names.push_back("caller");
+  for (unsigned i = 0; i != NumCallees; ++i)
+    Names.push_back("callee" + std::to_string(i));
+
+  double Best = 0.0;
+  std::size_t LinkedSize = 0;
+  for (unsigned Run = 0; Run != NumRuns; ++Run) {
+    cm::patch::Collection C;
+    C.setPlatform(cm::patch::PP_TGL);
+    for (unsigned i = 0; i <= NumCallees; ++i) {
+      cm::patch::Binary *Bin = C.addBinary(nullptr, 0);
+      cm::patch::Symbol *S = C.addSymbol(Names[i].c_str());
+      S->setBinary(Bin);
+      S->setExtra(i ? CM_FC_LINK_TYPE_CALLEE : CM_FC_LINK_TYPE_CALLER);
+      if (!i)
+        continue;
+      // Each callee reads one register and writes another through a token.
+      unsigned Tok = i % 16;
+      Bin->addInitRegAccess(0, i % 128, cm::patch::RDUT_FULLUSE | Tok);
+      Bin->addFiniRegAccess(CalleeSize - 16, (i + 1) % 128,
+                            cm::patch::RDUT_FULLDEF | Tok);
+    }
+    cm::patch::Binary *Caller = C.getBinary(0);
+    for (unsigned i = 1; i <= NumCallees; ++i)
+      Caller->addReloc(16 * (i - 1), C.getSymbol(Names[i].c_str()));
+
+    auto Start = std::chrono::steady_clock::now();
+    if (linkCollectedPatchInfo(C, Kernels.size(), Kernels.data(), ExtraOpts)) {
+      std::cerr << "Failed to combine kernels.\n";
+      return;
+    }
+    std::chrono::duration<double, std::milli> Elapsed =
+        std::chrono::steady_clock::now() - Start;
+    Best = Run ? std::min(Best, Elapsed.count()) : Elapsed.count();
+    LinkedSize = C.getLinkedBinary().size();
+  }
+
+  std::fprintf(fp, "Linked %u callees into %zu bytes: %.3f ms (best of %u)\n",
+               NumCallees, LinkedSize, Best, NumRuns);
+}
+
+static void bench_args(int argc, char *argv[], const char *Out,
+                       const char *ExtraOpts) {
+  unsigned NumCallees = 0;
+  if (argc == 1)
+    NumCallees = unsigned(std::strtoul(argv[0], nullptr, 10));
+  if (NumCallees == 0) {
+    std::cerr << "Benchmarking needs the number of callees.\n";
+    std::exit(EXIT_FAILURE);
+  }
+
+  FILE *fp = stdout;
+  if (Out) {
+#if defined(_MSC_VER)
+    fp = nullptr;
+    fopen_s(&fp, Out, "w");
+#else
+    fp = std::fopen(Out, "w");
+#endif
+    if (!fp) {
+      std::cerr << "Cannot open '" << Out << "' for write!\n";
+      std::exit(EXIT_FAILURE);
+    }
+  }
+  bench(NumCallees, fp, ExtraOpts);
+  if (Out)
+    fclose(fp);
+}
+
 int main(int argc, char *argv[]) {
   char *ExtraOptions = nullptr;
   char *Out = nullptr;
   char Action = '\0';
 
   int Opt;
-  while ((Opt = getopt(argc, argv, "cdqrBDe:o:")) != -1) {
+  while ((Opt = getopt(argc, argv, "bcdqrBDe:o:")) != -1) {
     switch (Opt) {
+    case 'b':
     case 'c':
     case 'd':
     case 'q':
@@ -354,6 +446,9 @@ int main(int argc, char *argv[]) {
   }
 
   switch (Action) {
+  case 'b':
+    bench_args(argc - optind, &argv[optind], Out, ExtraOptions);
+    break;
   case 'c':
     combine_args(argc - optind, &argv[optind], Out, ExtraOptions);
     break;
@@ -15,6 +15,8 @@ SPDX-License-Identifier: MIT
 #include "iga/IGALibrary/api/kv.hpp"
 #include "BinaryEncodingIGA.h"
 
+#include <algorithm>
+#include <iterator>
 #include <list>
 #include <fstream>
 #include <functional>
@@ -970,6 +972,135 @@ void G4_Kernel::dumpToFile(const std::string &suffixIn)
         dumpG4Internal(baseName);
 }
 
+static VISA_INST_KIND getInstKind(G4_opcode op)
+{
+    switch (op)
+    {
+    case G4_mov: case G4_movi: case G4_smov:
+        return VISA_INST_KIND_MOV;
+    case G4_sel: case G4_csel: case G4_cmp: case G4_cmpn:
+        return VISA_INST_KIND_SEL_CMP;
+    case G4_not: case G4_and: case G4_or: case G4_xor:
+    case G4_bfrev: case G4_bfe: case G4_bfi1: case G4_bfi2:
+    case G4_fbh: case G4_fbl: case G4_cbit: case G4_bfn:
+    case G4_shr: case G4_shl: case G4_asr: case G4_ror: case G4_rol:
+    case G4_lzd:
+        return VISA_INST_KIND_LOGIC;
+    case G4_send: case G4_sendc: case G4_sends: case G4_sendsc:
+        return VISA_INST_KIND_SEND;
+    case G4_if: case G4_else: case G4_endif: case G4_while:
+    case G4_break: case G4_cont:
+        return VISA_INST_KIND_STRUCTCF;
+    case G4_goto: case G4_join:
+        return VISA_INST_KIND_GOTOJOIN;
+    case G4_jmpi: case G4_brd: case G4_brc:
+        return VISA_INST_KIND_THREADCF;
+    case G4_call: case G4_pseudo_fcall: case G4_pseudo_fc_call:
+        return VISA_INST_KIND_CALL;
+    case G4_illegal: case G4_halt: case G4_return: case G4_pseudo_fret:
+    case G4_pseudo_fc_ret: case G4_pseudo_exit: case G4_wait: case G4_nop:
+    case G4_sync_nop: case G4_sync_allrd: case G4_sync_allwr:
+        return VISA_INST_KIND_OTHERS;
+    default:
+        return VISA_INST_KIND_ALU;
+    }
+}
+
+static VISA_PIPE getInstPipe(const G4_INST* inst, bool hasSWSB)
+{
+    if (inst->isSend())
+    {
+        return VISA_PIPE_SEND;
+    }
+    if (inst->isDpas())
+    {
+        return VISA_PIPE_DPAS;
+    }
+    if (inst->isMathPipeInst())
+    {
+        return VISA_PIPE_MATH;
+    }
+    if (inst->isJEUPipeInstructionXe())
+    {
+        return VISA_PIPE_JEU;
+    }
+    if (!hasSWSB || !inst->distanceHonourInstruction())
+    {
+        return VISA_PIPE_OTHER;
+    }
+    if (inst->isLongPipeInstructionXe())
+    {
+        return VISA_PIPE_LONG;
+    }
+    if (inst->isIntegerPipeInstructionXe())
+    {
+        return VISA_PIPE_INT;
+    }
+    if (inst->isFloatPipeInstructionXe())
+    {
+        return VISA_PIPE_FLOAT;
+    }
+    return VISA_PIPE_OTHER;
+}
+
+void G4_Kernel::collectStats(VISA_KERNEL_STATS& stats)
+{
+    bool hasSWSB = fg.builder->hasSWSB();
+
+    stats.numInsts = 0;
+    stats.numBBs = 0;
+    std::fill(std::begin(stats.numInstsByKind), std::end(stats.numInstsByKind), 0);
+    std::fill(std::begin(stats.numInstsByPipe), std::end(stats.numInstsByPipe), 0);
+    std::fill(std::begin(stats.numSendsBySFID), std::end(stats.numSendsBySFID), 0);
+    stats.numSyncInsts = 0;
+    stats.numSWSBTokenDeps = 0;
+    stats.numSWSBDistDeps = 0;
+
+    for (G4_BB* bb : fg)
+    {
+        stats.numBBs++;
+        for (G4_INST* inst : *bb)
+        {
+            if (inst->isLabel() || inst->isIntrinsic())
+            {
+                continue;
+            }
+
+            stats.numInsts++;
+            stats.numInstsByKind[getInstKind(inst->opcode())]++;
+            stats.numInstsByPipe[getInstPipe(inst, hasSWSB)]++;
+
+            if (inst->isSend())
+            {
+                unsigned sfid = SFIDtoInt(inst->getMsgDesc()->getSFID());
+                if (sfid < VISA_NUM_SFIDS)
+                {
+                    stats.numSendsBySFID[sfid]++;
+                }
+            }
+
+            switch (inst->opcode())
+            {
+            case G4_sync_nop: case G4_sync_allrd: case G4_sync_allwr:
+                stats.numSyncInsts++;
+                break;
+            default:
+                break;
+            }
+
+            if (inst->getDistance() != 0)
+            {
+                stats.numSWSBDistDeps++;
+            }
+            if (inst->getTokenType() != G4_INST::TOKEN_NONE &&
+                inst->getTokenType() != G4_INST::SB_SET)
+            {
+                stats.numSWSBTokenDeps++;
+            }
+        }
+    }
+}
+
 void G4_Kernel::emitDeviceAsm(
     std::ostream& os, const void * binary, uint32_t binarySize)
 {
@@ -1306,6 +1437,16 @@ void G4_Kernel::emitDeviceAsmHeaderComment(std::ostream& os)
             os << "\n//.spill flag store " << jitInfo->numFlagSpillStore;
             os << "\n//.spill flag load " << jitInfo->numFlagSpillLoad;
         }
+        if (jitInfo->compileTimeFallbacks != 0)
+        {
+            os << "\n//.compile time fallbacks";
+            for (uint32_t i = 0; i < (uint32_t)CompileTimeBudget::Phase::NUM_PHASES; i++)
+            {
+                auto phase = (CompileTimeBudget::Phase)i;
+                if (timeBudget.hasFallback(phase))
+                    os << " " << CompileTimeBudget::getPhaseName(phase);
+            }
+        }
     }
 
     auto privateMemSize = getInt32KernelAttr(Attributes::ATTR_SpillMemOffset);
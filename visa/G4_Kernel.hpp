@@ -12,6 +12,8 @@ SPDX-License-Identifier: MIT
 #include "G4_IR.hpp"
 #include "FlowGraph.h"
 #include "RelocationEntry.hpp"
+#include "include/CompileTimeBudget.h"
+#include "include/JitterDataStruct.h"
 #include "include/gtpin_IGC_interface.h"
 
 #include <cstdint>
@@ -181,6 +183,8 @@ private:
     // There's two entires prolog for setting FFID for compute shaders.
     G4_BB* computeFFIDGP = nullptr;
     G4_BB* computeFFIDGP1 = nullptr;
+
+    CompileTimeBudget timeBudget;
 public:
     FlowGraph              fg;
     DECLARE_LIST           Declares;
@@ -214,6 +218,11 @@ public:
     void     setAsmCount(int count) { asmInstCount = count; }
     uint32_t getAsmCount() const { return asmInstCount; }
 
+    // Fills the fields of stats that are derived from the final instruction
+    // stream. The spill, compaction and cycle fields are recorded by RA, the
+    // encoder and the local scheduler.
+    void collectStats(VISA_KERNEL_STATS& stats);
+
     void     setKernelID(uint64_t ID) { kernelID = ID; }
     uint64_t getKernelID() const { return kernelID; }
 
@@ -317,6 +326,8 @@ public:
     VISATarget getKernelType() const { return kernelType; }
     void setKernelType(VISATarget t) { kernelType = t; }
 
+    CompileTimeBudget& getTimeBudget() { return timeBudget; }
+
 
     /// dump this kernel to the standard error
     void dump(std::ostream &os = std::cerr) const;  // used in debugger
@@ -5807,6 +5807,15 @@ void GraphColor::computeSpillCosts(bool useSplitLLRHeuristic)
     std::vector<LiveRange*> unalignedScalars;
     float maxNormalCost = 0.0f;
 
+    // Ranges that are cheaper to recompute than to fill get a lower spill
+    // cost, so remat is considered as an alternative to spilling them.
+    std::unordered_map<const G4_Declare*, float> rematSpillCostScales;
+    if (gra.isRematCostModelActive() && liveAnalysis.livenessClass(G4_GRF))
+    {
+        RematCostModel costModel(builder.kernel);
+        costModel.computeSpillCostScales(rematSpillCostScales);
+    }
+
     for (unsigned i = 0; i < numVar; i++)
     {
         G4_Declare* dcl = lrs[i]->getDcl();
@@ -5899,6 +5908,12 @@ void GraphColor::computeSpillCosts(bool useSplitLLRHeuristic)
                 unalignedScalars.push_back(lrs[i]);
             }
 
+            auto scaleIt = rematSpillCostScales.find(dcl);
+            if (scaleIt != rematSpillCostScales.end())
+            {
+                spillCost *= scaleIt->second;
+            }
+
             lrs[i]->setSpillCost(spillCost);
 
             // Track address sensitive live range.
@@ -9968,6 +9983,15 @@ int GlobalRA::coloringRegAlloc()
 
     unsigned failSafeRAIteration = (builder.getOption(vISA_FastSpill) || fastCompile) ? fastCompileIter : FAIL_SAFE_RA_LIMIT;
     bool rematDone = false, alignedScalarSplitDone = false;
+    bool runRemat = kernel.getInt32KernelAttr(Attributes::ATTR_Target) == VISA_CM
+        ? true :  kernel.getSimdSize() < numEltPerGRF<Type_UB>();
+    // -noremat takes precedence over -forceremat
+    bool rematOn = !kernel.getOption(vISA_Debug) &&
+        !kernel.getOption(vISA_NoRemat) &&
+        !kernel.getOption(vISA_FastSpill) &&
+        !fastCompile &&
+        (kernel.getOption(vISA_ForceRemat) || runRemat);
+    bool budgetExpired = false;
     VarSplit splitPass(*this);
     while (iterationNo < maxRAIterations)
     {
@@ -9977,6 +10001,24 @@ int GlobalRA::coloringRegAlloc()
         }
         setIterNo(iterationNo);
 
+        // Out of compile-time budget: skip remat and scalar splitting, which
+        // cause extra iterations, and make this the fail-safe RA iteration.
+        // The latter only takes effect where fail-safe RA is used at all,
+        // i.e. with vISA_FailSafeRA on a 3D target without stack calls.
+        if (!budgetExpired &&
+            kernel.getTimeBudget().isExpired(CompileTimeBudget::Phase::GlobalRA))
+        {
+            if (builder.getOption(vISA_RATrace))
+            {
+                std::cout << "\t--compile time budget exceeded, skip remat and scalar splitting\n";
+            }
+            budgetExpired = true;
+            kernel.getTimeBudget().recordFallback(CompileTimeBudget::Phase::GlobalRA);
+            rematOn = false;
+            alignedScalarSplitDone = true;
+            failSafeRAIteration = iterationNo;
+        }
+
         if (!builder.getOption(vISA_HybridRAWithSpill))
         {
             resetGlobalRAStates();
@@ -10063,6 +10105,10 @@ int GlobalRA::coloringRegAlloc()
             {
                 rpe.run();
             }
+            // Spill costs account for remat only while remat can still run
+            // to replace fills of the chosen ranges.
+            setRematCostModelActive(rematOn && !rematDone &&
+                builder.getOption(vISA_RematCostModel));
             GraphColor coloring(liveAnalysis, kernel.getNumRegTotal(), false, forceSpill);
 
             if (builder.getOption(vISA_dumpRPE) && iterationNo == 0 && !rematDone)
@@ -10083,14 +10129,6 @@ int GlobalRA::coloringRegAlloc()
                     return VISA_SPILL;
                 }
 
-                bool runRemat = kernel.getInt32KernelAttr(Attributes::ATTR_Target) == VISA_CM
-                    ? true :  kernel.getSimdSize() < numEltPerGRF<Type_UB>();
-                // -noremat takes precedence over -forceremat
-                bool rematOn = !kernel.getOption(vISA_Debug) &&
-                    !kernel.getOption(vISA_NoRemat) &&
-                    !kernel.getOption(vISA_FastSpill) &&
-                    !fastCompile &&
-                    (kernel.getOption(vISA_ForceRemat) || runRemat);
                 bool rerunGRA = false;
                 bool globalSplitChange = false;
 
@@ -10287,6 +10325,7 @@ int GlobalRA::coloringRegAlloc()
 
                 bool disableSpillCoalecse = builder.getOption(vISA_DisableSpillCoalescing) ||
                     builder.getOption(vISA_FastSpill) || fastCompile || builder.getOption(vISA_Debug) ||
+                    budgetExpired ||
                     // spill cleanup is not support when we use oword msg for spill/fill for non-stack calls.
                     (!useScratchMsgForSpill && !hasStackCall);
 
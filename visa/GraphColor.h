@@ -741,6 +741,9 @@ namespace vISA
         // store instructions that shouldnt be rematerialized.
         std::unordered_set<G4_INST*> dontRemat;
 
+        // true when spill costs should account for remat as a spill alternative
+        bool rematCostModelActive = false;
+
         RAVarInfo &allocVar(const G4_Declare* dcl)
         {
             auto dclid = dcl->getDeclId();
@@ -774,6 +777,8 @@ namespace vISA
 
         uint32_t numGRFSpill = 0;
         uint32_t numGRFFill = 0;
+        uint32_t spillBytes = 0;
+        uint32_t fillBytes = 0;
 
         void expandFillNonStackcall(uint32_t numRows, uint32_t offset, short rowOffset, G4_SrcRegRegion* header, G4_DstRegRegion* resultRgn, G4_BB* bb, INST_LIST_ITER& instIt);
         void expandSpillNonStackcall(uint32_t numRows, uint32_t offset, short rowOffset, G4_SrcRegRegion* header, G4_SrcRegRegion* payload, G4_BB* bb, INST_LIST_ITER& instIt);
@@ -1257,6 +1262,9 @@ namespace vISA
             return dontRemat.find(inst) != dontRemat.end();
         }
 
+        void setRematCostModelActive(bool active) { rematCostModelActive = active; }
+        bool isRematCostModelActive() const { return rematCostModelActive; }
+
         void addNoRemat(G4_INST* inst)
         {
             dontRemat.insert(inst);
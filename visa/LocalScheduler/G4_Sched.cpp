@@ -423,17 +423,20 @@ struct SchedConfig
         MASK_LATENCY      = 1U << 1,
         MASK_SETHI_ULLMAN = 1U << 2,
         MASK_CLUSTTERING  = 1U << 3,
+        MASK_LOOP_LATENCY = 1U << 4,
     };
     unsigned Dump : 1;
     unsigned UseLatency : 1;
     unsigned UseSethiUllman : 1;
     unsigned DoClustering : 1;
+    unsigned LoopLatency : 1;
 
     explicit SchedConfig(unsigned Config)
         : Dump((Config & MASK_DUMP) != 0)
         , UseLatency((Config & MASK_LATENCY) != 0)
         , UseSethiUllman((Config & MASK_SETHI_ULLMAN) != 0)
         , DoClustering((Config & MASK_CLUSTTERING) != 0)
+        , LoopLatency((Config & MASK_LOOP_LATENCY) != 0)
     {
     }
 };
@@ -542,6 +545,39 @@ static unsigned getLatencyHidingThreshold(G4_Kernel &kernel)
     return unsigned(LATENCY_PRESSURE_THRESHOLD * Ratio);
 }
 
+// Estimate the cycles to issue a block in its current order with an in-order
+// issue model: an instruction waits for the latency of its RAW predecessors,
+// otherwise it issues after the occupancy of the previous instruction.
+static unsigned estimateCycles(preDDD& ddd, const LatencyTable& LT)
+{
+    std::unordered_map<G4_INST*, preNode*> NodeMap;
+    for (auto N : ddd.getNodes())
+        NodeMap[N->getInst()] = N;
+
+    std::unordered_map<G4_INST*, unsigned> IssueCycle;
+    unsigned CurCycle = 0;
+    for (auto Inst : *ddd.getBB()) {
+        if (Inst->isPseudoKill() || Inst->isLabel())
+            continue;
+
+        unsigned Ready = CurCycle;
+        auto NI = NodeMap.find(Inst);
+        if (NI != NodeMap.end()) {
+            for (auto& E : NI->second->preds()) {
+                G4_INST* PredInst = E.getNode()->getInst();
+                if (!PredInst || (E.getType() != RAW && E.getType() != RAW_MEMORY))
+                    continue;
+                auto PI = IssueCycle.find(PredInst);
+                if (PI != IssueCycle.end())
+                    Ready = std::max(Ready, PI->second + LT.getLatency(PredInst));
+            }
+        }
+        IssueCycle[Inst] = Ready;
+        CurCycle = Ready + LT.getOccupancy(Inst);
+    }
+    return CurCycle;
+}
+
 preRA_Scheduler::preRA_Scheduler(G4_Kernel& k, Mem_Manager& m, RPE* rpe)
     : kernel(k)
     , mem(m)
@@ -569,6 +605,12 @@ bool preRA_Scheduler::run()
     RegisterPressure rp(kernel, mem, rpe);
     bool Changed = false;
 
+    // Loop aware mode: blocks in innermost loops are always scheduled for
+    // latency, and sends whose results are consumed in other blocks (the next
+    // iteration or past an if/else join) are issued as early as possible.
+    LoopDetection* Loops = config.LoopLatency ? &kernel.fg.getLoops() : nullptr;
+    int64_t LoopCyclesSaved = 0;
+
     for (auto bb : kernel.fg) {
         if (bb->size() < SMALL_BLOCK_SIZE || bb->size() > LARGE_BLOCK_SIZE) {
             SCHED_DUMP(std::cerr << "Skip block with instructions "
@@ -592,18 +634,26 @@ bool preRA_Scheduler::run()
             continue;
         }
 
+        SchedConfig BBConfig = config;
+        if (Loops) {
+            Loop* L = Loops->getInnerMostLoop(bb);
+            bool InInnermostLoop = L && L->immNested.empty();
+            BBConfig.LoopLatency = InInnermostLoop;
+            BBConfig.UseLatency = config.UseLatency || InInnermostLoop;
+        }
+
         unsigned MaxPressure = rp.getPressure(bb);
-        if (MaxPressure <= Threshold && !config.UseLatency) {
+        if (MaxPressure <= Threshold && !BBConfig.UseLatency) {
             SCHED_DUMP(std::cerr << "Skip block with rp " << MaxPressure << "\n");
             continue;
         }
 
         SCHED_DUMP(rp.dump(bb, "Before scheduling, "));
         preDDD ddd(mem, kernel, bb);
-        BB_Scheduler S(kernel, ddd, rp, config, LT);
+        BB_Scheduler S(kernel, ddd, rp, BBConfig, LT);
 
         auto tryRPReduction = [=]() {
-            if (!config.UseSethiUllman)
+            if (!BBConfig.UseSethiUllman)
                  return false;
             return MaxPressure >= Threshold;
         };
@@ -620,7 +670,7 @@ bool preRA_Scheduler::run()
         }
 
         auto tryLatencyHiding = [=]() {
-            if (!config.UseLatency)
+            if (!BBConfig.UseLatency)
                 return false;
 
             if (MaxPressure >= getLatencyHidingThreshold(kernel))
@@ -638,21 +688,37 @@ bool preRA_Scheduler::run()
                 }
             }
 
-            return NumOfHighLatencyInsts >= 2;
+            // A single long latency send may be overlapped with the
+            // remaining iteration in a loop body.
+            return NumOfHighLatencyInsts >= (BBConfig.LoopLatency ? 1U : 2U);
         };
 
         if (tryLatencyHiding()) {
             ddd.reset(Changed);
+            unsigned CyclesBefore = BBConfig.LoopLatency ? estimateCycles(ddd, LT) : 0;
             S.scheduleBlockForLatency();
             if (S.commitIfBeneficial(MaxPressure, /*IsTopDown*/ true)) {
                 SCHED_DUMP(rp.dump(bb, "After scheduling for latency, "));
                 Changed = true;
                 kernel.fg.builder->getcompilerStats().SetFlag("PreRASchedulerForLatency",
                                                               this->kernel.getSimdSize());
+                if (BBConfig.LoopLatency) {
+                    unsigned CyclesAfter = estimateCycles(ddd, LT);
+                    SCHED_DUMP(std::cerr << "Loop block estimated cycles " << CyclesBefore
+                        << " -> " << CyclesAfter << "\n");
+                    LoopCyclesSaved += int64_t(CyclesBefore) - int64_t(CyclesAfter);
+                }
             }
         }
     }
 
+    if (Loops) {
+        SCHED_DUMP(std::cerr << "Estimated cycles saved per loop iteration: "
+            << LoopCyclesSaved << "\n");
+        kernel.fg.builder->getcompilerStats().SetI64("PreRALoopSchedCyclesSaved",
+                                                     LoopCyclesSaved, kernel.getSimdSize());
+    }
+
     return Changed;
 }
 
@@ -1611,6 +1677,17 @@ unsigned LatencyQueue::calculatePriority(preNode* N)
         Priority = std::max(Priority, SuccPriority + Latency);
     }
 
+    // In loop aware mode, a send without local uses feeds the next iteration
+    // or a block past a join. Give it its full latency so that it is issued
+    // early and overlaps with the rest of the block.
+    if (config.LoopLatency && Inst->isSend() && Inst->getDst() &&
+        !Inst->getDst()->isNullReg()) {
+        bool HasLocalUse = std::any_of(N->succ_begin(), N->succ_end(),
+            [](const preEdge& E) { return E.getType() == RAW; });
+        if (!HasLocalUse)
+            Priority = std::max(Priority, unsigned(LT.getLatency(Inst)));
+    }
+
     return std::max(1U, Priority);
 }
 
@@ -32,6 +32,16 @@ uint16_t LatencyTable::getDPAS8x8Latency() const
     }
 }
 
+uint16_t LatencyTable::getScratchLatency() const
+{
+    auto GEN = getPlatformGeneration(m_builder->getPlatform());
+    if (GEN >= PlatformGen::XE)
+        return LatenciesXe::DP_L3;
+
+    // Scratch messages go through the data cache data port.
+    return LegacyFFLatency[SFIDtoInt(SFID::DP_DC0)];
+}
+
 // This calculates the node's pipeline occupancy (node delay)
 uint16_t LatencyTable::getOccupancy(G4_INST* Inst) const
 {
@@ -94,6 +94,8 @@ namespace vISA
         uint16_t getOccupancy(G4_INST* Inst) const;
         uint16_t getLatency(G4_INST* Inst) const;
         uint16_t getDPAS8x8Latency() const;
+        // Latency of a scratch block read, as emitted for spill/fill code.
+        uint16_t getScratchLatency() const;
 
     private:
         uint16_t getLatencyLegacy(G4_INST* Inst) const;
@@ -103,6 +103,7 @@ void LocalScheduler::localScheduling()
     FINALIZER_INFO* jitInfo = fg.builder->getJitInfo();
     jitInfo->BBInfo = bbInfo;
     jitInfo->BBNum = i;
+    jitInfo->stats.staticCycles = totalCycles;
 
     fg.builder->getcompilerStats().SetI64(CompilerStats::numCyclesStr(), totalCycles, fg.getKernel()->getSimdSize());
 }
@@ -919,7 +919,14 @@ void SWSB::SWSBGlobalTokenGenerator(PointsToAnalysis& p, LiveGRFBuckets& LB, Liv
     addGlobalDependence(globalSendNum, &globalSendOpndList, &SBNodes, p, false);
 
     //SWSB token alloation with linear scan algorithm.
-    if (fg.builder->getOptions()->getOption(vISA_GlobalTokenAllocation))
+    CompileTimeBudget& budget = fg.getKernel()->getTimeBudget();
+    if (budget.isExpired(CompileTimeBudget::Phase::SWSB))
+    {
+        // Out of compile-time budget, use the cheapest token allocation.
+        budget.recordFallback(CompileTimeBudget::Phase::SWSB);
+        quickTokenAllocation();
+    }
+    else if (fg.builder->getOptions()->getOption(vISA_GlobalTokenAllocation))
     {
         tokenAllocationGlobal();
     }
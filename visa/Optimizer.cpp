@@ -1195,6 +1195,23 @@ void Optimizer::runPass(PassIndex Index)
     if (PI.Option != vISA_EnableAlways && !builder.getOption(PI.Option))
         return;
 
+    // Optional passes are skipped once their compile-time budget ran out.
+    CompileTimeBudget::Phase BudgetPhase = CompileTimeBudget::Phase::NUM_PHASES;
+    switch (Index)
+    {
+    case PI_localInstCombine: BudgetPhase = CompileTimeBudget::Phase::InstCombine; break;
+    case PI_LVN:              BudgetPhase = CompileTimeBudget::Phase::LVN; break;
+    case PI_preRA_Schedule:   BudgetPhase = CompileTimeBudget::Phase::PreRASchedule; break;
+    case PI_localSchedule:    BudgetPhase = CompileTimeBudget::Phase::LocalSchedule; break;
+    default: break;
+    }
+    if (BudgetPhase != CompileTimeBudget::Phase::NUM_PHASES &&
+        kernel.getTimeBudget().isExpired(BudgetPhase))
+    {
+        kernel.getTimeBudget().recordFallback(BudgetPhase);
+        return;
+    }
+
     std::string Name = PI.Name;
 
     if (PI.Timer != TimerID::NUM_TIMERS)
@@ -1878,9 +1895,28 @@ int Optimizer::optimization()
     //-----------------------------------------------------------------------------------------------------------------
     runPass(PI_addSWSBInfo);
 
+    reportCompileTimeFallbacks();
+
     return VISA_SUCCESS;
 }
 
+void Optimizer::reportCompileTimeFallbacks()
+{
+    const CompileTimeBudget& budget = kernel.getTimeBudget();
+    builder.getJitInfo()->compileTimeFallbacks = budget.getFallbacks();
+
+    for (uint32_t i = 0; i < (uint32_t)CompileTimeBudget::Phase::NUM_PHASES; i++)
+    {
+        auto phase = (CompileTimeBudget::Phase)i;
+        if (budget.hasFallback(phase))
+        {
+            builder.getcompilerStats().SetFlag(
+                std::string("CompileTimeFallback") + CompileTimeBudget::getPhaseName(phase),
+                kernel.getSimdSize());
+        }
+    }
+}
+
 //  When constructing CFG we have the assumption that a label must be the first
 //  instruction in a bb.  During structure analysis, however, we may end up with a bb that
 //  starts with multiple endifs if the bb is the target of multiple gotos that have been
@@ -170,6 +170,9 @@ class Optimizer
 
     void addSWSBInfo();
 
+    // record phases that fell back due to the compile-time budget in jitInfo.
+    void reportCompileTimeFallbacks();
+
     void lowerMadSequence();
 
     void LVN();
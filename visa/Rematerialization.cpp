@@ -10,6 +10,92 @@ SPDX-License-Identifier: MIT
 
 namespace vISA
 {
+    unsigned int RematCostModel::getRematCost(G4_INST* inst) const
+    {
+        return latencyTable.getOccupancy(inst) + latencyTable.getLatency(inst);
+    }
+
+    unsigned int RematCostModel::getFillCost(const G4_Declare* dcl) const
+    {
+        unsigned int numRows = std::max<unsigned int>(1, dcl->getNumRows());
+        unsigned int numMsgs = (numRows + cMaxFillRowsPerMsg - 1) / cMaxFillRowsPerMsg;
+        return numMsgs * latencyTable.getScratchLatency();
+    }
+
+    bool RematCostModel::isCheapRematDef(G4_INST* inst) const
+    {
+        if (inst->isSend() || inst->isMath() || inst->isFlowControl() ||
+            inst->getPredicate() || inst->getCondMod() ||
+            inst->getImplAccDst() || inst->getImplAccSrc() ||
+            inst->isAccDstInst() || inst->isAccSrcInst() ||
+            inst->isRelocationMov() || inst->isPseudoKill() ||
+            inst->isLifeTimeEnd())
+            return false;
+
+        auto dst = inst->getDst();
+        if (!dst || dst->isNullReg() || !dst->getTopDcl() ||
+            dst->getTopDcl()->getRegFile() != G4_GRF)
+            return false;
+
+        for (unsigned int i = 0; i < G4_MAX_SRCS; i++)
+        {
+            auto src = inst->getSrc(i);
+            if (!src || src->isImm() || src->isNullReg())
+                continue;
+
+            if (src->isSrcRegRegion() &&
+                src->asSrcRegRegion()->getTopDcl() == kernel.fg.builder->getBuiltinR0())
+                continue;
+
+            return false;
+        }
+
+        return true;
+    }
+
+    void RematCostModel::computeSpillCostScales(std::unordered_map<const G4_Declare*, float>& scales) const
+    {
+        // Find ranges with a single def
+        std::unordered_map<const G4_Declare*, G4_INST*> uniqueDefs;
+        std::unordered_set<const G4_Declare*> multiDefs;
+        for (auto bb : kernel.fg)
+        {
+            for (auto inst : *bb)
+            {
+                if (inst->isPseudoKill())
+                    continue;
+
+                auto dst = inst->getDst();
+                if (!dst || dst->isNullReg() || !dst->getTopDcl())
+                    continue;
+
+                const G4_Declare* rootDcl = dst->getTopDcl()->getRootDeclare();
+                if (multiDefs.count(rootDcl))
+                    continue;
+
+                if (!uniqueDefs.insert(std::make_pair(rootDcl, inst)).second)
+                {
+                    uniqueDefs.erase(rootDcl);
+                    multiDefs.insert(rootDcl);
+                }
+            }
+        }
+
+        for (auto& def : uniqueDefs)
+        {
+            auto dcl = def.first;
+            if (dcl->isInput() || !isCheapRematDef(def.second))
+                continue;
+
+            float rematCost = (float)getRematCost(def.second);
+            float fillCost = (float)getFillCost(dcl);
+            if (rematCost >= fillCost)
+                continue;
+
+            scales[dcl] = std::max(rematCost / fillCost, cMinSpillCostScale);
+        }
+    }
+
     void Rematerialization::populateRefs()
     {
         unsigned int id = 0;
@@ -586,7 +672,22 @@ namespace vISA
                 minDefUseDist *= 2;
         }
 
-        if ((srcLexId - origOpLexId) < minDefUseDist)
+        bool srcDclSpilled = isRangeSpilled(topdcl);
+
+        // A spilled range pays for a fill at this use regardless of def-use
+        // distance, so when the cost model is enabled it alone decides whether
+        // recomputing is worthwhile. Sends are left to the sampler heuristic
+        // below as their benefit comes from freeing rows, not from latency.
+        bool rematCheaperThanFill = false;
+        if (costModel && srcDclSpilled && !uniqueDefInst->isSend())
+        {
+            rematCheaperThanFill = costModel->isRematCheaperThanFill(uniqueDefInst, topdcl);
+            if (!rematCheaperThanFill)
+                return false;
+        }
+
+        if ((srcLexId - origOpLexId) < minDefUseDist &&
+            !rematCheaperThanFill)
             return false;
 
         if (!inSameSubroutine(bb, uniqueDefBB))
@@ -605,7 +706,6 @@ namespace vISA
 
         // Check whether they are in a loop. If yes, they should be in same loop.
         bool uniqueDefOutsideLoop = false;
-        bool srcDclSpilled = isRangeSpilled(topdcl);
         bool inSameLoop = areInSameLoop(uniqueDefBB, bb, uniqueDefOutsideLoop);
         bool onlyUseInLoop = uniqueDefOutsideLoop && !inSameLoop;
         bool doNumRematCheck = false;
@@ -905,6 +1005,9 @@ namespace vISA
             return false;
         }
 
+        if (rematCheaperThanFill)
+            numCostModelRemats++;
+
         return true;
     }
 
@@ -1276,6 +1379,11 @@ namespace vISA
 
         cleanRedundantSamplerHeaders();
 
+        if (costModel && kernel.getOption(vISA_RATrace))
+        {
+            std::cout << "\t--remat cost model replaced " << numCostModelRemats << " fills\n";
+        }
+
         kernel.dumpToFile("after.remat");
     }
 }
@@ -12,8 +12,10 @@ SPDX-License-Identifier: MIT
 #include "FlowGraph.h"
 #include "GraphColor.h"
 #include "RPE.h"
+#include "LocalScheduler/LatencyTable.h"
 #include <list>
 #include <map>
+#include <memory>
 
 namespace vISA
 {
@@ -52,6 +54,47 @@ namespace vISA
         std::unordered_set<unsigned int> rowsUsed;
     };
 
+    // Cycle based cost model that weighs recomputing a value at its use
+    // against filling it back from scratch. Costs are derived from the
+    // scheduler's LatencyTable so remat decisions stay consistent with
+    // the latencies the rest of the backend assumes.
+    class RematCostModel
+    {
+    private:
+        G4_Kernel& kernel;
+        LatencyTable latencyTable;
+
+        // Scratch block reads return at most this many GRFs per message.
+        static const unsigned int cMaxFillRowsPerMsg = 8;
+
+        // Lower bound on spill cost scaling so that a cheap def that fails
+        // remat legality checks later does not become the first spill choice.
+        static constexpr float cMinSpillCostScale = 0.25f;
+
+    public:
+        RematCostModel(G4_Kernel& k) : kernel(k), latencyTable(k.fg.builder) {}
+
+        // Cycles spent recomputing inst at a use.
+        unsigned int getRematCost(G4_INST* inst) const;
+        // Cycles spent filling dcl from scratch at a use.
+        unsigned int getFillCost(const G4_Declare* dcl) const;
+
+        bool isRematCheaperThanFill(G4_INST* def, const G4_Declare* dcl) const
+        {
+            return getRematCost(def) < getFillCost(dcl);
+        }
+
+        // Return true if inst computes a value only from immediates and r0,
+        // eg constants, address computations and r0 derivatives. Such values
+        // can be recomputed anywhere without extending other live-ranges.
+        bool isCheapRematDef(G4_INST* inst) const;
+
+        // Compute a spill cost scale factor for every live-range that has a
+        // single cheap def. RA uses it to prefer spilling such ranges since
+        // remat later replaces their fills with recomputation.
+        void computeSpillCostScales(std::unordered_map<const G4_Declare*, float>& scales) const;
+    };
+
     class Rematerialization
     {
     private:
@@ -66,6 +109,9 @@ namespace vISA
         unsigned int loopInstsBeforeRemat = 0;
         unsigned int totalInstsBeforeRemat = 0;
         RPE& rpe;
+        std::unique_ptr<RematCostModel> costModel;
+        // Number of fills replaced because cost model found remat cheaper
+        unsigned int numCostModelRemats = 0;
 
         static const unsigned int cRematLoopRegPressure128GRF = 85;
         static const unsigned int cRematRegPressure128GRF = 120;
@@ -200,6 +246,11 @@ namespace vISA
 
             rematCandidates.resize(l.getNumSelectedVar(), false);
 
+            if (k.getOption(vISA_RematCostModel))
+            {
+                costModel = std::make_unique<RematCostModel>(k);
+            }
+
             for (auto&& lr : coloring.getSpilledLiveRanges())
             {
                 auto dcl = lr->getDcl()->getRootDeclare();
@@ -5061,6 +5061,7 @@ void GlobalRA::expandSpillIntrinsic(G4_BB* bb)
                 }
             }
             numGRFSpill++;
+            spillBytes += numRows * numEltPerGRF<Type_UB>();
             instIt = bb->erase(spillIt);
             continue;
         }
@@ -5281,6 +5282,7 @@ void GlobalRA::expandFillIntrinsic(G4_BB* bb)
                 }
             }
             numGRFFill++;
+            fillBytes += numRows * numEltPerGRF<Type_UB>();
             instIt = bb->erase(fillIt);
             continue;
         }
@@ -5306,5 +5308,10 @@ void GlobalRA::expandSpillFillIntrinsics(unsigned int spillSizeInBytes)
     }
     kernel.fg.builder->getcompilerStats().SetI64(CompilerStats::numGRFSpillStr(), numGRFSpill, kernel.getSimdSize());
     kernel.fg.builder->getcompilerStats().SetI64(CompilerStats::numGRFFillStr(), numGRFFill, kernel.getSimdSize());
+    if (auto jitInfo = builder.getJitInfo())
+    {
+        jitInfo->stats.spillBytes = spillBytes;
+        jitInfo->stats.fillBytes = fillBytes;
+    }
 
 }
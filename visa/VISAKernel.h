@@ -881,6 +881,7 @@ private:
     bool isReservedName(const std::string &nm) const;
     void ensureVariableNameUnique(const char *&varName);
     void generateVariableName(Common_ISA_Var_Class Ty, const char *&varName);
+    void recordVariableName(CISA_GEN_VAR *decl, const char *varName);
 
     void dumpDebugFormatFile(std::vector<vISA::DebugInfoFormat>& debugSymbols, std::string filename);
     int InitializeFastPath();
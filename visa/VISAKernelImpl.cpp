@@ -153,6 +153,10 @@ int VISAKernelImpl::compileFastPath()
         return status;
     }
 
+    // The budget covers the compilation itself, not the time the kernel was
+    // being built by the client.
+    m_kernel->getTimeBudget().start(m_options->getuInt32Option(vISA_CompileTimeBudget));
+
     IR_Builder& builder = *m_builder;
     builder.predefinedVarRegAssignment((uint8_t)m_inputSize);
     builder.expandPredefinedVars();
@@ -568,6 +572,7 @@ void VISAKernelImpl::recordFinalizerInfo()
         m_builder->getJitInfo()->numAsmCount = m_kernel->getAsmCount();
         m_builder->getJitInfo()->numGRFTotal = m_kernel->getNumRegTotal();
         m_builder->getJitInfo()->numThreads = m_kernel->getNumThreads();
+        m_kernel->collectStats(m_builder->getJitInfo()->stats);
     }
 }
 
@@ -678,16 +683,17 @@ int VISAKernelImpl::CISABuildPreDefinedDecls()
                 G4_Declare *dcl = m_builder->preDefVars.getPreDefinedVar(predefId);
                 decl->genVar.dcl = dcl;
             }
+            std::string varName(getPredefinedVarString(predefId));
             if (IS_VISA_BOTH_PATH)
             {
-                std::string varName(getPredefinedVarString(predefId));
-                std::string alias = "V" + std::to_string(i);
                 decl->genVar.name_index = addStringPool(varName);
-                if (m_options->getOption(vISA_isParseMode))
-                {
-                    setNameIndexMap(alias, decl, true);
-                    setNameIndexMap(varName, decl, true);
-                }
+            }
+            if (m_options->getOption(vISA_isParseMode) ||
+                m_options->getOption(vISA_NameVarsForInlineAsm))
+            {
+                std::string alias = "V" + std::to_string(i);
+                setNameIndexMap(alias, decl, true);
+                setNameIndexMap(varName, decl, true);
             }
         }
         addVarInfoToList(decl);
@@ -710,6 +716,10 @@ int VISAKernelImpl::CISABuildPreDefinedDecls()
             decl->stateVar.name_index = addStringPool(std::string(name));
             setNameIndexMap(std::string(name), decl, true);
         }
+        else if (m_options->getOption(vISA_NameVarsForInlineAsm))
+        {
+            setNameIndexMap(std::string(vISAPreDefSurf[i].name), decl, true);
+        }
         if (IS_GEN_BOTH_PATH)
         {
             if (i == PREDEFINED_SURFACE_T252)
@@ -752,6 +762,10 @@ void VISAKernelImpl::createBindlessSampler()
         m_bindlessSampler->stateVar.name_index = addStringPool(std::string(name));
         setNameIndexMap(std::string(name), m_bindlessSampler, true);
     }
+    else if (m_options->getOption(vISA_NameVarsForInlineAsm))
+    {
+        setNameIndexMap(std::string(BINDLESS_SAMPLER_NAME), m_bindlessSampler, true);
+    }
     if (IS_GEN_BOTH_PATH)
     {
         m_bindlessSampler->stateVar.dcl = m_builder->getBuiltinBindlessSampler();
@@ -836,7 +850,8 @@ void VISAKernelImpl::ensureVariableNameUnique(const char *&varName)
 
 void VISAKernelImpl::generateVariableName(Common_ISA_Var_Class Ty, const char *&varName)
 {
-    if (!m_options->getOption(vISA_GenerateISAASM) && !IsAsmWriterMode())
+    if (!m_options->getOption(vISA_GenerateISAASM) && !IsAsmWriterMode() &&
+        !m_options->getOption(vISA_NameVarsForInlineAsm))
     {
         // variable name is a don't care if we are not outputting vISA assembly
         return;
@@ -893,6 +908,20 @@ void VISAKernelImpl::generateVariableName(Common_ISA_Var_Class Ty, const char *&
     ensureVariableNameUnique(varName);
 }
 
+void VISAKernelImpl::recordVariableName(CISA_GEN_VAR *decl, const char *varName)
+{
+    m_GenVarToNameMap[decl] = varName;
+
+    // Variables created through the API are only looked up by name when an
+    // inline asm fragment refers to them. In parse mode the caller has
+    // already indexed the name in its declaration scope.
+    if (m_options->getOption(vISA_NameVarsForInlineAsm) &&
+        !m_options->getOption(vISA_isParseMode))
+    {
+        setNameIndexMap(varName, decl);
+    }
+}
+
 std::string VISAKernelImpl::getVarName(VISA_GenVar* decl) const
 {
     return getVarName((CISA_GEN_VAR*)decl);
@@ -946,7 +975,7 @@ int VISAKernelImpl::CreateVISAGenVar(
         return VISA_FAILURE;
     }
 
-    m_GenVarToNameMap[decl] = varName;
+    recordVariableName(decl, varName);
 
     info->bit_properties = (uint8_t)dataType;
     info->bit_properties += varAlign << 4;
@@ -1039,7 +1068,7 @@ int VISAKernelImpl::CreateVISAAddrVar(
     addr_info_t * addr = &decl->addrVar;
     generateVariableName(decl->type, varName);
 
-    m_GenVarToNameMap[decl] = varName;
+    recordVariableName(decl, varName);
 
     decl->index = m_addr_info_count++;
     if (IS_GEN_BOTH_PATH)
@@ -1092,7 +1121,7 @@ int VISAKernelImpl::CreateVISAPredVar(
     }
     generateVariableName(decl->type, varName);
 
-    m_GenVarToNameMap[decl] = varName;
+    recordVariableName(decl, varName);
 
     pred_info_t * pred = &decl->predVar;
 
@@ -1137,7 +1166,7 @@ int VISAKernelImpl::CreateStateVar(
     }
     generateVariableName(decl->type, varName);
 
-    m_GenVarToNameMap[decl] = varName;
+    recordVariableName(decl, varName);
 
     state_info_t * state = &decl->stateVar;
     state->attribute_capacity = 0;
@@ -17,8 +17,10 @@ SPDX-License-Identifier: MIT
 #include "../Frontend/Formatter.hpp"
 #include "../strings.hpp"
 
+#include <algorithm>
 #include <mutex>
 #include <sstream>
+#include <vector>
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -36,9 +38,16 @@ public:
     const Model                       &m_model;
     Kernel                            *m_kernel = nullptr;
     ErrorHandler                       m_errHandler;
-    std::map<uint32_t, const Instruction*> m_instsByPc;
-    std::map<uint32_t, const Block*>   m_blockToPcMap;
+    // Instructions and blocks indexed by PC / PC_ALIGN; PCs that do not
+    // start an instruction (or a block) hold nullptr.
+    std::vector<const Instruction*>    m_instsByPc;
+    std::vector<const Block*>          m_blocksByPc;
     DepAnalysis                       *m_liveAnalysis = nullptr;
+    // guards the lazy computation of m_liveAnalysis
+    std::mutex                         m_liveAnalysisMutex;
+
+    // compacted instructions are 8 bytes, so every PC is a multiple of 8
+    static const int32_t PC_ALIGN = 8;
 
     KernelViewImpl(
         const Model &model,
@@ -52,10 +61,20 @@ public:
         decoder.setSWSBEncodingMode(swsb_enc_mode);
         m_kernel = decoder.decodeKernelBlocks(bytes, bytesLength);
 
+        // a block may start at the end of the kernel (e.g. a trailing label)
+        int32_t maxPc = 0;
+        for (const Block *b : m_kernel->getBlockList()) {
+            maxPc = std::max(maxPc, b->getPC());
+            if (!b->getInstList().empty())
+                maxPc = std::max(maxPc, b->getInstList().back()->getPC());
+        }
+        m_instsByPc.resize(maxPc / PC_ALIGN + 1, nullptr);
+        m_blocksByPc.resize(maxPc / PC_ALIGN + 1, nullptr);
+
         for (const Block *b : m_kernel->getBlockList()) {
-            m_blockToPcMap[b->getPC()] = b;
+            m_blocksByPc[b->getPC() / PC_ALIGN] = b;
             for (const Instruction *inst : b->getInstList()) {
-                m_instsByPc[inst->getPC()] = inst;
+                m_instsByPc[inst->getPC() / PC_ALIGN] = inst;
             }
         }
     }
@@ -70,21 +89,55 @@ public:
     }
 
 
+    static bool isIndexable(int32_t pc, size_t indexSize) {
+        return pc >= 0 && pc % PC_ALIGN == 0 &&
+            (size_t)(pc / PC_ALIGN) < indexSize;
+    }
+
+
     const Instruction *getInstruction(int32_t pc) const {
-        auto itr = m_instsByPc.find(pc);
-        if (itr == m_instsByPc.end()) {
+        if (!isIndexable(pc, m_instsByPc.size())) {
             return nullptr;
         }
-        return itr->second;
+        return m_instsByPc[pc / PC_ALIGN];
     }
 
 
     const Block *getBlock(int32_t pc) const {
-        auto itr = m_blockToPcMap.find(pc);
-        if (itr == m_blockToPcMap.end()) {
+        if (!isIndexable(pc, m_blocksByPc.size())) {
             return nullptr;
         }
-        return itr->second;
+        return m_blocksByPc[pc / PC_ALIGN];
+    }
+
+
+    // Calls 'func' on each instruction with a PC in [pcBegin, pcEnd) in
+    // PC order until it returns false.
+    template <typename F>
+    void forEachInstruction(int32_t pcBegin, int32_t pcEnd, F func) const {
+        size_t end = m_instsByPc.size();
+        if (pcEnd <= 0) {
+            return;
+        } else if ((size_t)((pcEnd - 1) / PC_ALIGN) < end) {
+            end = (size_t)((pcEnd - 1) / PC_ALIGN) + 1;
+        }
+        size_t i = pcBegin <= 0 ? 0 : (size_t)((pcBegin + PC_ALIGN - 1) / PC_ALIGN);
+        for (; i < end; i++) {
+            const Instruction *inst = m_instsByPc[i];
+            if (inst && !func(*inst))
+                return;
+        }
+    }
+
+
+    DepAnalysis *getLiveAnalysis() {
+        const std::lock_guard<std::mutex> g(m_liveAnalysisMutex);
+        if (m_liveAnalysis == nullptr) {
+            m_liveAnalysis = new (std::nothrow) DepAnalysis();
+            if (m_liveAnalysis)
+                *m_liveAnalysis = ComputeDepAnalysis(m_kernel);
+        }
+        return m_liveAnalysis;
     }
 };
 
@@ -268,13 +321,7 @@ size_t kv_get_inst_syntax(
     std::stringstream ss;
     FormatOpts fopts(kvImpl->m_model, labeler, labeler_env);
     if (fopts.printInstDefs) {
-        static std::mutex m;
-        const std::lock_guard<std::mutex> g(m);
-        if (kvImpl->m_liveAnalysis == nullptr) {
-            kvImpl->m_liveAnalysis = new (std::nothrow) DepAnalysis();
-            *kvImpl->m_liveAnalysis = ComputeDepAnalysis(kvImpl->m_kernel);
-        }
-        fopts.liveAnalysis = kvImpl->m_liveAnalysis;
+        fopts.liveAnalysis = kvImpl->getLiveAnalysis();
     }
     fopts.addApiOpts(fmt_opts);
     fopts.setSWSBEncodingMode(kvImpl->m_model.getSWSBEncodeMode());
@@ -1166,3 +1213,166 @@ uint32_t kv_get_is_inverse_predicate(const kv_t *kv, int32_t pc)
     }
     return (uint32_t)inst->getPredication().inverse;
 }
+
+
+/******************** KernelView bulk query APIs *****************************/
+static void fillOperandInfo(
+    const Operand &op, bool isDst, kv_operand_info_t &info)
+{
+    info.kind = static_cast<uint32_t>(op.getKind());
+    info.reg_name = static_cast<uint32_t>(op.getDirRegName());
+    info.reg = info.sub_reg = -1;
+    info.type = static_cast<uint32_t>(op.getType());
+    info.rgn_vt = static_cast<uint32_t>(Region::Vert::VT_INVALID);
+    info.rgn_wi = static_cast<uint32_t>(Region::Width::WI_INVALID);
+    info.rgn_hz = static_cast<uint32_t>(Region::Horz::HZ_INVALID);
+    info.modifier = isDst ?
+        static_cast<uint32_t>(op.getDstModifier()) :
+        static_cast<uint32_t>(SrcModifier::NONE);
+    info.mme = getMathMacroNum(op.getMathMacroExt());
+    info.ind_imm_off = 0;
+    info.imm = 0;
+
+    switch (op.getKind()) {
+    case Operand::Kind::DIRECT:
+        info.reg = op.getDirRegRef().regNum;
+        info.sub_reg = op.getDirRegRef().subRegNum;
+        break;
+    case Operand::Kind::MACRO:
+        info.reg = op.getDirRegRef().regNum;
+        break;
+    case Operand::Kind::INDIRECT:
+        info.reg = op.getIndAddrReg().regNum;
+        info.sub_reg = op.getIndAddrReg().subRegNum;
+        info.ind_imm_off = op.getIndImmAddr();
+        break;
+    case Operand::Kind::IMMEDIATE:
+        info.imm = op.getImmediateValue().u64;
+        return;
+    default:
+        return;
+    }
+
+    if (!isDst)
+        info.modifier = static_cast<uint32_t>(op.getSrcModifier());
+
+    // same restrictions as kv_get_destination_region and kv_get_source_region
+    if (isDst) {
+        info.rgn_hz = static_cast<uint32_t>(op.getRegion().getHz());
+    } else if (op.getKind() != Operand::Kind::MACRO &&
+        (op.getDirRegName() == RegName::GRF_R ||
+            op.getDirRegName() == RegName::ARF_SR ||
+            op.getDirRegName() == RegName::ARF_ACC))
+    {
+        info.rgn_vt = static_cast<uint32_t>(op.getRegion().getVt());
+        info.rgn_wi = static_cast<uint32_t>(op.getRegion().getWi());
+        info.rgn_hz = static_cast<uint32_t>(op.getRegion().getHz());
+    }
+}
+
+static void fillSendInfo(
+    Platform p, const Instruction &inst, kv_inst_info_t &info)
+{
+    info.is_send = 1;
+
+    const SendDesc exDesc = inst.getExtMsgDescriptor();
+    const SendDesc desc = inst.getMsgDescriptor();
+    info.ex_desc = exDesc.isImm() ? exDesc.imm : KV_INVALID_SEND_DESC;
+    info.desc = desc.isImm() ? desc.imm : KV_INVALID_SEND_DESC;
+
+    // <TGL: SFID is ExDesc[3:0]; if it's in a0, we're sunk
+    if (exDesc.isReg() && p < Platform::XE) {
+        info.sfid = -1;
+    } else {
+        info.sfid = static_cast<int32_t>(inst.getSendFc());
+    }
+
+    auto toLen = [](int n) {
+        return n < 0 ? KV_INVALID_LEN : (uint32_t)n;
+    };
+    info.rlen = toLen(inst.getDstLength());
+    info.mlen = toLen(inst.getSrc0Length());
+    info.emlen = toLen(inst.getSrc1Length());
+}
+
+static void fillInstInfo(
+    Platform p, const Instruction &inst, kv_inst_info_t &info)
+{
+    info = kv_inst_info_t();
+    info.pc = inst.getPC();
+    info.size = inst.hasInstOpt(InstOpt::COMPACTED) ? 8 : 16;
+    info.opcode = static_cast<uint32_t>(inst.getOpSpec().op);
+    info.exec_size = static_cast<uint32_t>(inst.getExecSize());
+    info.num_sources = (int32_t)inst.getSourceCount();
+    info.swsb = inst.getSWSB();
+
+    info.is_send = 0;
+    info.ex_desc = info.desc = KV_INVALID_SEND_DESC;
+    info.sfid = -1;
+    info.mlen = info.emlen = info.rlen = KV_INVALID_LEN;
+
+    if (inst.getOp() == Op::ILLEGAL) {
+        info.has_destination = -1;
+        info.predicate = static_cast<uint32_t>(PredCtrl::NONE);
+        info.flag_reg = info.flag_sub_reg = -1;
+        info.flag_modifier = static_cast<uint32_t>(FlagModifier::NONE);
+        info.mask_control = static_cast<uint32_t>(MaskCtrl::NORMAL);
+        info.channel_offset = static_cast<uint32_t>(ChannelOffset::M0);
+        return;
+    }
+
+    info.has_destination = inst.getOpSpec().supportsDestination() ? 1 : 0;
+    if (info.has_destination)
+        fillOperandInfo(inst.getDestination(), true, info.dst);
+    for (uint32_t i = 0;
+        i < inst.getSourceCount() && i < KV_MAX_SOURCES_PER_INSTRUCTION; i++)
+    {
+        fillOperandInfo(inst.getSource((size_t)i), false, info.srcs[i]);
+    }
+
+    info.predicate = static_cast<uint32_t>(inst.getPredication().function);
+    info.is_inverse_predicate = (uint32_t)inst.getPredication().inverse;
+    info.flag_reg = (int32_t)inst.getFlagReg().regNum;
+    info.flag_sub_reg = (int32_t)inst.getFlagReg().subRegNum;
+    info.flag_modifier = static_cast<uint32_t>(inst.getFlagModifier());
+    info.mask_control = static_cast<uint32_t>(inst.getMaskCtrl());
+    info.channel_offset = static_cast<uint32_t>(inst.getChannelOffset());
+
+    if (inst.getOpSpec().isSendOrSendsFamily())
+        fillSendInfo(p, inst, info);
+}
+
+uint32_t kv_get_inst_count(const kv_t *kv, int32_t pc_begin, int32_t pc_end)
+{
+    if (!kv)
+        return 0;
+
+    const KernelViewImpl *kvImpl = (const KernelViewImpl *)kv;
+    uint32_t n = 0;
+    kvImpl->forEachInstruction(pc_begin, pc_end,
+        [&n](const Instruction &) {
+            n++;
+            return true;
+        });
+    return n;
+}
+
+uint32_t kv_get_inst_infos(
+    const kv_t *kv, int32_t pc_begin, int32_t pc_end,
+    kv_inst_info_t *infos, uint32_t infos_cap)
+{
+    if (!kv || !infos)
+        return 0;
+
+    const KernelViewImpl *kvImpl = (const KernelViewImpl *)kv;
+    const Platform p = kvImpl->m_model.platform;
+    uint32_t n = 0;
+    kvImpl->forEachInstruction(pc_begin, pc_end,
+        [&](const Instruction &inst) {
+            if (n == infos_cap)
+                return false;
+            fillInstInfo(p, inst, infos[n++]);
+            return true;
+        });
+    return n;
+}
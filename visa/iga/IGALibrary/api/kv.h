@@ -534,6 +534,101 @@ IGA_API uint32_t kv_get_is_inverse_predicate(const kv_t *kv, int32_t pc);
 
 
 
+/*************************************************************************
+ *                       Bulk query APIs                                 *
+ *************************************************************************/
+
+/*
+ * The maximum number of explicit sources an instruction may have; the size
+ * of kv_inst_info_t::srcs.
+ */
+#define KV_MAX_SOURCES_PER_INSTRUCTION 3
+
+/*
+ * An operand as returned by kv_get_inst_infos.  The fields have the same
+ * values as the corresponding per-PC kv_get_destination_* and
+ * kv_get_source_* functions.
+ */
+typedef struct {
+    uint32_t kind;        /* an Operand::Kind */
+    uint32_t reg_name;    /* a RegName */
+    int32_t  reg;         /* register (or address register) number or -1 */
+    int32_t  sub_reg;     /* subregister number or -1 */
+    uint32_t type;        /* a Type */
+    uint32_t rgn_vt;      /* a Region::Vert (sources only) */
+    uint32_t rgn_wi;      /* a Region::Width (sources only) */
+    uint32_t rgn_hz;      /* a Region::Horz */
+    uint32_t modifier;    /* a SrcModifier or DstModifier */
+    int16_t  mme;         /* math macro register number, -1 if none */
+    int16_t  ind_imm_off; /* indirect immediate offset (indirect only) */
+    uint64_t imm;         /* immediate value (immediate only) */
+} kv_operand_info_t;
+
+/*
+ * An instruction as returned by kv_get_inst_infos.
+ */
+typedef struct {
+    int32_t  pc;
+    int32_t  size;            /* 8 if compacted, 16 otherwise */
+    uint32_t opcode;          /* an Op */
+    uint32_t exec_size;       /* an ExecSize */
+    int32_t  num_sources;
+    int32_t  has_destination;
+    kv_operand_info_t dst;    /* valid if has_destination is 1 */
+    kv_operand_info_t srcs[KV_MAX_SOURCES_PER_INSTRUCTION];
+
+    uint32_t predicate;       /* a PredCtrl */
+    uint32_t is_inverse_predicate;
+    int32_t  flag_reg;
+    int32_t  flag_sub_reg;
+    uint32_t flag_modifier;   /* a FlagModifier */
+    uint32_t mask_control;    /* a MaskCtrl */
+    uint32_t channel_offset;  /* a ChannelOffset */
+
+    /*
+     * Send fields; the remaining ones are only valid if is_send is 1.
+     * Register descriptors are KV_INVALID_SEND_DESC and unknown lengths
+     * are KV_INVALID_LEN (see kv_get_send_descs and kv_get_message_len).
+     */
+    uint32_t is_send;
+    uint32_t ex_desc;
+    uint32_t desc;
+    int32_t  sfid;            /* an SFID or -1 (see kv_get_message_sfid) */
+    uint32_t mlen;
+    uint32_t emlen;
+    uint32_t rlen;
+
+    iga::SWSB swsb;
+} kv_inst_info_t;
+
+/*
+ * Returns the number of instructions whose PC is in [pc_begin, pc_end).
+ * Together with kv_get_inst_infos this allows sizing the caller's buffer.
+ */
+IGA_API uint32_t kv_get_inst_count(
+    const kv_t *kv, int32_t pc_begin, int32_t pc_end);
+
+/*
+ * Fills 'infos' with the instructions whose PC is in [pc_begin, pc_end) in
+ * PC order, stopping after 'infos_cap' entries.  Returns the number of
+ * entries written; the next range can start at the PC following the last
+ * one.  This is equivalent to, but much cheaper than, calling the per-PC
+ * accessors for every instruction of the range.
+ *
+ * E.g. to walk a whole kernel in chunks:
+ *   kv_inst_info_t infos[64];
+ *   int32_t pc = 0;
+ *   uint32_t n;
+ *   while ((n = kv_get_inst_infos(kv, pc, INT32_MAX, infos, 64)) != 0) {
+ *       processInstructions(infos, n);
+ *       pc = infos[n - 1].pc + infos[n - 1].size;
+ *   }
+ */
+IGA_API uint32_t kv_get_inst_infos(
+    const kv_t *kv, int32_t pc_begin, int32_t pc_end,
+    kv_inst_info_t *infos, uint32_t infos_cap);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -544,6 +544,27 @@ public:
         return kv_get_flag_sub_register(m_kv, pc);
     }
 
+    /*************************Bulk query APIs ********************************/
+
+    // Returns the number of instructions with a PC in [pcBegin, pcEnd)
+    // (See kv_get_inst_count)
+    uint32_t getInstCount(int32_t pcBegin, int32_t pcEnd) const {
+        return kv_get_inst_count(m_kv, pcBegin, pcEnd);
+    }
+
+    // Fills 'infos' with up to 'infosCap' instructions with a PC in
+    // [pcBegin, pcEnd) and returns how many were written.
+    // (See kv_get_inst_infos)
+    //
+    //  std::vector<kv_inst_info_t> infos(k.getInstCount(0, INT32_MAX));
+    //  k.getInstInfos(0, INT32_MAX, infos.data(), (uint32_t)infos.size());
+    uint32_t getInstInfos(
+        int32_t pcBegin, int32_t pcEnd,
+        kv_inst_info_t *infos, uint32_t infosCap) const
+    {
+        return kv_get_inst_infos(m_kv, pcBegin, pcEnd, infos, infosCap);
+    }
+
 private:
     // disable value assignment
     KernelView(const KernelView &) { }
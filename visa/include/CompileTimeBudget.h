@@ -0,0 +1,104 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#ifndef _COMPILETIMEBUDGET_H_
+#define _COMPILETIMEBUDGET_H_
+
+#include <chrono>
+#include <cstdint>
+
+namespace vISA
+{
+// Compile-time budget of a kernel, set with -compileTimeBudget <ms>.
+//
+// Expensive phases check their deadline before running and switch to a
+// cheaper algorithm once it has passed. Deadlines are cumulative fractions
+// of the total budget, following the order in which the phases run, so a
+// slow early phase leaves later phases to degrade rather than overshoot.
+// Fallbacks that fired are recorded as a bitmask indexed by Phase and
+// reported back through FINALIZER_INFO. Each G4_Kernel owns one, started
+// when vISA begins compiling the kernel.
+class CompileTimeBudget
+{
+public:
+    enum class Phase : uint32_t
+    {
+        InstCombine = 0,
+        LVN,
+        PreRASchedule,
+        GlobalRA,
+        LocalSchedule,
+        SWSB,
+        NUM_PHASES
+    };
+
+    void start(uint32_t budgetMs)
+    {
+        budget = std::chrono::milliseconds(budgetMs);
+        startTime = std::chrono::steady_clock::now();
+    }
+
+    bool isEnabled() const { return budget.count() > 0; }
+
+    // Return true if phase p should not start its regular algorithm.
+    bool isExpired(Phase p) const
+    {
+        if (!isEnabled())
+            return false;
+
+        auto elapsed = std::chrono::steady_clock::now() - startTime;
+        auto deadline = budget * getDeadlinePercent(p) / 100;
+        return elapsed >= deadline;
+    }
+
+    void recordFallback(Phase p) { fallbacks |= 1u << static_cast<uint32_t>(p); }
+    bool hasFallback(Phase p) const { return (fallbacks & (1u << static_cast<uint32_t>(p))) != 0; }
+    uint32_t getFallbacks() const { return fallbacks; }
+
+    static const char* getPhaseName(Phase p)
+    {
+        static const char* const names[] =
+        {
+            "InstCombine",
+            "LVN",
+            "PreRASchedule",
+            "GlobalRA",
+            "LocalSchedule",
+            "SWSB"
+        };
+        static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(Phase::NUM_PHASES),
+            "missing phase name");
+        return names[static_cast<uint32_t>(p)];
+    }
+
+private:
+    // Percent of the total budget that may elapse before each phase
+    // must fall back to its cheaper algorithm.
+    static unsigned getDeadlinePercent(Phase p)
+    {
+        static const unsigned percents[] =
+        {
+            15, // InstCombine
+            20, // LVN
+            30, // PreRASchedule
+            75, // GlobalRA
+            85, // LocalSchedule
+            95  // SWSB
+        };
+        static_assert(sizeof(percents) / sizeof(percents[0]) == static_cast<size_t>(Phase::NUM_PHASES),
+            "missing phase deadline");
+        return percents[static_cast<uint32_t>(p)];
+    }
+
+    std::chrono::milliseconds budget {0};
+    std::chrono::steady_clock::time_point startTime;
+    uint32_t fallbacks = 0;
+};
+}
+
+#endif // _COMPILETIMEBUDGET_H_
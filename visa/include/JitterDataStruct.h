@@ -18,6 +18,63 @@ typedef struct {
     unsigned char loopNestLevel;
 } VISA_BB_INFO;
 
+// Instruction categories counted in VISA_KERNEL_STATS::numInstsByKind.
+typedef enum {
+    VISA_INST_KIND_ALU,
+    VISA_INST_KIND_LOGIC,
+    VISA_INST_KIND_MOV,
+    VISA_INST_KIND_SEND,
+    VISA_INST_KIND_SEL_CMP,
+    VISA_INST_KIND_STRUCTCF,
+    VISA_INST_KIND_GOTOJOIN,
+    VISA_INST_KIND_THREADCF,
+    VISA_INST_KIND_CALL,
+    VISA_INST_KIND_OTHERS,
+    VISA_INST_KIND_NUM
+} VISA_INST_KIND;
+
+// Pipes counted in VISA_KERNEL_STATS::numInstsByPipe. ALU instructions are
+// only split into the int/float/long pipes on platforms with SWSB; on older
+// platforms they are counted as VISA_PIPE_OTHER.
+typedef enum {
+    VISA_PIPE_INT,
+    VISA_PIPE_FLOAT,
+    VISA_PIPE_LONG,
+    VISA_PIPE_MATH,
+    VISA_PIPE_SEND,
+    VISA_PIPE_DPAS,
+    VISA_PIPE_JEU,
+    VISA_PIPE_OTHER,
+    VISA_PIPE_NUM
+} VISA_PIPE;
+
+#define VISA_NUM_SFIDS 16
+
+// Code quality statistics of the final instruction stream of a kernel, so
+// that clients don't need to parse the .asm dump for them.
+typedef struct {
+    uint32_t numInsts;
+    uint32_t numCompactedInsts;
+    uint32_t numBBs;
+    uint32_t numInstsByKind[VISA_INST_KIND_NUM];
+    uint32_t numInstsByPipe[VISA_PIPE_NUM];
+    // indexed by vISA::SFID
+    uint32_t numSendsBySFID[VISA_NUM_SFIDS];
+
+    // sync.* instructions and the SWSB dependences on the other instructions.
+    uint32_t numSyncInsts;
+    uint32_t numSWSBTokenDeps;
+    uint32_t numSWSBDistDeps;
+
+    // Bytes moved by the GRF spill and fill code, per thread.
+    uint32_t spillBytes;
+    uint32_t fillBytes;
+
+    // Sum of the static cycle estimates of all BBs; zero if the local
+    // scheduler did not run.
+    uint64_t staticCycles;
+} VISA_KERNEL_STATS;
+
 typedef struct {
     // Common part
     bool isSpill;
@@ -68,6 +125,12 @@ typedef struct {
     uint32_t numGRFTotal = 0;
     uint32_t numThreads = 0;
 
+    // Bitmask of CompileTimeBudget::Phase that switched to their cheaper
+    // algorithm because the compile-time budget ran out.
+    uint32_t compileTimeFallbacks = 0;
+
+    VISA_KERNEL_STATS stats;
+
 } FINALIZER_INFO;
 
 #endif // JITTERDATASTRUCT_
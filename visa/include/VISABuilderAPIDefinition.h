@@ -873,6 +873,10 @@ public:
     // For inline asm code generation
     VISA_BUILDER_API virtual int ParseVISAText(const std::string& visaText, const std::string& visaTextFile) = 0;
     VISA_BUILDER_API virtual int ParseVISAText(const std::string& visaFile) = 0;
+    // Appends an inline asm fragment (vISA statements without a listing header)
+    // to kernel. Operands name the kernel's variables, which requires
+    // vISA_NameVarsForInlineAsm to be set before the kernel is added.
+    VISA_BUILDER_API virtual int ParseVISAInlineAsm(VISAKernel* kernel, const std::string& asmText) = 0;
     VISA_BUILDER_API virtual std::stringstream& GetAsmTextStream() = 0;
     VISA_BUILDER_API virtual VISAKernel* GetVISAKernel(const std::string& kernelName = "") = 0;
     VISA_BUILDER_API virtual int ClearAsmTextStreams() = 0;